@@ -27,11 +27,11 @@ class TransmitronConan(ConanFile):
     def requirements(self):
         self.requires("paho-mqtt-cpp/1.4.0")
         self.requires("nlohmann_json/3.11.3")
-        self.requires("tinyxml2/10.0.0")
         self.requires("fmt/11.0.2", force=True)
         self.requires("spdlog/1.14.1")
         self.requires("cli11/2.4.2")
         self.requires("date/3.0.3")
+        self.requires("zlib/1.3.1")
 
     def generate(self):
         cmake = CMakeDeps(self)
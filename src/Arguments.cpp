@@ -36,6 +36,65 @@ Arguments Arguments::handleArgs(int argc, char **argv) {
   );
   recordingFileOpt->option_text(".TMRC");
 
+  args.add_flag(
+    "--view",
+    result.recordingView,
+    "Browse the recording in place instead of loading it"
+  );
+
+  auto *rec = args.add_subcommand(
+    "rec",
+    "Process recordings without opening them"
+  );
+  rec->require_subcommand(1);
+
+  auto addCriteria = [&result](CLI::App *command) {
+    command->add_option("--from", result.tool.from, "Skip messages before")
+      ->option_text("TIME");
+    command->add_option("--to", result.tool.to, "Skip messages after")
+      ->option_text("TIME");
+    command->add_option(
+      "--topic",
+      result.tool.topic,
+      "Keep topics matching this MQTT filter"
+    );
+    command->add_option(
+      "--subscription",
+      result.tool.subscriptions,
+      "Keep messages of this recorded subscription"
+    );
+  };
+
+  auto *slice = rec->add_subcommand("slice", "Cut a time range out");
+  auto *filter = rec->add_subcommand("filter", "Keep matching messages");
+  auto *merge = rec->add_subcommand("merge", "Merge by timestamp");
+  auto *stats = rec->add_subcommand("stats", "Summarize");
+
+  for (auto *command : {slice, filter, merge, stats}) {
+    auto *inputs = command->add_option(
+      "input",
+      result.tool.inputs,
+      "Recordings to read"
+    );
+    inputs->required()->option_text(".TMRC");
+    if (command == slice || command == filter) { inputs->expected(1); }
+    if (command != stats) {
+      command
+        ->add_option("-o,--output", result.tool.output, "Recording to write")
+        ->required()
+        ->option_text(".TMRC");
+      command
+        ->add_option(
+          "--encoding",
+          result.tool.encoding,
+          "Payload encoding of .ndjson and .csv outputs"
+        )
+        ->check(CLI::IsMember({"utf8", "base64", "hex"}))
+        ->option_text("utf8|base64|hex");
+    }
+    addCriteria(command);
+  }
+
   try {
     args.parse(argc, argv);
   } catch (const CLI::ParseError &event) {
@@ -45,5 +104,9 @@ Arguments Arguments::handleArgs(int argc, char **argv) {
 
   result.verbose = !verboseOpt->empty();
 
+  for (auto *command : {slice, filter, merge, stats}) {
+    if (command->parsed()) { result.tool.name = command->get_name(); }
+  }
+
   return result;
 }
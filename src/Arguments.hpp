@@ -2,6 +2,8 @@
 
 #include <string>
 
+#include "Recording/Tools.hpp"
+
 namespace Rapatas::Transmitron {
 
 struct Arguments {
@@ -12,8 +14,12 @@ struct Arguments {
 
   std::string profileName;
   std::string recordingFile;
+  bool recordingView = false;
   bool verbose = false;
 
+  // Set when a recording tool runs instead of the GUI.
+  Recording::Tools::Command tool;
+
   static Arguments handleArgs(int argc, char **argv);
 };
 
@@ -0,0 +1,352 @@
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Payload/Cbor.hpp"
+#include "Payload/MessagePack.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace std::chrono;
+
+namespace {
+
+// Each case is decoded for at least this long, and at least MinRounds
+// times, keeping the fastest round.
+constexpr duration<double> MinTime = milliseconds(500);
+constexpr size_t MinRounds = 3;
+
+constexpr size_t TelemetryMessages = 4096;
+constexpr size_t Numbers = 128 * 1024;
+constexpr size_t Strings = 8192;
+constexpr size_t Blobs = 64;
+constexpr size_t BlobSize = 4096;
+
+enum class Format : uint8_t {
+  MessagePack,
+  Cbor,
+};
+
+// Writes the same documents in either encoding, so that both decoders go
+// through the same corpora.
+class Encoder
+{
+public:
+
+  explicit Encoder(Format format) :
+    mFormat(format) //
+  {}
+
+  std::string take() { return std::move(mOut); }
+
+  void map(size_t count) {
+    if (mFormat == Format::Cbor) {
+      head(Major::Map, count);
+    } else if (count < 16) {
+      byte(0x80 | count);
+    } else if (count <= std::numeric_limits<uint16_t>::max()) {
+      byte(0xde);
+      bigEndian(count, 2);
+    } else {
+      byte(0xdf);
+      bigEndian(count, 4);
+    }
+  }
+
+  void array(size_t count) {
+    if (mFormat == Format::Cbor) {
+      head(Major::Array, count);
+    } else if (count < 16) {
+      byte(0x90 | count);
+    } else if (count <= std::numeric_limits<uint16_t>::max()) {
+      byte(0xdc);
+      bigEndian(count, 2);
+    } else {
+      byte(0xdd);
+      bigEndian(count, 4);
+    }
+  }
+
+  void string(std::string_view text) {
+    const auto size = text.size();
+    if (mFormat == Format::Cbor) {
+      head(Major::Text, size);
+    } else if (size < 32) {
+      byte(0xa0 | size);
+    } else if (size <= std::numeric_limits<uint8_t>::max()) {
+      byte(0xd9);
+      bigEndian(size, 1);
+    } else if (size <= std::numeric_limits<uint16_t>::max()) {
+      byte(0xda);
+      bigEndian(size, 2);
+    } else {
+      byte(0xdb);
+      bigEndian(size, 4);
+    }
+    mOut += text;
+  }
+
+  void binary(std::string_view bytes) {
+    const auto size = bytes.size();
+    if (mFormat == Format::Cbor) {
+      head(Major::Bytes, size);
+    } else if (size <= std::numeric_limits<uint8_t>::max()) {
+      byte(0xc4);
+      bigEndian(size, 1);
+    } else if (size <= std::numeric_limits<uint16_t>::max()) {
+      byte(0xc5);
+      bigEndian(size, 2);
+    } else {
+      byte(0xc6);
+      bigEndian(size, 4);
+    }
+    mOut += bytes;
+  }
+
+  void integer(int64_t value) {
+    if (value < 0) {
+      const auto magnitude = static_cast<uint64_t>(-(value + 1));
+      if (mFormat == Format::Cbor) {
+        head(Major::Negative, magnitude);
+      } else if (value >= -32) {
+        byte(static_cast<uint8_t>(value));
+      } else {
+        byte(0xd3);
+        bigEndian(static_cast<uint64_t>(value), 8);
+      }
+      return;
+    }
+
+    const auto magnitude = static_cast<uint64_t>(value);
+    if (mFormat == Format::Cbor) {
+      head(Major::Unsigned, magnitude);
+    } else if (magnitude < 128) {
+      byte(magnitude);
+    } else {
+      byte(0xcf);
+      bigEndian(magnitude, 8);
+    }
+  }
+
+  void number(double value) {
+    byte(mFormat == Format::Cbor ? 0xfb : 0xcb);
+    uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bigEndian(bits, sizeof(bits));
+  }
+
+  void boolean(bool value) {
+    if (mFormat == Format::Cbor) {
+      byte(value ? 0xf5 : 0xf4);
+    } else {
+      byte(value ? 0xc3 : 0xc2);
+    }
+  }
+
+private:
+
+  enum class Major : uint8_t {
+    Unsigned = 0,
+    Negative = 1,
+    Bytes = 2,
+    Text = 3,
+    Array = 4,
+    Map = 5,
+  };
+
+  Format mFormat;
+  std::string mOut;
+
+  void byte(uint64_t value) { mOut += static_cast<char>(value); }
+
+  void bigEndian(uint64_t value, size_t bytes) {
+    for (size_t i = bytes; i != 0; --i) {
+      byte((value >> ((i - 1) * 8)) & 0xff);
+    }
+  }
+
+  void head(Major major, uint64_t argument) {
+    const auto type = static_cast<uint64_t>(major) << 5;
+    if (argument < 24) {
+      byte(type | argument);
+    } else if (argument <= std::numeric_limits<uint8_t>::max()) {
+      byte(type | 24);
+      bigEndian(argument, 1);
+    } else if (argument <= std::numeric_limits<uint16_t>::max()) {
+      byte(type | 25);
+      bigEndian(argument, 2);
+    } else if (argument <= std::numeric_limits<uint32_t>::max()) {
+      byte(type | 26);
+      bigEndian(argument, 4);
+    } else {
+      byte(type | 27);
+      bigEndian(argument, 8);
+    }
+  }
+};
+
+struct Corpus {
+  std::string name;
+  std::vector<std::string> payloads;
+};
+
+// Many small messages, the way devices usually publish.
+Corpus telemetry(Format format) {
+  Corpus corpus{"telemetry", {}};
+  for (size_t i = 0; i != TelemetryMessages; ++i) {
+    Encoder encoder(format);
+    encoder.map(7);
+    encoder.string("device");
+    encoder.string(fmt::format("sensor-{:04}", i % 100));
+    encoder.string("timestamp");
+    encoder.integer(1700000000000 + static_cast<int64_t>(i) * 250);
+    encoder.string("temperature");
+    encoder.number(20.5 + static_cast<double>(i % 40) / 8);
+    encoder.string("offset");
+    encoder.integer(-static_cast<int64_t>(i % 1000));
+    encoder.string("online");
+    encoder.boolean(i % 3 != 0);
+    encoder.string("tags");
+    encoder.array(2);
+    encoder.string("indoor");
+    encoder.string("floor-2");
+    encoder.string("location");
+    encoder.map(2);
+    encoder.string("lat");
+    encoder.number(52.370216);
+    encoder.string("lon");
+    encoder.number(4.895168);
+    corpus.payloads.push_back(encoder.take());
+  }
+  return corpus;
+}
+
+// One large array of numbers, where printing the values dominates.
+Corpus numbers(Format format) {
+  Encoder encoder(format);
+  encoder.array(Numbers);
+  for (size_t i = 0; i != Numbers; ++i) {
+    if (i % 2 == 0) {
+      encoder.number(std::sin(static_cast<double>(i)) * 1000);
+    } else {
+      encoder.integer(static_cast<int64_t>(i * 7919) - 500000);
+    }
+  }
+  return {"numbers", {encoder.take()}};
+}
+
+// Strings that need escaping and that are not all ASCII.
+Corpus strings(Format format) {
+  Encoder encoder(format);
+  encoder.array(Strings);
+  for (size_t i = 0; i != Strings; ++i) {
+    encoder.string(fmt::format(
+      "line {} of the \"log\"\twith caf\xc3\xa9 and \xe2\x82\xac {}\n",
+      i,
+      i * 31
+    ));
+  }
+  return {"strings", {encoder.take()}};
+}
+
+// Byte strings, which are printed in hex.
+Corpus binary(Format format) {
+  std::string blob(BlobSize, '\0');
+  for (size_t i = 0; i != BlobSize; ++i) {
+    blob[i] = static_cast<char>((i * 131) & 0xff);
+  }
+
+  Encoder encoder(format);
+  encoder.map(Blobs);
+  for (size_t i = 0; i != Blobs; ++i) {
+    encoder.string(fmt::format("blob-{}", i));
+    encoder.binary(blob);
+  }
+  return {"binary", {encoder.take()}};
+}
+
+using Decode = std::function<bool(
+  std::string_view data,
+  std::string &result,
+  std::string &error
+)>;
+
+bool run(std::string_view format, const Corpus &corpus, const Decode &decode) {
+  size_t input = 0;
+  for (const auto &payload : corpus.payloads) { input += payload.size(); }
+
+  std::string result;
+  std::string error;
+  size_t output = 0;
+  size_t rounds = 0;
+  duration<double> total{};
+  auto fastest = duration<double>::max();
+  while (rounds < MinRounds || total < MinTime) {
+    output = 0;
+    const auto start = steady_clock::now();
+    for (const auto &payload : corpus.payloads) {
+      result.clear();
+      if (!decode(payload, result, error)) {
+        fmt::print(
+          stderr,
+          "{} {}: could not decode: {}\n",
+          format,
+          corpus.name,
+          error
+        );
+        return false;
+      }
+      output += result.size();
+    }
+    const duration<double> elapsed = steady_clock::now() - start;
+    fastest = std::min(fastest, elapsed);
+    total += elapsed;
+    ++rounds;
+  }
+
+  constexpr double Megabyte = 1024 * 1024;
+  const auto megabytes = static_cast<double>(input) / Megabyte;
+  fmt::print(
+    "{:<12} {:<10} {:>9.2f} MiB {:>9.2f} MiB/s {:>9.2f} MiB out\n",
+    format,
+    corpus.name,
+    megabytes,
+    megabytes / fastest.count(),
+    static_cast<double>(output) / Megabyte
+  );
+  return true;
+}
+
+} // namespace
+
+int main() {
+  const std::vector<Corpus (*)(Format)> corpora = {
+    telemetry,
+    numbers,
+    strings,
+    binary,
+  };
+
+  const Decode messagePack = [](auto data, auto &result, auto &error) {
+    return Payload::MessagePack::toJson(data, result, error);
+  };
+  const Decode cbor = [](auto data, auto &result, auto &error) {
+    return Payload::Cbor::toJson(data, result, error);
+  };
+
+  bool succeeded = true;
+  for (const auto &corpus : corpora) {
+    succeeded = run("MessagePack", corpus(Format::MessagePack), messagePack)
+      && succeeded;
+    succeeded = run("CBOR", corpus(Format::Cbor), cbor) && succeeded;
+  }
+  return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+}
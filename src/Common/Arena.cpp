@@ -0,0 +1,92 @@
+#include "Arena.hpp"
+
+#include <atomic>
+#include <cstring>
+
+using namespace Rapatas::Transmitron::Common;
+
+namespace {
+
+// Payloads larger than this fraction of a chunk get a chunk of their own, so
+// that a single large message does not waste the tail of the current chunk.
+constexpr size_t DedicatedChunkRatio = 4;
+
+std::atomic<size_t> ChunksAllocated{0};
+std::atomic<size_t> ChunksReleased{0};
+std::atomic<size_t> Stores{0};
+std::atomic<size_t> BytesStored{0};
+
+} // namespace
+
+Arena::Chunk::Chunk(size_t capacity) :
+  // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+  data(new char[capacity]),
+  capacity(capacity) //
+{
+  ChunksAllocated.fetch_add(1, std::memory_order_relaxed);
+}
+
+Arena::Chunk::~Chunk() {
+  ChunksReleased.fetch_add(1, std::memory_order_relaxed);
+}
+
+Arena::Arena(size_t chunkSize) :
+  mChunkSize(chunkSize) //
+{}
+
+std::string_view Arena::store(std::string_view data) {
+  if (data.empty()) { return {}; }
+
+  Chunk *target = mCurrent;
+  if (data.size() > mChunkSize / DedicatedChunkRatio) {
+    target = &allocate(data.size());
+  } else if (
+    target == nullptr || target->capacity - target->used < data.size()
+  ) {
+    target = &allocate(mChunkSize);
+    mCurrent = target;
+  }
+
+  char *destination = target->data.get() + target->used;
+  std::memcpy(destination, data.data(), data.size());
+  target->used += data.size();
+  mUsed += data.size();
+
+  Stores.fetch_add(1, std::memory_order_relaxed);
+  BytesStored.fetch_add(data.size(), std::memory_order_relaxed);
+
+  return {destination, data.size()};
+}
+
+void Arena::clear() {
+  mChunks.clear();
+  mCurrent = nullptr;
+  mReserved = 0;
+  mUsed = 0;
+}
+
+std::shared_ptr<const void> Arena::pin() const {
+  return std::make_shared<const std::vector<std::shared_ptr<Chunk>>>(mChunks);
+}
+
+size_t Arena::chunks() const { return mChunks.size(); }
+
+size_t Arena::reserved() const { return mReserved; }
+
+size_t Arena::used() const { return mUsed; }
+
+Arena::Stats Arena::stats() {
+  return {
+    ChunksAllocated.load(std::memory_order_relaxed),
+    ChunksReleased.load(std::memory_order_relaxed),
+    Stores.load(std::memory_order_relaxed),
+    BytesStored.load(std::memory_order_relaxed),
+  };
+}
+
+Arena::Chunk &Arena::allocate(size_t capacity) {
+  auto chunk = std::make_shared<Chunk>(capacity);
+  mReserved += capacity;
+  mChunks.push_back(chunk);
+  return *chunk;
+}
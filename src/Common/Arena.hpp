@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace Rapatas::Transmitron::Common {
+
+class Arena
+{
+public:
+
+  static constexpr size_t DefaultChunkSize = 4 * 1024 * 1024;
+
+  struct Stats {
+    size_t chunksAllocated = 0;
+    size_t chunksReleased = 0;
+    size_t stores = 0;
+    size_t bytesStored = 0;
+  };
+
+  explicit Arena(size_t chunkSize = DefaultChunkSize);
+
+  Arena(const Arena &other) = delete;
+  Arena(Arena &&other) = default;
+  Arena &operator=(const Arena &other) = delete;
+  Arena &operator=(Arena &&other) = default;
+  ~Arena() = default;
+
+  std::string_view store(std::string_view data);
+  void clear();
+
+  // Keeps the current chunks alive, and every view into them valid, for as
+  // long as the returned handle exists. Later stores never move stored data.
+  [[nodiscard]] std::shared_ptr<const void> pin() const;
+
+  [[nodiscard]] size_t chunks() const;
+  [[nodiscard]] size_t reserved() const;
+  [[nodiscard]] size_t used() const;
+
+  static Stats stats();
+
+private:
+
+  struct Chunk {
+    explicit Chunk(size_t capacity);
+    Chunk(const Chunk &other) = delete;
+    Chunk(Chunk &&other) = delete;
+    Chunk &operator=(const Chunk &other) = delete;
+    Chunk &operator=(Chunk &&other) = delete;
+    ~Chunk();
+
+    // NOLINTNEXTLINE(cppcoreguidelines-avoid-c-arrays)
+    std::unique_ptr<char[]> data;
+    size_t capacity;
+    size_t used = 0;
+  };
+
+  size_t mChunkSize;
+  size_t mReserved = 0;
+  size_t mUsed = 0;
+  std::vector<std::shared_ptr<Chunk>> mChunks;
+  Chunk *mCurrent = nullptr;
+
+  Chunk &allocate(size_t capacity);
+};
+
+} // namespace Rapatas::Transmitron::Common
@@ -1,5 +1,7 @@
 #include "Helpers.hpp"
 
+#include <algorithm>
+#include <array>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
@@ -129,46 +131,126 @@ std::chrono::system_clock::time_point Common::Helpers::stringToTime(
   return timestamp;
 }
 
+std::string Common::Helpers::timeToIsoString(
+  const system_clock::time_point &timestamp
+) {
+  return date::format("%FT%TZ", timestamp);
+}
+
+std::optional<system_clock::time_point> Common::Helpers::isoStringToTime(
+  const std::string &text
+) {
+  system_clock::time_point timestamp;
+  std::stringstream sstream(text);
+  sstream >> date::parse("%FT%TZ", timestamp);
+  if (!sstream.fail()) { return timestamp; }
+
+  // Spreadsheets tend to drop the separator and the zone.
+  std::stringstream fallback(text);
+  fallback >> date::parse("%F %T", timestamp);
+  if (!fallback.fail()) { return timestamp; }
+  return std::nullopt;
+}
+
+std::optional<system_clock::time_point> Common::Helpers::localTimeFromString(
+  const std::string &text,
+  const system_clock::time_point &reference
+) {
+  const std::time_t referencec = system_clock::to_time_t(reference);
+  std::tm tm{};
+#ifndef _WIN32
+  ::localtime_r(&referencec, &tm);
+#else
+  ::localtime_s(&tm, &referencec);
+#endif // _WIN32
+
+  // Accept a full date and time, or only a time of the reference day.
+  std::tm parsed = tm;
+  std::stringstream full(text);
+  full >> std::get_time(&parsed, "%Y-%m-%d %H:%M:%S");
+  if (full.fail()) {
+    parsed = tm;
+    std::stringstream partial(text);
+    partial >> std::get_time(&parsed, "%H:%M:%S");
+    if (partial.fail()) { return std::nullopt; }
+  }
+
+  parsed.tm_isdst = -1;
+  const std::time_t result = std::mktime(&parsed);
+  if (result == -1) { return std::nullopt; }
+  return system_clock::from_time_t(result);
+}
+
 std::string Common::Helpers::hexDump(
-  const std::vector<uint8_t> &bytes,
-  size_t columns
+  std::string_view bytes,
+  size_t columns,
+  size_t offset
 ) {
-  constexpr size_t FixedCharacterCount = 9;
-  const size_t lineWidth = columns * 4 + FixedCharacterCount;
+  if (bytes.empty() || columns == 0) { return {}; }
+
+  constexpr size_t Nibble = 4;
+  constexpr size_t NibbleMask = 0xF;
+  constexpr size_t MinOffsetDigits = 6;
+  constexpr size_t MaxOffsetDigits = sizeof(size_t) * 2;
+  constexpr std::string_view Digits = "0123456789ABCDEF";
+  constexpr size_t ByteValues = 256;
+  constexpr char PrintableBegin = ' ';
+  constexpr char PrintableEnd = '~';
 
-  std::vector<uint8_t> buff(columns);
-  size_t i = 0; // NOLINT
+  // A byte is a single copy of its " XX" cell and of its gutter character.
+  using Cell = std::array<char, 3>;
+  static const auto Cells = [&Digits]() {
+    std::array<Cell, ByteValues> result{};
+    for (size_t i = 0; i != ByteValues; ++i) {
+      result.at(i) = {' ', Digits[i >> Nibble], Digits[i & NibbleMask]};
+    }
+    return result;
+  }();
+  static const auto Gutter = []() {
+    std::array<char, ByteValues> result{};
+    for (size_t i = 0; i != ByteValues; ++i) {
+      const auto c = static_cast<char>(i);
+      result.at(i) = c >= PrintableBegin && c <= PrintableEnd ? c : '.';
+    }
+    return result;
+  }();
+
+  const size_t lines = (bytes.size() + columns - 1) / columns;
+  const size_t fixed = MinOffsetDigits + Cells[0].size() * columns + 2
+    + columns + 1;
   std::string result;
-  std::string line;
-  line.reserve(lineWidth);
-
-  for (i = 0; i < bytes.size(); i++) {
-    if ((i % columns) == 0) {
-      if (i != 0) {
-        line += "  ";
-        for (const auto &byte : buff) { line += static_cast<char>(byte); }
-        result += line + '\n';
-        line.clear();
-        line.reserve(lineWidth);
-      }
-
-      line += fmt::format("{:06X}", i);
+  result.reserve(lines * (fixed + 2));
+
+  for (size_t begin = 0; begin < bytes.size(); begin += columns) {
+    const size_t count = std::min(columns, bytes.size() - begin);
+    const size_t position = offset + begin;
+
+    size_t digits = MinOffsetDigits;
+    while (digits < MaxOffsetDigits && (position >> (digits * Nibble)) != 0) {
+      ++digits;
     }
 
-    line += fmt::format(" {:02X}", bytes[i]);
+    const size_t start = result.size();
+    result.resize(start + fixed + digits - MinOffsetDigits, ' ');
+    char *cursor = &result[start];
 
-    buff[i % columns] = ::isprint(bytes[i]) != 0 ? bytes[i] : '.';
-  }
+    for (size_t digit = digits; digit != 0; --digit) {
+      *cursor++ = Digits[(position >> ((digit - 1) * Nibble)) & NibbleMask];
+    }
 
-  while ((i % columns) != 0) {
-    line += "   ";
-    buff[i % columns] = ' ';
-    i++;
-  }
+    for (size_t i = 0; i != count; ++i) {
+      const auto &cell = Cells[static_cast<uint8_t>(bytes[begin + i])];
+      std::copy(std::begin(cell), std::end(cell), cursor);
+      cursor += cell.size();
+    }
+    // Padding of a short last line is already in place.
+    cursor += Cells[0].size() * (columns - count) + 2;
 
-  line += "  ";
-  for (const auto &byte : buff) { line += static_cast<char>(byte); }
-  result += line + '\n';
+    for (size_t i = 0; i != count; ++i) {
+      *cursor++ = Gutter[static_cast<uint8_t>(bytes[begin + i])];
+    }
+    result.back() = '\n';
+  }
 
   return result;
 }
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <chrono>
+#include <optional>
+#include <string>
+#include <string_view>
 
 #include <wx/colour.h>
 
@@ -20,6 +23,26 @@ std::string durationToString(const std::chrono::milliseconds &dur);
 
 std::chrono::system_clock::time_point stringToTime(const std::string &line);
 
-std::string hexDump(const std::vector<uint8_t> &bytes, size_t columns);
+// ISO 8601 in UTC with the full clock precision, for exchange formats.
+std::string timeToIsoString(
+  const std::chrono::system_clock::time_point &timestamp
+);
+
+std::optional<std::chrono::system_clock::time_point> isoStringToTime(
+  const std::string &text
+);
+
+std::optional<std::chrono::system_clock::time_point> localTimeFromString(
+  const std::string &text,
+  const std::chrono::system_clock::time_point &reference
+);
+
+// Lines of `columns` bytes with their offset, counted from `offset`, and a
+// gutter of the printable characters.
+std::string hexDump(
+  std::string_view bytes,
+  size_t columns,
+  size_t offset = 0
+);
 
 } // namespace Rapatas::Transmitron::Common::Helpers
@@ -0,0 +1,60 @@
+#ifndef _WIN32
+
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace Rapatas::Transmitron::Common;
+
+MappedFile::MappedFile(const std::string &path) {
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg)
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1) {
+    mFailed = true;
+    return;
+  }
+
+  struct stat info {};
+  if (::fstat(fd, &info) == -1) {
+    ::close(fd);
+    mFailed = true;
+    return;
+  }
+
+  mSize = static_cast<size_t>(info.st_size);
+  if (mSize == 0) {
+    ::close(fd);
+    return;
+  }
+
+  void *data = ::mmap(nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (data == MAP_FAILED) { // NOLINT
+    mSize = 0;
+    mFailed = true;
+    return;
+  }
+
+  mData = static_cast<const char *>(data);
+}
+
+MappedFile::~MappedFile() {
+  if (mData == nullptr) { return; }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  ::munmap(const_cast<char *>(mData), mSize);
+}
+
+std::string_view MappedFile::data() const { return {mData, mSize}; }
+
+bool MappedFile::failed() const { return mFailed; }
+
+void MappedFile::adviseRandom() const {
+  if (mData == nullptr) { return; }
+  // NOLINTNEXTLINE(cppcoreguidelines-pro-type-const-cast)
+  ::madvise(const_cast<char *>(mData), mSize, MADV_RANDOM);
+}
+
+#endif // _WIN32
@@ -0,0 +1,64 @@
+#ifdef _WIN32
+
+#include "MappedFile.hpp"
+
+#include <windows.h>
+
+using namespace Rapatas::Transmitron::Common;
+
+MappedFile::MappedFile(const std::string &path) {
+  mFile = CreateFileA(
+    path.c_str(),
+    GENERIC_READ,
+    FILE_SHARE_READ,
+    nullptr,
+    OPEN_EXISTING,
+    FILE_ATTRIBUTE_NORMAL | FILE_FLAG_RANDOM_ACCESS,
+    nullptr
+  );
+  if (mFile == INVALID_HANDLE_VALUE) {
+    mFile = nullptr;
+    mFailed = true;
+    return;
+  }
+
+  LARGE_INTEGER size{};
+  if (GetFileSizeEx(mFile, &size) == 0) {
+    mFailed = true;
+    return;
+  }
+
+  mSize = static_cast<size_t>(size.QuadPart);
+  if (mSize == 0) { return; }
+
+  mMapping = CreateFileMappingA(mFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mMapping == nullptr) {
+    mSize = 0;
+    mFailed = true;
+    return;
+  }
+
+  mData = static_cast<const char *>(
+    MapViewOfFile(mMapping, FILE_MAP_READ, 0, 0, 0)
+  );
+  if (mData == nullptr) {
+    mSize = 0;
+    mFailed = true;
+  }
+}
+
+MappedFile::~MappedFile() {
+  if (mData != nullptr) { UnmapViewOfFile(mData); }
+  if (mMapping != nullptr) { CloseHandle(mMapping); }
+  if (mFile != nullptr) { CloseHandle(mFile); }
+}
+
+std::string_view MappedFile::data() const { return {mData, mSize}; }
+
+bool MappedFile::failed() const { return mFailed; }
+
+void MappedFile::adviseRandom() const {
+  // The file was opened with FILE_FLAG_RANDOM_ACCESS.
+}
+
+#endif // _WIN32
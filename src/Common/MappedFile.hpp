@@ -0,0 +1,42 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace Rapatas::Transmitron::Common {
+
+// Read-only mapping of a whole file. The pages are backed by the file, so
+// the kernel can drop them under memory pressure and the resident size does
+// not grow with the size of the file.
+class MappedFile
+{
+public:
+
+  explicit MappedFile(const std::string &path);
+
+  MappedFile(const MappedFile &other) = delete;
+  MappedFile(MappedFile &&other) = delete;
+  MappedFile &operator=(const MappedFile &other) = delete;
+  MappedFile &operator=(MappedFile &&other) = delete;
+  ~MappedFile();
+
+  [[nodiscard]] std::string_view data() const;
+  [[nodiscard]] bool failed() const;
+
+  // Tells the kernel that pages are read in no particular order, so it does
+  // not read ahead around each access.
+  void adviseRandom() const;
+
+private:
+
+  const char *mData = nullptr;
+  size_t mSize = 0;
+  bool mFailed = false;
+
+#ifdef _WIN32
+  void *mFile = nullptr;
+  void *mMapping = nullptr;
+#endif // _WIN32
+};
+
+} // namespace Rapatas::Transmitron::Common
@@ -0,0 +1,161 @@
+#include "Series.hpp"
+
+#include <algorithm>
+
+using namespace Rapatas::Transmitron;
+using namespace Common;
+
+void Series::append(Timestamp time, double value) {
+  if (!mPoints.empty()) { time = std::max(time, mPoints.back().time); }
+  const Point point{time, value};
+  mPoints.push_back(point);
+
+  // The new point goes into the last run of every level, or starts one.
+  const Extremes single{point, point};
+  size_t index = mPoints.size() - 1;
+  size_t below = mPoints.size();
+  for (size_t level = 0; below > 1; ++level) {
+    index /= Fanout;
+    if (level == mLevels.size()) {
+      build(level);
+    } else {
+      auto &runs = mLevels[level];
+      if (index == runs.size()) {
+        runs.push_back(single);
+      } else {
+        merge(runs.back(), single);
+      }
+    }
+    below = mLevels[level].size();
+  }
+}
+
+void Series::clear() {
+  mPoints.clear();
+  mLevels.clear();
+}
+
+void Series::downsample(
+  Timestamp from,
+  Timestamp to,
+  size_t columns,
+  std::vector<Point> &result
+) const {
+  result.clear();
+  if (mPoints.empty() || columns == 0 || to <= from) { return; }
+
+  const auto first = lowerBound(from);
+  const auto last = lowerBound(to);
+  if (first != 0) { result.push_back(mPoints[first - 1]); }
+
+  if (last - first <= 2 * columns) {
+    result.insert(
+      std::end(result),
+      std::begin(mPoints) + static_cast<ptrdiff_t>(first),
+      std::begin(mPoints) + static_cast<ptrdiff_t>(last)
+    );
+  } else {
+    const auto span = static_cast<double>((to - from).count());
+    size_t begin = first;
+    for (size_t column = 1; column <= columns && begin != last; ++column) {
+      size_t end = last;
+      if (column != columns) {
+        const auto ratio = static_cast<double>(column)
+          / static_cast<double>(columns);
+        const auto offset = static_cast<Timestamp::rep>(span * ratio);
+        end = std::max(begin, lowerBound(from + Timestamp::duration(offset)));
+      }
+
+      Extremes found;
+      if (extremes(begin, end, found)) {
+        const bool minFirst = found.min.time <= found.max.time;
+        const auto &earlier = minFirst ? found.min : found.max;
+        const auto &later = minFirst ? found.max : found.min;
+        result.push_back(earlier);
+        if (later.time != earlier.time || later.value != earlier.value) {
+          result.push_back(later);
+        }
+      }
+      begin = end;
+    }
+  }
+
+  if (last != mPoints.size()) { result.push_back(mPoints[last]); }
+}
+
+size_t Series::size() const { return mPoints.size(); }
+
+bool Series::empty() const { return mPoints.empty(); }
+
+std::pair<Series::Timestamp, Series::Timestamp> Series::getTimeRange() const {
+  if (mPoints.empty()) { return {}; }
+  return {mPoints.front().time, mPoints.back().time};
+}
+
+void Series::build(size_t level) {
+  const auto count = level == 0 ? mPoints.size() : mLevels[level - 1].size();
+  std::vector<Extremes> runs;
+  runs.reserve(count / Fanout + 1);
+  for (size_t i = 0; i != count; ++i) {
+    const auto item = level == 0
+      ? Extremes{mPoints[i], mPoints[i]}
+      : mLevels[level - 1][i];
+    if (i % Fanout == 0) {
+      runs.push_back(item);
+    } else {
+      merge(runs.back(), item);
+    }
+  }
+  mLevels.push_back(std::move(runs));
+}
+
+// Takes the points at the unaligned ends of the range one by one, then moves
+// a level up for the whole runs in between.
+bool Series::extremes(size_t begin, size_t end, Extremes &result) const {
+  if (begin >= end) { return false; }
+
+  bool found = false;
+  const auto take = [&result, &found](const Extremes &item) {
+    if (found) {
+      merge(result, item);
+    } else {
+      result = item;
+      found = true;
+    }
+  };
+
+  while (begin != end && begin % Fanout != 0) {
+    const auto &point = mPoints[begin++];
+    take({point, point});
+  }
+  while (begin != end && end % Fanout != 0) {
+    const auto &point = mPoints[--end];
+    take({point, point});
+  }
+  begin /= Fanout;
+  end /= Fanout;
+
+  for (size_t level = 0; begin != end; ++level) {
+    const auto &runs = mLevels[level];
+    while (begin != end && begin % Fanout != 0) { take(runs[begin++]); }
+    while (begin != end && end % Fanout != 0) { take(runs[--end]); }
+    begin /= Fanout;
+    end /= Fanout;
+  }
+
+  return found;
+}
+
+size_t Series::lowerBound(Timestamp time) const {
+  const auto it = std::partition_point(
+    std::begin(mPoints),
+    std::end(mPoints),
+    [time](const Point &point) { return point.time < time; }
+  );
+  return static_cast<size_t>(it - std::begin(mPoints));
+}
+
+void Series::merge(Extremes &extremes, const Extremes &other) {
+  if (other.min.value < extremes.min.value) { extremes.min = other.min; }
+  if (other.max.value > extremes.max.value) { extremes.max = other.max; }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace Rapatas::Transmitron::Common {
+
+// Values over time, with the minimum and maximum of every run of Fanout^k
+// points kept up to date as points arrive. Any part of the series can be
+// reduced to the extremes of each screen column by looking at a handful of
+// runs per column, however many points it spans.
+class Series
+{
+public:
+
+  using Timestamp = std::chrono::system_clock::time_point;
+
+  struct Point {
+    Timestamp time;
+    double value = 0;
+  };
+
+  // Times before the last point are moved up to it, so that the series
+  // stays sorted.
+  void append(Timestamp time, double value);
+  void clear();
+
+  // The lowest and highest point of each of `columns` equal parts of
+  // [from, to), in time order, so at most two points per column. The points
+  // right outside of the range come along to draw lines up to the edges.
+  void downsample(
+    Timestamp from,
+    Timestamp to,
+    size_t columns,
+    std::vector<Point> &result
+  ) const;
+
+  [[nodiscard]] size_t size() const;
+  [[nodiscard]] bool empty() const;
+  [[nodiscard]] std::pair<Timestamp, Timestamp> getTimeRange() const;
+
+private:
+
+  static constexpr size_t Fanout = 8;
+
+  struct Extremes {
+    Point min;
+    Point max;
+  };
+
+  std::vector<Point> mPoints;
+  // mLevels[k][i] holds the extremes of the points from i * Fanout^(k + 1)
+  // up to the next run, which is partial only for the last one.
+  std::vector<std::vector<Extremes>> mLevels;
+
+  void build(size_t level);
+  [[nodiscard]] bool extremes(size_t begin, size_t end, Extremes &result)
+    const;
+  [[nodiscard]] size_t lowerBound(Timestamp time) const;
+
+  static void merge(Extremes &extremes, const Extremes &other);
+};
+
+} // namespace Rapatas::Transmitron::Common
@@ -0,0 +1,150 @@
+#include "Statistics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+using namespace Rapatas::Transmitron;
+using namespace Common;
+
+constexpr double Accuracy = 0.01;
+constexpr int MaxBins = 1024;
+// Closer to zero than this counts as zero.
+constexpr double Smallest = std::numeric_limits<double>::min();
+
+namespace {
+
+double gamma() { return (1 + Accuracy) / (1 - Accuracy); }
+
+double logGamma() {
+  static const double value = std::log(gamma());
+  return value;
+}
+
+} // namespace
+
+void Statistics::add(double value) {
+  if (!std::isfinite(value)) { return; }
+
+  ++mCount;
+  if (mCount == 1) {
+    mMin = value;
+    mMax = value;
+  } else {
+    mMin = std::min(mMin, value);
+    mMax = std::max(mMax, value);
+  }
+  const auto delta = value - mMean;
+  mMean += delta / static_cast<double>(mCount);
+  mSquares += delta * (value - mMean);
+
+  if (value >= Smallest) {
+    mPositive.add(toIndex(value));
+  } else if (value <= -Smallest) {
+    mNegative.add(toIndex(-value));
+  } else {
+    ++mZeros;
+  }
+}
+
+size_t Statistics::count() const { return mCount; }
+
+double Statistics::min() const { return mMin; }
+
+double Statistics::max() const { return mMax; }
+
+double Statistics::mean() const { return mMean; }
+
+double Statistics::variance() const {
+  if (mCount < 2) { return 0; }
+  return mSquares / static_cast<double>(mCount - 1);
+}
+
+double Statistics::quantile(double q) const {
+  if (mCount == 0) { return 0; }
+
+  const auto rank = std::clamp(q, 0.0, 1.0) * static_cast<double>(mCount - 1);
+  double seen = 0;
+  const auto reached = [&seen, rank](uint64_t count) {
+    seen += static_cast<double>(count);
+    return seen > rank;
+  };
+
+  // From the most negative values up.
+  if (!mNegative.empty()) {
+    for (int i = mNegative.high(); i >= mNegative.low(); --i) {
+      if (reached(mNegative.at(i))) {
+        return std::clamp(-fromIndex(i), mMin, mMax);
+      }
+    }
+  }
+  if (reached(mZeros)) { return 0; }
+  if (!mPositive.empty()) {
+    for (int i = mPositive.low(); i <= mPositive.high(); ++i) {
+      if (reached(mPositive.at(i))) {
+        return std::clamp(fromIndex(i), mMin, mMax);
+      }
+    }
+  }
+  return mMax;
+}
+
+int Statistics::toIndex(double magnitude) {
+  return static_cast<int>(std::ceil(std::log(magnitude) / logGamma()));
+}
+
+// The middle of the bin, within the accuracy of every value in it.
+double Statistics::fromIndex(int index) {
+  return 2 * std::pow(gamma(), index) / (gamma() + 1);
+}
+
+void Statistics::Store::add(int index) {
+  if (mCounts.empty()) {
+    mOffset = index;
+    mCounts.push_back(0);
+  }
+
+  const auto top = high();
+  const auto newHigh = std::max(index, top);
+  const auto newLow = std::max(
+    std::min(index, mOffset),
+    newHigh - MaxBins + 1
+  );
+
+  uint64_t folded = 0;
+  if (newLow > mOffset) {
+    // The bins below the new low go into it.
+    const auto dropped = std::min(
+      static_cast<size_t>(newLow - mOffset),
+      mCounts.size()
+    );
+    const auto end = std::begin(mCounts) + static_cast<ptrdiff_t>(dropped);
+    folded = std::accumulate(std::begin(mCounts), end, uint64_t{0});
+    mCounts.erase(std::begin(mCounts), end);
+  } else if (newLow < mOffset) {
+    mCounts.insert(
+      std::begin(mCounts),
+      static_cast<size_t>(mOffset - newLow),
+      0
+    );
+  }
+  mOffset = newLow;
+  mCounts.resize(static_cast<size_t>(newHigh - newLow + 1), 0);
+  mCounts.front() += folded;
+
+  mCounts[static_cast<size_t>(std::max(index, newLow) - newLow)] += 1;
+}
+
+bool Statistics::Store::empty() const { return mCounts.empty(); }
+
+int Statistics::Store::low() const { return mOffset; }
+
+int Statistics::Store::high() const {
+  return mOffset + static_cast<int>(mCounts.size()) - 1;
+}
+
+uint64_t Statistics::Store::at(int index) const {
+  if (index < low() || index > high()) { return 0; }
+  return mCounts[static_cast<size_t>(index - mOffset)];
+}
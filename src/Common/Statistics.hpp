@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Rapatas::Transmitron::Common {
+
+// Count, extremes, mean and variance of a stream of values, and quantiles
+// within 1% of the actual values from a DDSketch. Memory stays bounded
+// however many values are added.
+class Statistics
+{
+public:
+
+  void add(double value);
+
+  [[nodiscard]] size_t count() const;
+  [[nodiscard]] double min() const;
+  [[nodiscard]] double max() const;
+  [[nodiscard]] double mean() const;
+  [[nodiscard]] double variance() const;
+  // The value that the share `q` of the values are at or below.
+  [[nodiscard]] double quantile(double q) const;
+
+private:
+
+  // Counts of the magnitudes whose logarithm rounds up to the same bin.
+  // Past MaxBins, the lowest bins are folded together.
+  class Store
+  {
+  public:
+
+    void add(int index);
+    [[nodiscard]] bool empty() const;
+    [[nodiscard]] int low() const;
+    [[nodiscard]] int high() const;
+    [[nodiscard]] uint64_t at(int index) const;
+
+  private:
+
+    std::vector<uint64_t> mCounts;
+    int mOffset = 0;
+  };
+
+  size_t mCount = 0;
+  double mMin = 0;
+  double mMax = 0;
+  double mMean = 0;
+  // Sum of the squared differences from the mean, updated as in Welford's
+  // algorithm.
+  double mSquares = 0;
+
+  Store mPositive;
+  Store mNegative;
+  uint64_t mZeros = 0;
+
+  static int toIndex(double magnitude);
+  static double fromIndex(int index);
+};
+
+} // namespace Rapatas::Transmitron::Common
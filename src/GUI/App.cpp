@@ -1,17 +1,17 @@
 #include "App.hpp"
 
-#include <fstream>
+#include <algorithm>
 
 #include <fmt/core.h>
 #include <wx/artprov.h>
 #include <wx/aui/auibook.h>
 #include <wx/image.h>
+#include <wx/msgdlg.h>
 #include <wx/notebook.h>
 #include <wx/settings.h>
 #include <wx/window.h>
 
 #include "Common/Filesystem.hpp"
-#include "Common/Helpers.hpp"
 #include "Common/Info.hpp"
 #include "Common/Log.hpp"
 #include "Common/Url.hpp"
@@ -22,6 +22,9 @@
 #include "GUI/Models/History.hpp"
 #include "GUI/Models/Layouts.hpp"
 #include "GUI/Models/Subscriptions.hpp"
+#include "Recording/Journal.hpp"
+#include "Recording/Reader.hpp"
+#include "Recording/View.hpp"
 #include "Tabs/Client.hpp"
 #include "Tabs/Homepage.hpp"
 #include "Tabs/Settings.hpp"
@@ -35,6 +38,29 @@ constexpr size_t DefaultWindowWidth = 1024;
 constexpr size_t MinWindowWidth = 550;
 constexpr size_t MinWindowHeight = 400;
 constexpr size_t LabelFontSize = 15;
+constexpr int LoadProgressRange = 1000;
+// Sessions that did not close cleanly are kept this many at a time per
+// profile, whether they were restored or not.
+constexpr size_t KeptSessions = 3;
+
+namespace {
+
+// Removes all but the latest KeptSessions journals in directory.
+void pruneRestored(const fs::path &directory) {
+  std::error_code ec;
+  std::vector<std::pair<fs::file_time_type, fs::path>> journals;
+  for (const auto &entry : fs::directory_iterator(directory, ec)) {
+    if (!entry.is_regular_file(ec)) { continue; }
+    journals.emplace_back(fs::last_write_time(entry.path(), ec), entry.path());
+  }
+  if (journals.size() <= KeptSessions) { return; }
+
+  std::sort(std::begin(journals), std::end(journals));
+  journals.resize(journals.size() - KeptSessions);
+  for (const auto &[time, path] : journals) { fs::remove(path, ec); }
+}
+
+} // namespace
 
 App::App(bool verbose) :
   LabelFontInfo(LabelFontSize) //
@@ -95,10 +121,19 @@ bool App::OnInit() {
   mNote->Bind(wxEVT_AUINOTEBOOK_PAGE_CHANGING, &App::onPageSelected, this);
   mNote->Bind(wxEVT_AUINOTEBOOK_PAGE_CLOSE, &App::onPageClosing, this);
 
+  Bind(Events::RECORDING_PROGRESS, &App::onRecordingProgress, this);
+  Bind(Events::RECORDING_LOADED, &App::onRecordingLoaded, this);
+
   mFrame->Show();
   return true;
 }
 
+int App::OnExit() {
+  mLoadCancelled = true;
+  if (mLoadThread.joinable()) { mLoadThread.join(); }
+  return wxApp::OnExit();
+}
+
 int App::FilterEvent(wxEvent &event) {
   if (event.GetEventType() != wxEVT_KEY_DOWN) {
     return wxEventFilter::Event_Skip;
@@ -204,38 +239,6 @@ void App::onKeyDownControlW() {
 
 void App::onKeyDownControlT() { createHomepageTab(mCount - 1); }
 
-void App::onRecordingSave(Events::Recording &event) {
-  const auto name = event.getName();
-  const auto nameUtf8 = name.ToUTF8();
-  const std::string nameStr(nameUtf8.data(), nameUtf8.length());
-  mLogger->info("Storing recording for {}", nameStr);
-  const std::string encoded = Url::encode(nameStr);
-
-  const auto now = std::chrono::system_clock::now();
-  const auto timestamp = Helpers::timeToFilename(now);
-  const auto filename = encoded + "-" + timestamp + ".tmrc";
-
-  wxFileDialog saveFileDialog(
-    mFrame,
-    _("Save TMRC file"),
-    "",
-    filename,
-    "TMRC files (*.tmrc)|*.tmrc",
-    wxFD_SAVE | wxFD_OVERWRITE_PROMPT
-  );
-
-  if (saveFileDialog.ShowModal() == wxID_CANCEL) { return; }
-
-  const auto filepath = saveFileDialog.GetPath().ToStdString();
-  std::ofstream out(filepath);
-  if (!out.is_open()) {
-    mLogger->error("Cannot save current contents in file '{}'.", filepath);
-    return;
-  }
-
-  out << event.getContents();
-}
-
 void App::onProfileCreate(Events::Profile &event) {
   (void)event;
   mNote->ChangeSelection(0);
@@ -247,13 +250,14 @@ void App::onProfileEdit(Events::Profile &event) {
   mSettingsTab->selectProfile(event.getProfile());
 }
 
-void App::onRecordingOpen(Events::Recording & /* event */) {
+void App::onRecordingOpen(Events::Recording &event) {
   wxFileDialog openFileDialog(
     mFrame,
     _("Open tmrc file"),
     "",
     "",
-    "TMRC files (*.tmrc)|*.tmrc",
+    "Recordings (*.tmrc;*.json;*.ndjson;*.jsonl;*.csv)"
+    "|*.tmrc;*.json;*.ndjson;*.jsonl;*.csv",
     wxFD_OPEN | wxFD_FILE_MUST_EXIST
   );
 
@@ -262,7 +266,7 @@ void App::onRecordingOpen(Events::Recording & /* event */) {
   const auto filename = openFileDialog.GetPath();
   const auto utf8 = filename.ToUTF8();
   const std::string encodedStr(utf8.data(), utf8.length());
-  openRecording(encodedStr);
+  openRecording(encodedStr, event.getAsView());
 }
 
 void App::createHomepageTab(size_t index) {
@@ -406,11 +410,13 @@ Common::fs::path App::getInstallPrefix() {
 
 void App::openProfile(wxDataViewItem item) {
   const auto options = mProfilesModel->getBrokerOptions(item);
+  const auto restore = recoverJournal(item);
 
   auto *client = new Tabs::Client(
     mNote,
     options,
     mProfilesModel->getClientOptions(item),
+    mProfilesModel->createJournalPath(item),
     mProfilesModel->getMessagesModel(item),
     mProfilesModel->getTopicsSubscribed(item),
     mProfilesModel->getTopicsPublished(item),
@@ -421,8 +427,6 @@ void App::openProfile(wxDataViewItem item) {
     mOptionsHeight
   );
 
-  client->Bind(Events::RECORDING_SAVE, &App::onRecordingSave, this);
-
   const auto selection = static_cast<size_t>(mNote->GetSelection());
   const auto target = selection == 0 ? mCount - 1 : selection;
 
@@ -443,23 +447,153 @@ void App::openProfile(wxDataViewItem item) {
   mNote->SetPageText(target, utf8);
 
   client->focus();
+
+  if (!restore.empty()) { openRecording(restore, false, true); }
 }
 
-void App::openRecording(const std::string &filename) {
+std::string App::recoverJournal(wxDataViewItem item) {
+  const auto name = mProfilesModel->getName(item);
+  std::string restore;
+  for (const auto &journal : mProfilesModel->getJournalPaths(item)) {
+    // Sessions still open, in another tab or instance, are left alone.
+    if (Recording::Journal::held(journal)) { continue; }
+
+    // A session that ended before any message has nothing to restore.
+    std::error_code ec;
+    const auto size = Common::fs::file_size(journal, ec);
+    if (ec || size <= Recording::Journal::HeaderSize) {
+      Common::fs::remove(journal, ec);
+      continue;
+    }
+
+    const auto path = Common::fs::path(journal);
+    const auto directory = path.parent_path() / "restored";
+    Common::fs::create_directories(directory, ec);
+    const auto restored = directory
+      / fmt::format("{}-{}", Url::encode(name), path.filename().string());
+    Common::fs::rename(journal, restored, ec);
+    if (ec) {
+      mLogger->warn("Could not move journal '{}': {}", journal, ec.message());
+      continue;
+    }
+
+    // Only the latest is offered, the others are kept.
+    if (!restore.empty()) {
+      mLogger->info("Kept an earlier session in '{}'", restore);
+    }
+    restore = restored.string();
+  }
+  if (restore.empty()) { return {}; }
+  pruneRestored(Common::fs::path(restore).parent_path());
+
+  wxMessageDialog dialog(
+    mFrame,
+    wxString::FromUTF8(fmt::format(
+      "The last session of '{}' did not close cleanly.\n"
+      "Restore its history in a new tab?",
+      name
+    )),
+    "Restore session",
+    wxYES_NO | wxICON_QUESTION
+  );
+  if (dialog.ShowModal() != wxID_YES) {
+    mLogger->info("Kept the last session in '{}'", restore);
+    return {};
+  }
+
+  return restore;
+}
+
+void App::openRecording(
+  const std::string &filename,
+  bool asView,
+  bool inNewTab
+) {
+  if (mLoadThread.joinable()) {
+    mLogger->warn("Already opening a recording, ignoring '{}'", filename);
+    return;
+  }
+
   const Common::fs::path path(filename);
   const auto filenameStr = path.stem().string();
-  const std::string decodedStr = Url::decode(filenameStr);
+  mLoadName = Url::decode(filenameStr);
+  mLoadTarget = inNewTab
+    ? nullptr
+    : mNote->GetPage(static_cast<size_t>(mNote->GetSelection()));
+
+  mLoadSubscriptions = new Models::Subscriptions();
+  mLoadHistory = new Models::History(mLoadSubscriptions);
+  mLoadCancelled = false;
+
+  mLoadProgress = new wxProgressDialog(
+    "Opening recording",
+    wxString::FromUTF8(mLoadName),
+    LoadProgressRange,
+    mFrame,
+    wxPD_CAN_ABORT | wxPD_AUTO_HIDE | wxPD_ELAPSED_TIME | wxPD_REMAINING_TIME
+  );
 
-  wxObjectDataPtr<Models::Subscriptions> subscriptions;
-  subscriptions = new Models::Subscriptions();
-  const auto subscriptionsLoaded = subscriptions->load(filename);
+  // The models are only touched by the worker until it reports back.
+  auto *history = mLoadHistory.get();
+  auto *subscriptions = mLoadSubscriptions.get();
+
+  mLoadThread = std::thread([this, filename, asView, history, subscriptions]() {
+    const auto progress = [this](size_t done, size_t total) {
+      auto *event = new Events::Recording(Events::RECORDING_PROGRESS);
+      event->setProgress(done, total);
+      wxQueueEvent(this, event);
+      return !mLoadCancelled.load();
+    };
+
+    bool succeeded = false;
+    if (asView) {
+      auto view = Recording::View::open(filename, progress);
+      if (view != nullptr) {
+        subscriptions->load(view->subscriptions());
+        history->attach(std::move(view));
+        succeeded = true;
+      }
+    } else {
+      const auto reader = Recording::Reader::open(filename);
+      if (reader != nullptr) {
+        subscriptions->load(reader->subscriptions());
+        succeeded = history->load(*reader, progress);
+      }
+    }
+
+    auto *event = new Events::Recording(Events::RECORDING_LOADED);
+    event->setPath(filename);
+    event->setSucceeded(succeeded);
+    wxQueueEvent(this, event);
+  });
+}
+
+void App::onRecordingProgress(Events::Recording &event) {
+  if (mLoadProgress == nullptr || event.getTotal() == 0) { return; }
+
+  const auto value = static_cast<int>(
+    event.getDone() * LoadProgressRange / event.getTotal()
+  );
+  if (!mLoadProgress->Update(std::min(value, LoadProgressRange - 1))) {
+    mLoadCancelled = true;
+  }
+}
+
+void App::onRecordingLoaded(Events::Recording &event) {
+  if (mLoadThread.joinable()) { mLoadThread.join(); }
+
+  if (mLoadProgress != nullptr) {
+    mLoadProgress->Destroy();
+    mLoadProgress = nullptr;
+  }
 
   wxObjectDataPtr<Models::History> history;
-  history = new Models::History(subscriptions);
-  const auto historyLoaded = history->load(filename);
+  wxObjectDataPtr<Models::Subscriptions> subscriptions;
+  std::swap(history, mLoadHistory);
+  std::swap(subscriptions, mLoadSubscriptions);
 
-  if (!subscriptionsLoaded || !historyLoaded) {
-    mLogger->warn("Could not load recording: '{}'", filename);
+  if (!event.getSucceeded() || mLoadCancelled) {
+    mLogger->warn("Could not load recording: '{}'", event.getPath());
     return;
   }
 
@@ -468,17 +602,26 @@ void App::openRecording(const std::string &filename) {
     history,
     subscriptions,
     mLayoutsModel,
-    decodedStr,
+    mLoadName,
     mArtProvider,
     mDarkMode,
     mOptionsHeight
   );
 
-  const auto selection = static_cast<size_t>(mNote->GetSelection());
-  mNote->RemovePage(selection);
-  mNote->InsertPage(selection, client, "");
-  mNote->SetSelection(selection);
-  mNote->SetPageText(selection, decodedStr);
+  // Replace the tab that asked for the recording, unless it was closed in
+  // the meantime.
+  const auto index = mNote->GetPageIndex(mLoadTarget);
+  size_t target = mCount - 1;
+  if (index != wxNOT_FOUND && index != 0) {
+    target = static_cast<size_t>(index);
+    mNote->RemovePage(target);
+  } else {
+    ++mCount;
+  }
+
+  mNote->InsertPage(target, client, "");
+  mNote->SetSelection(target);
+  mNote->SetPageText(target, wxString::FromUTF8(mLoadName));
 
   client->focus();
 }
@@ -1,14 +1,20 @@
 #pragma once
 
+#include <atomic>
+#include <thread>
+
 #include <spdlog/spdlog.h>
 #include <wx/aui/auibook.h>
+#include <wx/progdlg.h>
 #include <wx/wx.h>
 
 #include "GUI/ArtProvider.hpp"
 #include "GUI/Events/Profile.hpp"
 #include "GUI/Events/Recording.hpp"
+#include "GUI/Models/History.hpp"
 #include "GUI/Models/Layouts.hpp"
 #include "GUI/Models/Profiles.hpp"
+#include "GUI/Models/Subscriptions.hpp"
 #include "GUI/Tabs/Settings.hpp"
 
 namespace Rapatas::Transmitron::GUI {
@@ -20,9 +26,14 @@ public:
   explicit App(bool verbose);
 
   bool openProfile(const std::string &profileName);
-  void openRecording(const std::string &filename);
+  void openRecording(
+    const std::string &filename,
+    bool asView = false,
+    bool inNewTab = false
+  );
 
   bool OnInit() override;
+  int OnExit() override;
   int FilterEvent(wxEvent &event) override;
 
 private:
@@ -42,12 +53,22 @@ private:
 
   wxFontInfo LabelFontInfo;
 
+  // Recording being loaded in the background.
+  std::thread mLoadThread;
+  std::atomic<bool> mLoadCancelled = false;
+  wxProgressDialog *mLoadProgress = nullptr;
+  wxWindow *mLoadTarget = nullptr;
+  std::string mLoadName;
+  wxObjectDataPtr<Models::History> mLoadHistory;
+  wxObjectDataPtr<Models::Subscriptions> mLoadSubscriptions;
+
   void onPageClosing(wxBookCtrlEvent &event);
   void onPageSelected(wxBookCtrlEvent &event);
   void onKeyDownControlW();
   void onKeyDownControlT();
-  void onRecordingSave(Events::Recording &event);
   void onRecordingOpen(Events::Recording &event);
+  void onRecordingProgress(Events::Recording &event);
+  void onRecordingLoaded(Events::Recording &event);
   void onProfileCreate(Events::Profile &event);
   void onProfileEdit(Events::Profile &event);
 
@@ -61,6 +82,9 @@ private:
   Common::fs::path getInstallPrefix();
 
   void openProfile(wxDataViewItem item);
+  // Moves the journals of sessions that did not close cleanly aside and
+  // returns the new path of the latest if the user wants it restored.
+  std::string recoverJournal(wxDataViewItem item);
 
   void calculateOptions();
 };
@@ -5,4 +5,5 @@ using namespace Rapatas::Transmitron::GUI;
 // NOLINTBEGIN(cert-err58-cpp)
 wxDEFINE_EVENT(Events::EDIT_PUBLISH, Events::Edit);
 wxDEFINE_EVENT(Events::EDIT_SAVE_MESSAGE, Events::Edit);
+wxDEFINE_EVENT(Events::EDIT_FORMATTED, Events::Edit);
 // NOLINTEND(cert-err58-cpp)
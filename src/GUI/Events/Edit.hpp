@@ -1,5 +1,8 @@
 #pragma once
 
+#include <string>
+#include <utility>
+
 #include <wx/event.h>
 
 namespace Rapatas::Transmitron::GUI::Events {
@@ -7,6 +10,7 @@ namespace Rapatas::Transmitron::GUI::Events {
 class Edit;
 wxDECLARE_EVENT(EDIT_PUBLISH, Edit);
 wxDECLARE_EVENT(EDIT_SAVE_MESSAGE, Edit);
+wxDECLARE_EVENT(EDIT_FORMATTED, Edit);
 
 // NOLINTNEXTLINE
 class Edit : public wxCommandEvent
@@ -20,6 +24,19 @@ public:
   Edit(const Edit &event) = default;
 
   [[nodiscard]] wxEvent *Clone() const override { return new Edit(*this); }
+
+  [[nodiscard]] size_t getGeneration() const { return mGeneration; }
+
+  void setGeneration(size_t generation) { mGeneration = generation; }
+
+  [[nodiscard]] const std::string &getPayload() const { return mPayload; }
+
+  void setPayload(std::string payload) { mPayload = std::move(payload); }
+
+private:
+
+  size_t mGeneration = 0;
+  std::string mPayload;
 };
 
 } // namespace Rapatas::Transmitron::GUI::Events
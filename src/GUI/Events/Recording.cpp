@@ -3,6 +3,10 @@
 using namespace Rapatas::Transmitron::GUI;
 
 // NOLINTBEGIN(cert-err58-cpp)
-wxDEFINE_EVENT(Events::RECORDING_SAVE, Events::Recording);
 wxDEFINE_EVENT(Events::RECORDING_OPEN, Events::Recording);
+wxDEFINE_EVENT(Events::RECORDING_PROGRESS, Events::Recording);
+wxDEFINE_EVENT(Events::RECORDING_STORED, Events::Recording);
+wxDEFINE_EVENT(Events::RECORDING_LOADED, Events::Recording);
+wxDEFINE_EVENT(Events::RECORDING_REPLAYING, Events::Recording);
+wxDEFINE_EVENT(Events::RECORDING_REPLAYED, Events::Recording);
 // NOLINTEND(cert-err58-cpp)
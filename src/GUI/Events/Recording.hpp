@@ -6,8 +6,12 @@
 namespace Rapatas::Transmitron::GUI::Events {
 
 class Recording;
-wxDECLARE_EVENT(RECORDING_SAVE, Recording);
 wxDECLARE_EVENT(RECORDING_OPEN, Recording);
+wxDECLARE_EVENT(RECORDING_PROGRESS, Recording);
+wxDECLARE_EVENT(RECORDING_STORED, Recording);
+wxDECLARE_EVENT(RECORDING_LOADED, Recording);
+wxDECLARE_EVENT(RECORDING_REPLAYING, Recording);
+wxDECLARE_EVENT(RECORDING_REPLAYED, Recording);
 
 // NOLINTNEXTLINE
 class Recording : public wxCommandEvent
@@ -18,26 +22,38 @@ public:
     wxCommandEvent(commandType, id) //
   {}
 
-  Recording(const Recording &event) :
-    wxCommandEvent(event) {
-    this->setContents(event.getContents());
-    this->setName(event.getName());
-  }
+  Recording(const Recording &event) = default;
 
   [[nodiscard]] wxEvent *Clone() const override { return new Recording(*this); }
 
-  [[nodiscard]] std::string getContents() const { return mContents; }
+  [[nodiscard]] std::string getPath() const { return mPath; }
+
+  void setPath(const std::string &path) { mPath = path; }
+
+  [[nodiscard]] size_t getDone() const { return mDone; }
+
+  [[nodiscard]] size_t getTotal() const { return mTotal; }
+
+  void setProgress(size_t done, size_t total) {
+    mDone = done;
+    mTotal = total;
+  }
+
+  [[nodiscard]] bool getSucceeded() const { return mSucceeded; }
 
-  void setContents(const std::string &contents) { mContents = contents; }
+  void setSucceeded(bool succeeded) { mSucceeded = succeeded; }
 
-  [[nodiscard]] wxString getName() const { return mName; }
+  [[nodiscard]] bool getAsView() const { return mAsView; }
 
-  void setName(const wxString &name) { mName = name; }
+  void setAsView(bool asView) { mAsView = asView; }
 
 private:
 
-  std::string mContents;
-  wxString mName;
+  std::string mPath;
+  size_t mDone = 0;
+  size_t mTotal = 0;
+  bool mSucceeded = false;
+  bool mAsView = false;
 };
 
 } // namespace Rapatas::Transmitron::GUI::Events
@@ -0,0 +1,7 @@
+#include "GUI/Events/Timeline.hpp"
+
+using namespace Rapatas::Transmitron::GUI;
+
+// NOLINTBEGIN(cert-err58-cpp)
+wxDEFINE_EVENT(Events::TIMELINE_SELECTED, Events::Timeline);
+// NOLINTEND(cert-err58-cpp)
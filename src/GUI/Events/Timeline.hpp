@@ -0,0 +1,36 @@
+#pragma once
+
+#include <chrono>
+
+#include <wx/event.h>
+
+namespace Rapatas::Transmitron::GUI::Events {
+
+class Timeline;
+wxDECLARE_EVENT(TIMELINE_SELECTED, Timeline);
+
+// NOLINTNEXTLINE
+class Timeline : public wxCommandEvent
+{
+public:
+
+  using Timestamp = std::chrono::system_clock::time_point;
+
+  explicit Timeline(wxEventType commandType, int id = 0) :
+    wxCommandEvent(commandType, id) //
+  {}
+
+  Timeline(const Timeline &event) = default;
+
+  [[nodiscard]] wxEvent *Clone() const override { return new Timeline(*this); }
+
+  [[nodiscard]] Timestamp getTimestamp() const { return mTimestamp; }
+
+  void setTimestamp(Timestamp timestamp) { mTimestamp = timestamp; }
+
+private:
+
+  Timestamp mTimestamp;
+};
+
+} // namespace Rapatas::Transmitron::GUI::Events
@@ -0,0 +1,251 @@
+#include "Aggregates.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <fmt/format.h>
+
+#include "Common/Log.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace GUI::Models;
+
+// Messages of the history taken in per tick, before the paths were set.
+constexpr size_t BackfillBatch = 65536;
+constexpr size_t None = std::numeric_limits<size_t>::max();
+constexpr int RefreshIntervalMs = 500;
+
+Aggregates::Aggregates(const wxObjectDataPtr<History> &history) :
+  mHistory(history),
+  mObserverId(history->attachObserver(this)),
+  mTimer(this) //
+{
+  mLogger = Common::Log::create("Models::Aggregates");
+  Bind(wxEVT_TIMER, &Aggregates::onTimer, this);
+  mTimer.Start(RefreshIntervalMs);
+}
+
+Aggregates::~Aggregates() { mHistory->detachObserver(mObserverId); }
+
+void Aggregates::setPaths(std::vector<Payload::JsonPath> paths) {
+  mPaths = std::move(paths);
+  clear();
+  mBackfillEnd = mPaths.empty() ? 0 : mHistory->getTotal();
+  mGeneration = mHistory->getGeneration();
+}
+
+void Aggregates::clear() {
+  mTopics.clear();
+  mByTopic.clear();
+  mAggregates.clear();
+  mDirty.clear();
+  mChanged = false;
+  mRows.clear();
+  mBackfilled = 0;
+  mBackfillEnd = 0;
+  Reset(0);
+}
+
+void Aggregates::sortBy(Column column) {
+  if (column == Column::Max) { return; }
+  mSortDescending = column == mSortColumn && !mSortDescending;
+  mSortColumn = column;
+  sort();
+  Reset(static_cast<unsigned>(mRows.size()));
+}
+
+void Aggregates::onMessage(wxDataViewItem /* item */) {}
+
+void Aggregates::onAppended(const Recording::Record &record) {
+  take(record.topic, record.payload);
+}
+
+void Aggregates::onTimer(wxTimerEvent & /* event */) {
+  backfill();
+  update();
+}
+
+void Aggregates::backfill() {
+  if (mBackfilled == mBackfillEnd) { return; }
+
+  if (mHistory->getGeneration() != mGeneration) {
+    // Messages were removed from the history, so the indices moved. The rest
+    // is left out rather than taking some messages in twice.
+    mLogger->warn(
+      "History changed after {} of {} messages",
+      mBackfilled,
+      mBackfillEnd
+    );
+    mBackfillEnd = mBackfilled;
+    return;
+  }
+
+  const auto end = std::min(mBackfillEnd, mBackfilled + BackfillBatch);
+  mHistory->visitRecords(
+    mBackfilled,
+    end,
+    [this](size_t /* index */, const Recording::Record &record) {
+      take(record.topic, record.payload);
+    }
+  );
+  mBackfilled = end;
+}
+
+void Aggregates::take(std::string_view topic, std::string_view payload) {
+  if (mPaths.empty()) { return; }
+
+  auto it = mByTopic.find(topic);
+  if (it == std::end(mByTopic)) {
+    mTopics.emplace_back(topic);
+    it = mByTopic
+           .emplace(mTopics.back(), std::vector<size_t>(mPaths.size(), None))
+           .first;
+  }
+
+  for (size_t path = 0; path != mPaths.size(); ++path) {
+    double value = 0;
+    if (!mPaths[path].number(payload, value)) { continue; }
+
+    auto &index = it->second[path];
+    if (index == None) {
+      index = mAggregates.size();
+      mAggregates.push_back({it->first, path, {}});
+      mDirty.push_back(false);
+    }
+    mAggregates[index].statistics.add(value);
+    mDirty[index] = true;
+    mChanged = true;
+  }
+}
+
+void Aggregates::update() {
+  if (!mChanged) { return; }
+  mChanged = false;
+
+  const auto before = mRows.size();
+  for (size_t i = before; i != mAggregates.size(); ++i) { mRows.push_back(i); }
+  const auto after = mRows.size();
+
+  // Sorted rows may all have moved, otherwise rows are aggregates. New
+  // aggregates are dirty too.
+  const bool sorted = mSortColumn != Column::Max;
+  if (sorted) { sort(); }
+  const auto dirty = std::count(std::begin(mDirty), std::end(mDirty), true);
+  const auto changed = sorted ? after : static_cast<size_t>(dirty);
+
+  if (changed > ResetThreshold) {
+    Reset(static_cast<unsigned>(after));
+  } else {
+    for (size_t row = 0; row != before; ++row) {
+      if (sorted || mDirty[row]) { RowChanged(static_cast<unsigned>(row)); }
+    }
+    for (size_t row = before; row != after; ++row) { RowAppended(); }
+  }
+
+  std::fill(std::begin(mDirty), std::end(mDirty), false);
+}
+
+void Aggregates::sort() {
+  if (mSortColumn == Column::Topic || mSortColumn == Column::Path) {
+    const auto byTopic = mSortColumn == Column::Topic;
+    const auto key = [this, byTopic](size_t index) {
+      const auto &aggregate = mAggregates[index];
+      const std::string_view path = mPaths[aggregate.path].expression();
+      return byTopic ? std::make_pair(aggregate.topic, path)
+                     : std::make_pair(path, aggregate.topic);
+    };
+    std::stable_sort(
+      std::begin(mRows),
+      std::end(mRows),
+      [&key, this](size_t lhs, size_t rhs) {
+        return mSortDescending ? key(rhs) < key(lhs) : key(lhs) < key(rhs);
+      }
+    );
+    return;
+  }
+
+  // Quantiles take a pass over the sketch, so they are worked out once.
+  std::vector<double> keys(mAggregates.size());
+  for (size_t i = 0; i != mAggregates.size(); ++i) {
+    keys[i] = value(mAggregates[i], mSortColumn);
+  }
+  std::stable_sort(
+    std::begin(mRows),
+    std::end(mRows),
+    [&keys, this](size_t lhs, size_t rhs) {
+      return mSortDescending ? keys[rhs] < keys[lhs] : keys[lhs] < keys[rhs];
+    }
+  );
+}
+
+double Aggregates::value(const Aggregate &aggregate, Column column) const {
+  const auto &statistics = aggregate.statistics;
+  constexpr double Median = 0.5;
+  constexpr double P90 = 0.9;
+  constexpr double P99 = 0.99;
+  switch (column) {
+    case Column::Count: return static_cast<double>(statistics.count());
+    case Column::Minimum: return statistics.min();
+    case Column::Maximum: return statistics.max();
+    case Column::Mean: return statistics.mean();
+    case Column::Deviation: return std::sqrt(statistics.variance());
+    case Column::Median: return statistics.quantile(Median);
+    case Column::P90: return statistics.quantile(P90);
+    case Column::P99: return statistics.quantile(P99);
+    default: return 0;
+  }
+}
+
+unsigned Aggregates::GetColumnCount() const {
+  return static_cast<unsigned>(Column::Max);
+}
+
+wxString Aggregates::GetColumnType(unsigned int /* col */) const {
+  return wxDataViewTextRenderer::GetDefaultType();
+}
+
+unsigned Aggregates::GetCount() const {
+  return static_cast<unsigned>(mRows.size());
+}
+
+void Aggregates::GetValueByRow(
+  wxVariant &variant,
+  unsigned int row,
+  unsigned int col
+) const {
+  const auto &aggregate = mAggregates.at(mRows.at(row));
+  const auto column = static_cast<Column>(col);
+  switch (column) {
+    case Column::Topic: {
+      const auto &topic = aggregate.topic;
+      variant = wxString::FromUTF8(topic.data(), topic.length());
+    } break;
+    case Column::Path: {
+      const auto &expression = mPaths.at(aggregate.path).expression();
+      variant = wxString::FromUTF8(expression.data(), expression.length());
+    } break;
+    case Column::Count: {
+      variant = fmt::format("{}", aggregate.statistics.count());
+    } break;
+    default: {
+      variant = fmt::format("{:.6g}", value(aggregate, column));
+    }
+  }
+}
+
+bool Aggregates::GetAttrByRow(
+  unsigned int /* row */,
+  unsigned int /* col */,
+  wxDataViewItemAttr & /* attr */
+) const {
+  return false;
+}
+
+bool Aggregates::SetValueByRow(
+  const wxVariant & /* variant */,
+  unsigned int /* row */,
+  unsigned int /* col */
+) {
+  return false;
+}
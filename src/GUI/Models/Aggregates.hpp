@@ -0,0 +1,123 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/logger.h>
+#include <wx/dataview.h>
+#include <wx/timer.h>
+
+#include "Common/Statistics.hpp"
+#include "GUI/Models/History.hpp"
+#include "Payload/JsonPath.hpp"
+#include "Recording/Record.hpp"
+
+namespace Rapatas::Transmitron::GUI::Models {
+
+// Running statistics of the numbers at a set of JSON paths, one row per topic
+// and path. Messages are taken in as they are appended to the history, so the
+// rows outlive the messages when the history is cleared.
+class Aggregates :
+  public wxEvtHandler,
+  public wxDataViewVirtualListModel,
+  public History::Observer
+{
+public:
+
+  enum class Column : uint8_t {
+    Topic,
+    Path,
+    Count,
+    Minimum,
+    Maximum,
+    Mean,
+    Deviation,
+    Median,
+    P90,
+    P99,
+    Max
+  };
+
+  explicit Aggregates(const wxObjectDataPtr<History> &history);
+  ~Aggregates() override;
+  Aggregates(const Aggregates &) = delete;
+  Aggregates(Aggregates &&) = delete;
+  Aggregates &operator=(const Aggregates &) = delete;
+  Aggregates &operator=(Aggregates &&) = delete;
+
+  // Starts over with these paths, taking in the messages that are already in
+  // the history a batch at a time.
+  void setPaths(std::vector<Payload::JsonPath> paths);
+  // Forgets what was taken in so far, the paths stay.
+  void clear();
+  // Sorting by the same column again reverses the order.
+  void sortBy(Column column);
+
+  // History::Observer interface.
+  void onMessage(wxDataViewItem item) override;
+  void onAppended(const Recording::Record &record) override;
+
+  // wxDataViewVirtualListModel interface.
+  [[nodiscard]] unsigned GetColumnCount() const override;
+  [[nodiscard]] wxString GetColumnType(unsigned int col) const override;
+  [[nodiscard]] unsigned GetCount() const override;
+  void GetValueByRow(
+    wxVariant &variant,
+    unsigned int row,
+    unsigned int col //
+  ) const override;
+  bool GetAttrByRow(
+    unsigned int row,
+    unsigned int col,
+    wxDataViewItemAttr &attr
+  ) const override;
+  bool SetValueByRow(
+    const wxVariant &variant,
+    unsigned int row,
+    unsigned int col
+  ) override;
+
+private:
+
+  struct Aggregate {
+    std::string_view topic;
+    size_t path = 0;
+    Common::Statistics statistics;
+  };
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  wxObjectDataPtr<History> mHistory;
+  size_t mObserverId;
+  wxTimer mTimer;
+
+  std::vector<Payload::JsonPath> mPaths;
+  std::deque<std::string> mTopics;
+  // Per topic, the aggregate of each path, or None until a number is found.
+  std::unordered_map<std::string_view, std::vector<size_t>> mByTopic;
+  std::vector<Aggregate> mAggregates;
+  std::vector<bool> mDirty;
+  bool mChanged = false;
+
+  // The aggregates in the order they are shown.
+  std::vector<size_t> mRows;
+  Column mSortColumn = Column::Max;
+  bool mSortDescending = false;
+
+  // Messages of the history from before the paths were set, still to be
+  // taken in, as indexed in its mGeneration.
+  size_t mBackfilled = 0;
+  size_t mBackfillEnd = 0;
+  size_t mGeneration = 0;
+
+  void onTimer(wxTimerEvent &event);
+  void backfill();
+  void take(std::string_view topic, std::string_view payload);
+  void update();
+  void sort();
+  [[nodiscard]] double value(const Aggregate &aggregate, Column column) const;
+};
+
+} // namespace Rapatas::Transmitron::GUI::Models
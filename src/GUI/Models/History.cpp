@@ -1,7 +1,10 @@
 #include "History.hpp"
 
+#include <algorithm>
 #include <fstream>
 #include <future>
+#include <limits>
+#include <unordered_set>
 
 #include <fmt/chrono.h>
 #include <wx/dcmemory.h>
@@ -15,19 +18,53 @@
 #include "GUI/Resources/qos/qos-1.hpp"
 #include "GUI/Resources/qos/qos-2.hpp"
 #include "MQTT/Message.hpp"
+#include "Recording/Reader.hpp"
 
 using namespace Rapatas::Transmitron;
 using namespace GUI::Models;
 using namespace GUI;
 using namespace Common;
 
+// Rebuild the arena once less than half of its bytes are still referenced.
+constexpr size_t CompactRatio = 2;
+constexpr size_t LoadProgressInterval = 4096;
+// Path column values are dropped once this many messages have them, more
+// than any control shows at once.
+constexpr size_t ExtractedLimit = 4096;
+constexpr size_t PathValueLength = 256;
+// Messages of a view scanned by the remap worker between progress reports
+// and checks for cancellation.
+constexpr size_t RemapBatch = 256 * 1024;
+
+namespace {
+
+std::string quoteMarkup(std::string_view text) {
+  std::string result;
+  result.reserve(text.size());
+  for (const char c : text) {
+    switch (c) {
+      case '&': result += "&amp;"; break;
+      case '<': result += "&lt;"; break;
+      case '>': result += "&gt;"; break;
+      case '\n': result += ' '; break;
+      default: result += c;
+    }
+  }
+  return result;
+}
+
+} // namespace
+
 History::History(const wxObjectDataPtr<Subscriptions> &subscriptions) :
   mSubscriptions(subscriptions) //
 {
   mLogger = Common::Log::create("Models::History");
   mSubscriptions->attachObserver(this);
+  Bind(Events::RECORDING_LOADED, &History::onRemapped, this);
 }
 
+History::~History() { stopRemap(); }
+
 size_t History::attachObserver(Observer *observer) {
   static size_t id = 0;
   return mObservers.insert(std::make_pair(id++, observer)).first->first;
@@ -42,111 +79,102 @@ bool History::detachObserver(size_t id) {
 }
 
 void History::clear() {
+  stopRemap();
+
+  // Counted while a view may still be attached, whose rows are not in
+  // mRemap.
+  const size_t before = GetCount();
+  const auto messages = mMessages.size();
+  const auto chunks = mArena.chunks();
+  const auto reserved = mArena.reserved();
+
   mMessages.clear();
-  remap();
+  ++mGeneration;
+  mTimeline.clear();
+  mTopics.clear();
+  mTopicIds.clear();
+  mArena.clear();
+  mView.reset();
+  mPlayhead = Timestamp::max();
+  mExtracted.clear();
+  mRemap.clear();
+  mRemap.shrink_to_fit();
+  notifyResized(before);
+  if (mJournal != nullptr) { mJournal->clear(); }
+
+  const auto stats = Arena::stats();
+  mLogger->info(
+    "Released {} messages in {} chunks ({} bytes)",
+    messages,
+    chunks,
+    reserved
+  );
+  mLogger->debug(
+    "Arena totals: {} stores in {} chunk allocations, {} released",
+    stats.stores,
+    stats.chunksAllocated,
+    stats.chunksReleased
+  );
 }
 
-bool History::load(const std::string &recording) {
-  if (recording.empty()) {
-    mLogger->error("No file provided");
-    return false;
-  }
-
-  const bool exists = fs::exists(recording);
-  if (!exists) {
-    mLogger->warn("File does not exist: {}", recording);
-    return false;
-  }
+bool History::load(
+  Recording::Reader &reader,
+  const std::function<bool(size_t done, size_t total)> &progress
+) {
+  Recording::Record record;
+  while (reader.next(record)) {
+    append(record);
+    mRemap.push_back(mMessages.size() - 1);
 
-  std::ifstream input(recording);
-  if (!input.is_open()) {
-    const auto ec = std::error_code(errno, std::system_category());
-    mLogger->warn("Could not open '{}': {}", recording, ec.message());
-    return false;
+    if (mMessages.size() % LoadProgressInterval == 0) {
+      if (!progress(reader.position(), reader.size())) {
+        mLogger->info("Loading cancelled");
+        return false;
+      }
+    }
   }
 
-  std::stringstream buffer;
-  buffer << input.rdbuf();
-  if (!nlohmann::json::accept(buffer.str())) {
-    mLogger->warn("Could not parse '{}'", recording);
+  if (reader.failed()) {
+    mLogger->warn("Could not load messages");
     return false;
   }
-  const auto data = nlohmann::json::parse(buffer.str());
 
-  const auto messagesIt = data.find("messages");
-  if (messagesIt == std::end(data)) {
-    mLogger->warn("Could not find key 'messages' in '{}'", recording);
-    return false;
-  }
-  if (!messagesIt->is_array()) {
-    mLogger->warn("Key 'messages' is not an array");
-    return false;
-  }
-
-  for (const auto &msg : *messagesIt) {
-    Node node;
-
-    const auto subscriptionIt = msg.find("subscription");
-    if (false // NOLINT
-        || subscriptionIt == std::end(msg)
-        || !subscriptionIt->is_number_unsigned()) {
-      mLogger->warn("Message is missing subscription id");
-      return false;
-    }
-    node.subscriptionId = *subscriptionIt;
-
-    const auto topicIt = msg.find("topic");
-    if (true // NOLINT
-        && topicIt != std::end(msg) && topicIt->is_string()) {
-      node.message.topic = *topicIt;
-    }
-
-    const auto qosIt = msg.find("qos");
-    if (true // NOLINT
-        && qosIt != std::end(msg) && qosIt->is_number_unsigned()) {
-      node.message.qos = *qosIt;
-    }
-
-    const auto payloadIt = msg.find("payload");
-    if (true // NOLINT
-        && payloadIt != std::end(msg) && payloadIt->is_string()) {
-      node.message.payload = *payloadIt;
-    }
+  mLogger->info("Loaded {} messages", mMessages.size());
 
-    const auto timestampIt = msg.find("timestamp");
-    if (true // NOLINT
-        && timestampIt != std::end(msg) && timestampIt->is_string()) {
-      node.message.timestamp = Common::Helpers::stringToTime(*timestampIt);
-    }
+  return true;
+}
 
-    const auto retainedIt = msg.find("retained");
-    if (true // NOLINT
-        && retainedIt != std::end(msg) && retainedIt->is_string()) {
-      node.message.retained = *retainedIt;
-    }
+void History::attach(std::unique_ptr<Recording::View> view) {
+  mView = std::move(view);
+  ++mGeneration;
+  mExtracted.clear();
 
-    mMessages.push_back(node);
-    mRemap.push_back(mMessages.size() - 1);
-    RowAppended();
+  Recording::Record last;
+  if (mView->size() != 0 && mView->get(mView->size() - 1, last)) {
+    mViewLast = last.timestamp;
+  }
+  if (!mView->checkpoints().empty()) {
+    mViewLast = std::max(mViewLast, mView->checkpoints().back().timestamp);
   }
 
-  mLogger->info("Loaded {} messages", mMessages.size());
+  remap();
+}
 
-  return true;
+void History::setJournal(std::shared_ptr<Recording::Journal> journal) {
+  mJournal = std::move(journal);
 }
 
 nlohmann::json History::toJson() const {
   nlohmann::json result;
 
   for (const auto &node : mMessages) {
-    const auto &message = node.message;
-    const auto timestamp = Common::Helpers::timeToString(message.timestamp);
+    const auto timestamp = Common::Helpers::timeToString(node.timestamp);
     result.push_back({
       {"subscription", node.subscriptionId},
-      {"topic", message.topic},
-      {"qos", message.qos},
-      {"payload", message.payload},
-      {"retained", message.retained},
+      {"topic", std::string(mTopics[node.topicId])},
+      {"qos", node.qos},
+      {"payload", std::string(node.payload)},
+      {"retained", node.retained},
       {"timestamp", timestamp},
     });
   }
@@ -154,17 +182,61 @@ nlohmann::json History::toJson() const {
   return result;
 }
 
+History::Snapshot History::snapshot(bool visibleOnly) const {
+  Snapshot result;
+  if (mView != nullptr) { return result; }
+  result.pin = mArena.pin();
+  result.records.reserve(visibleOnly ? mRemap.size() : mMessages.size());
+
+  const auto add = [this, &result](const Node &node) {
+    result.records.push_back({
+      node.subscriptionId,
+      mTopics[node.topicId],
+      node.payload,
+      node.qos,
+      node.retained,
+      node.timestamp,
+    });
+  };
+
+  if (visibleOnly) {
+    for (const auto index : mRemap) { add(mMessages[index]); }
+  } else {
+    for (const auto &node : mMessages) { add(node); }
+  }
+  return result;
+}
+
 void History::onMessage(
   MQTT::Subscription::Id subscriptionId,
   const MQTT::Message &message
 ) {
-  Node node{message, subscriptionId};
-  mMessages.push_back(std::move(node));
+  const Recording::Record record{
+    subscriptionId,
+    message.topic,
+    message.payload,
+    message.qos,
+    message.retained,
+    message.timestamp,
+  };
+  append(record);
+
+  if (mJournal != nullptr) {
+    if (!mJournal->knows(subscriptionId)) {
+      for (const auto &subscription : mSubscriptions->snapshot()) {
+        if (subscription.id == subscriptionId) {
+          mJournal->subscribe(subscription);
+        }
+      }
+    }
+    mJournal->append(record);
+  }
   const bool isMuted = mSubscriptions->getMuted(subscriptionId);
   const bool isFiltered = mFilter.empty()
     || message.topic.find(mFilter) != std::string::npos;
+  const bool isInWindow = inTimeWindow(mMessages.size() - 1);
 
-  if (!isMuted && isFiltered) {
+  if (!isMuted && isFiltered && isInWindow) {
     mRemap.push_back(mMessages.size() - 1);
     RowAppended();
 
@@ -188,38 +260,235 @@ void History::
 }
 
 void History::onUnsubscribed(MQTT::Subscription::Id subscriptionId) {
-  for (auto it = std::begin(mMessages); it != std::end(mMessages);) {
-    if (it->subscriptionId == subscriptionId) {
-      it = mMessages.erase(it);
-    } else {
-      ++it;
+  erase(subscriptionId);
+  remap();
+  if (mJournal != nullptr) { mJournal->clear(subscriptionId); }
+}
+
+void History::onCleared(MQTT::Subscription::Id subscriptionId) {
+  erase(subscriptionId);
+  remap();
+  if (mJournal != nullptr) { mJournal->clear(subscriptionId); }
+}
+
+void History::append(const Recording::Record &record) {
+  Node node;
+  node.payload = mArena.store(record.payload);
+  node.timestamp = record.timestamp;
+  node.subscriptionId = record.subscriptionId;
+  node.topicId = intern(record.topic);
+  node.qos = record.qos;
+  node.retained = record.retained;
+  mMessages.push_back(node);
+
+  // Clamp clock jumps so that the timeline stays sorted for binary search.
+  const auto timestamp = mTimeline.empty()
+    ? record.timestamp
+    : std::max(mTimeline.back(), record.timestamp);
+  mTimeline.push_back(timestamp);
+
+  for (const auto &[id, observer] : mObservers) {
+    observer->onAppended(record);
+  }
+}
+
+void History::erase(MQTT::Subscription::Id subscriptionId) {
+  if (mView != nullptr) {
+    mLogger->info("Messages of a recording view cannot be removed");
+    return;
+  }
+
+  const auto removed = std::remove_if(
+    std::begin(mMessages),
+    std::end(mMessages),
+    [subscriptionId](const Node &node) {
+      return node.subscriptionId == subscriptionId;
     }
+  );
+  mMessages.erase(removed, std::end(mMessages));
+  ++mGeneration;
+  mExtracted.clear();
+
+  mTimeline.clear();
+  mTimeline.reserve(mMessages.size());
+  for (const auto &node : mMessages) {
+    const auto timestamp = mTimeline.empty()
+      ? node.timestamp
+      : std::max(mTimeline.back(), node.timestamp);
+    mTimeline.push_back(timestamp);
   }
 
-  remap();
+  compact();
 }
 
-void History::onCleared(MQTT::Subscription::Id subscriptionId) {
-  for (auto it = std::begin(mMessages); it != std::end(mMessages);) {
-    if (it->subscriptionId == subscriptionId) {
-      it = mMessages.erase(it);
+void History::compact() {
+  if (mArena.used() == 0) { return; }
+
+  size_t live = 0;
+  for (const auto &node : mMessages) { live += node.payload.size(); }
+  for (const auto &topic : mTopics) { live += topic.size(); }
+  if (live * CompactRatio > mArena.used()) { return; }
+
+  const auto chunksBefore = mArena.chunks();
+
+  constexpr auto Unused = std::numeric_limits<TopicId>::max();
+  Arena arena;
+  std::vector<std::string_view> topics;
+  std::unordered_map<std::string_view, TopicId> topicIds;
+  std::vector<TopicId> translated(mTopics.size(), Unused);
+
+  for (auto &node : mMessages) {
+    auto &topicId = translated.at(node.topicId);
+    if (topicId == Unused) {
+      const auto stored = arena.store(mTopics.at(node.topicId));
+      topicId = static_cast<TopicId>(topics.size());
+      topics.push_back(stored);
+      topicIds.emplace(stored, topicId);
+    }
+    node.topicId = topicId;
+    node.payload = arena.store(node.payload);
+  }
+
+  mArena = std::move(arena);
+  mTopics = std::move(topics);
+  mTopicIds = std::move(topicIds);
+
+  mLogger->info(
+    "Compacted history from {} to {} chunks",
+    chunksBefore,
+    mArena.chunks()
+  );
+}
+
+History::TopicId History::intern(std::string_view topic) {
+  const auto it = mTopicIds.find(topic);
+  if (it != std::end(mTopicIds)) { return it->second; }
+
+  const auto stored = mArena.store(topic);
+  const auto topicId = static_cast<TopicId>(mTopics.size());
+  mTopics.push_back(stored);
+  mTopicIds.emplace(stored, topicId);
+  return topicId;
+}
+
+size_t History::toIndex(unsigned row) const {
+  if (mView != nullptr && mViewContiguous) { return mViewBegin + row; }
+  return mRemap.at(row);
+}
+
+Recording::Record History::record(size_t index) const {
+  if (mView != nullptr) {
+    Recording::Record result;
+    if (!mView->get(index, result)) {
+      mLogger->warn("Could not read message {} from the recording", index);
+    }
+    return result;
+  }
+
+  const auto &node = mMessages.at(index);
+  return {
+    node.subscriptionId,
+    mTopics.at(node.topicId),
+    node.payload,
+    node.qos,
+    node.retained,
+    node.timestamp,
+  };
+}
+
+size_t History::viewLowerBound(Timestamp timestamp) const {
+  // Narrow down with the checkpoints, then search between two of them.
+  const auto &checkpoints = mView->checkpoints();
+  const auto after = std::partition_point(
+    std::begin(checkpoints),
+    std::end(checkpoints),
+    [timestamp](const Recording::View::Checkpoint &checkpoint) {
+      return checkpoint.timestamp < timestamp;
+    }
+  );
+  size_t low = after == std::begin(checkpoints)
+    ? 0
+    : std::prev(after)->index;
+  size_t high = after == std::end(checkpoints) ? mView->size() : after->index;
+
+  Recording::Record current;
+  while (low < high) {
+    const auto middle = low + (high - low) / 2;
+    if (!mView->get(middle, current)) { break; }
+    if (current.timestamp < timestamp) {
+      low = middle + 1;
     } else {
-      ++it;
+      high = middle;
     }
   }
+  return low;
+}
 
-  remap();
+bool History::inTimeWindow(size_t index) const {
+  const auto timestamp = mTimeline.at(index);
+  return mWindowFrom <= timestamp && timestamp <= windowEnd();
+}
+
+History::Timestamp History::windowEnd() const {
+  return std::min(mWindowTo, mPlayhead);
+}
+
+void History::notifyResized(size_t before) {
+  const size_t after = GetCount();
+
+  if (after > before) {
+    if (after - before > ResetThreshold) {
+      Reset(static_cast<unsigned>(after));
+    } else {
+      for (size_t i = before; i != after; ++i) { RowAppended(); }
+    }
+
+    const auto item = GetItem(static_cast<unsigned>(after - 1));
+    for (const auto &[id, observer] : mObservers) { observer->onMessage(item); }
+  } else if (after < before) {
+    if (before - after > ResetThreshold) {
+      Reset(static_cast<unsigned>(after));
+    } else {
+      wxArrayInt rows;
+      for (size_t i = after; i != before; ++i) {
+        rows.Add(static_cast<int>(i));
+      }
+      RowsDeleted(rows);
+    }
+  }
 }
 
 void History::remap() {
-  const size_t before = mRemap.size();
+  if (mView != nullptr) {
+    remapView();
+    return;
+  }
+
+  const size_t before = GetCount();
   mRemap.clear();
   mRemap.reserve(mMessages.size());
 
-  for (size_t i = 0; i < mMessages.size(); ++i) {
-    const bool isMuted = mSubscriptions->getMuted(mMessages[i].subscriptionId);
-    const bool isFiltered = mFilter.empty()
-      || mMessages[i].message.topic.find(mFilter) != std::string::npos;
+  // Evaluate the filter once per distinct topic instead of once per message.
+  std::vector<bool> topicMatches(mTopics.size(), true);
+  if (!mFilter.empty()) {
+    for (size_t i = 0; i != mTopics.size(); ++i) {
+      topicMatches[i] = mTopics[i].find(mFilter) != std::string_view::npos;
+    }
+  }
+
+  const auto first = std::lower_bound(
+    std::begin(mTimeline),
+    std::end(mTimeline),
+    mWindowFrom
+  );
+  const auto last = std::upper_bound(first, std::end(mTimeline), windowEnd());
+  const auto begin = static_cast<size_t>(first - std::begin(mTimeline));
+  const auto end = static_cast<size_t>(last - std::begin(mTimeline));
+
+  for (size_t i = begin; i < end; ++i) {
+    const auto &node = mMessages[i];
+    const bool isMuted = mSubscriptions->getMuted(node.subscriptionId);
+    const bool isFiltered = topicMatches[node.topicId];
 
     if (!isMuted && isFiltered) { mRemap.push_back(i); }
   }
@@ -243,7 +512,122 @@ void History::remap() {
   }
 }
 
+void History::remapView() {
+  stopRemap();
+  mRemap.clear();
+
+  mViewBegin = mWindowFrom == Timestamp::min()
+    ? 0
+    : viewLowerBound(mWindowFrom);
+  mViewEnd = std::max(mViewBegin, countUntil(windowEnd()));
+
+  std::unordered_set<MQTT::Subscription::Id> muted;
+  for (const auto &subscription : mView->subscriptions()) {
+    if (mSubscriptions->getMuted(subscription.id)) {
+      muted.insert(subscription.id);
+    }
+  }
+
+  // Only a filter or a mute costs memory per message, a time window alone
+  // is just a range.
+  mViewContiguous = mFilter.empty() && muted.empty();
+  if (mViewContiguous) {
+    mRemap.shrink_to_fit();
+    Reset(GetCount());
+    return;
+  }
+
+  // The view is read by the control meanwhile, so the worker reads its own.
+  auto view = mView->clone();
+  if (view == nullptr) {
+    mLogger->warn("Could not map the recording again, remapping in place");
+    mView->scan(
+      mViewBegin,
+      mViewEnd,
+      [this](std::string_view topic) {
+        return mFilter.empty() || topic.find(mFilter) != std::string::npos;
+      },
+      [this, &muted](size_t index, const Recording::Record &record) {
+        if (muted.count(record.subscriptionId) == 0) {
+          mRemap.push_back(index);
+        }
+      }
+    );
+    mRemap.shrink_to_fit();
+    Reset(GetCount());
+    return;
+  }
+
+  Reset(0);
+  mRemapCancelled = false;
+  mRemapDone = false;
+  mRemapThread = std::thread(
+    [this,
+     view = std::move(view),
+     filter = mFilter,
+     muted = std::move(muted),
+     begin = mViewBegin,
+     end = mViewEnd]() {
+      std::vector<size_t> remap;
+      const auto matches = [&filter](std::string_view topic) {
+        return filter.empty() || topic.find(filter) != std::string::npos;
+      };
+      const auto visitor = [&](size_t index, const Recording::Record &record) {
+        if (muted.count(record.subscriptionId) == 0) { remap.push_back(index); }
+      };
+
+      for (size_t from = begin; from < end; from += RemapBatch) {
+        if (mRemapCancelled) { return; }
+        const auto to = std::min(end, from + RemapBatch);
+        view->scan(from, to, matches, visitor);
+
+        auto *progress = new Events::Recording(Events::RECORDING_PROGRESS);
+        progress->setProgress(to - begin, end - begin);
+        wxQueueEvent(this, progress);
+      }
+
+      remap.shrink_to_fit();
+      mRemapped = std::move(remap);
+      mRemapDone = true;
+
+      auto *loaded = new Events::Recording(Events::RECORDING_LOADED);
+      loaded->setSucceeded(true);
+      wxQueueEvent(this, loaded);
+    }
+  );
+}
+
+void History::stopRemap() {
+  if (!mRemapThread.joinable()) { return; }
+  mRemapCancelled = true;
+  mRemapThread.join();
+  mRemapDone = false;
+  mRemapped = {};
+
+  // Lets the handlers know that no more progress follows.
+  auto *loaded = new Events::Recording(Events::RECORDING_LOADED);
+  loaded->setSucceeded(false);
+  wxQueueEvent(this, loaded);
+}
+
+void History::onRemapped(Events::Recording &event) {
+  event.Skip();
+  // A remap that was stopped since may still have queued its event.
+  if (!mRemapDone || !mRemapThread.joinable()) { return; }
+  mRemapThread.join();
+  mRemapDone = false;
+
+  mRemap = std::move(mRemapped);
+  mRemapped = {};
+  Reset(GetCount());
+}
+
 void History::refresh(MQTT::Subscription::Id subscriptionId) {
+  if (mView != nullptr) {
+    Reset(GetCount());
+    return;
+  }
+
   for (uint32_t i = 0; i < mRemap.size(); ++i) {
     if (mMessages[mRemap[i]].subscriptionId == subscriptionId) {
       RowChanged(i);
@@ -252,23 +636,38 @@ void History::refresh(MQTT::Subscription::Id subscriptionId) {
 }
 
 std::string History::getPayload(const wxDataViewItem &item) const {
-  return mMessages.at(mRemap.at(GetRow(item))).message.payload;
+  return std::string(record(toIndex(GetRow(item))).payload);
 }
 
 std::string History::getTopic(const wxDataViewItem &item) const {
-  return mMessages.at(mRemap.at(GetRow(item))).message.topic;
+  return std::string(record(toIndex(GetRow(item))).topic);
 }
 
 MQTT::QoS History::getQos(const wxDataViewItem &item) const {
-  return mMessages.at(mRemap.at(GetRow(item))).message.qos;
+  return record(toIndex(GetRow(item))).qos;
 }
 
 bool History::getRetained(const wxDataViewItem &item) const {
-  return mMessages.at(mRemap.at(GetRow(item))).message.retained;
+  return record(toIndex(GetRow(item))).retained;
+}
+
+MQTT::Message History::getMessage(const wxDataViewItem &item) const {
+  return getMessageAt(toIndex(GetRow(item)));
+}
+
+MQTT::Message History::getMessageAt(size_t index) const {
+  const auto current = record(index);
+  return {
+    std::string(current.topic),
+    std::string(current.payload),
+    current.qos,
+    current.retained,
+    current.timestamp,
+  };
 }
 
-const MQTT::Message &History::getMessage(const wxDataViewItem &item) const {
-  return mMessages.at(mRemap.at(GetRow(item))).message;
+Recording::Record History::getRecordAt(size_t index) const {
+  return record(index);
 }
 
 void History::setFilter(const std::string &filter) {
@@ -280,13 +679,265 @@ void History::setSelected(const wxDataViewItem &item) { mSelected = item; }
 
 void History::showDt(bool show) { mShowDt = show; }
 
+void History::setPathColumns(std::vector<Payload::JsonPath> paths) {
+  mPaths = std::move(paths);
+  mExtracted.clear();
+}
+
+void History::setTimeWindow(Timestamp from, Timestamp to) {
+  mWindowFrom = from;
+  mWindowTo = to;
+  remap();
+}
+
+void History::clearTimeWindow() {
+  setTimeWindow(Timestamp::min(), Timestamp::max());
+}
+
+void History::setPlayhead(Timestamp playhead) {
+  const size_t before = GetCount();
+  const auto previousEnd = countUntil(windowEnd());
+  mPlayhead = playhead;
+  const auto end = countUntil(windowEnd());
+
+  // The rows being remapped do not exist yet, and revealing many messages of
+  // a view at once would scan them here.
+  const bool remapping = mRemapThread.joinable();
+  const bool far = end > mViewEnd && end - mViewEnd > RemapBatch;
+  if (mView != nullptr && !mViewContiguous && (remapping || far)) {
+    remapView();
+    return;
+  }
+
+  // The playhead only ever cuts the tail of the rows, so moving it keeps the
+  // rows before it and avoids a full remap.
+  if (mView != nullptr && mViewContiguous) {
+    mViewEnd = std::max(mViewBegin, end);
+  } else if (end < previousEnd) {
+    const auto kept = std::lower_bound(
+      std::begin(mRemap),
+      std::end(mRemap),
+      end
+    );
+    mRemap.erase(kept, std::end(mRemap));
+    if (mView != nullptr) { mViewEnd = std::max(mViewBegin, end); }
+  } else if (mView != nullptr) {
+    const auto viewEnd = std::max(mViewBegin, end);
+    mView->scan(
+      mViewEnd,
+      viewEnd,
+      [this](std::string_view topic) {
+        return mFilter.empty() || topic.find(mFilter) != std::string::npos;
+      },
+      [this](size_t index, const Recording::Record &record) {
+        if (!mSubscriptions->getMuted(record.subscriptionId)) {
+          mRemap.push_back(index);
+        }
+      }
+    );
+    mViewEnd = viewEnd;
+  } else {
+    const auto first = std::lower_bound(
+      std::begin(mTimeline),
+      std::end(mTimeline),
+      mWindowFrom
+    );
+    const auto begin = static_cast<size_t>(first - std::begin(mTimeline));
+    for (size_t i = std::max(begin, previousEnd); i < end; ++i) {
+      const auto &node = mMessages[i];
+      const bool isMuted = mSubscriptions->getMuted(node.subscriptionId);
+      const bool isFiltered = mFilter.empty()
+        || mTopics[node.topicId].find(mFilter) != std::string_view::npos;
+      if (!isMuted && isFiltered) { mRemap.push_back(i); }
+    }
+  }
+
+  notifyResized(before);
+}
+
+void History::clearPlayhead() { setPlayhead(Timestamp::max()); }
+
+void History::visit(size_t begin, size_t end, const TopicVisitor &visitor)
+  const {
+  if (mView != nullptr) {
+    mView->scan(
+      begin,
+      end,
+      [](std::string_view /* topic */) { return true; },
+      [&visitor](size_t index, const Recording::Record &record) {
+        visitor(index, record.topic);
+      }
+    );
+    return;
+  }
+
+  end = std::min(end, mMessages.size());
+  for (size_t i = begin; i < end; ++i) {
+    visitor(i, mTopics[mMessages[i].topicId]);
+  }
+}
+
+void History::visitRecords(
+  size_t begin,
+  size_t end,
+  const RecordVisitor &visitor
+) const {
+  if (mView != nullptr) {
+    mView->scan(
+      begin,
+      end,
+      [](std::string_view /* topic */) { return true; },
+      visitor
+    );
+    return;
+  }
+
+  end = std::min(end, mMessages.size());
+  for (size_t i = begin; i < end; ++i) { visitor(i, record(i)); }
+}
+
+History::Timestamp History::getTimestamp(const wxDataViewItem &item) const {
+  return record(toIndex(GetRow(item))).timestamp;
+}
+
+std::pair<History::Timestamp, History::Timestamp> History::getTimeRange(
+) const {
+  if (mView != nullptr) {
+    const auto &checkpoints = mView->checkpoints();
+    if (checkpoints.empty()) { return {}; }
+    return {checkpoints.front().timestamp, mViewLast};
+  }
+
+  if (mTimeline.empty()) { return {}; }
+  return {mTimeline.front(), mTimeline.back()};
+}
+
+std::pair<History::Timestamp, History::Timestamp> History::getTimeWindow(
+) const {
+  return {mWindowFrom, mWindowTo};
+}
+
+wxDataViewItem History::findByTime(Timestamp timestamp) const {
+  if (mView != nullptr) {
+    const auto count = GetCount();
+    if (count == 0) { return {}; }
+
+    size_t row = 0;
+    if (mViewContiguous) {
+      const auto index = std::max(viewLowerBound(timestamp), mViewBegin);
+      row = std::min(index, mViewEnd - 1) - mViewBegin;
+    } else {
+      const auto index = viewLowerBound(timestamp);
+      const auto it = std::lower_bound(
+        std::begin(mRemap),
+        std::end(mRemap),
+        index
+      );
+      const auto position = static_cast<size_t>(it - std::begin(mRemap));
+      row = std::min(position, mRemap.size() - 1);
+    }
+    return GetItem(static_cast<unsigned>(row));
+  }
+
+  // mRemap is ascending and mTimeline is sorted, so the visible rows are
+  // sorted by time as well.
+  const auto it = std::partition_point(
+    std::begin(mRemap),
+    std::end(mRemap),
+    [this, timestamp](size_t index) { return mTimeline[index] < timestamp; }
+  );
+  if (it == std::end(mRemap)) {
+    if (mRemap.empty()) { return {}; }
+    return GetItem(static_cast<unsigned>(mRemap.size() - 1));
+  }
+  return GetItem(static_cast<unsigned>(it - std::begin(mRemap)));
+}
+
+std::vector<size_t> History::getDensity(size_t buckets) const {
+  std::vector<size_t> result(buckets, 0);
+
+  if (mView != nullptr) {
+    // Spread each checkpoint's messages over the bucket it starts in.
+    const auto &checkpoints = mView->checkpoints();
+    if (buckets == 0 || checkpoints.empty()) { return result; }
+
+    const auto first = checkpoints.front().timestamp;
+    const auto span = std::max(mViewLast - first, Timestamp::duration(1));
+    for (size_t i = 0; i != checkpoints.size(); ++i) {
+      const auto end = i + 1 == checkpoints.size()
+        ? mView->size()
+        : checkpoints[i + 1].index;
+      const auto offset = checkpoints[i].timestamp - first;
+      const auto bucket = static_cast<size_t>(
+        static_cast<double>(offset.count()) * static_cast<double>(buckets)
+        / static_cast<double>(span.count())
+      );
+      result[std::min(bucket, buckets - 1)] += end - checkpoints[i].index;
+    }
+    return result;
+  }
+
+  if (buckets == 0 || mTimeline.empty()) { return result; }
+
+  const auto first = mTimeline.front();
+  const auto span = mTimeline.back() - first;
+
+  auto previous = std::begin(mTimeline);
+  for (size_t i = 0; i != buckets; ++i) {
+    const auto boundary = first + span * static_cast<double>(i + 1)
+      / static_cast<double>(buckets);
+    const auto next = (i + 1 == buckets)
+      ? std::end(mTimeline)
+      : std::upper_bound(
+          previous,
+          std::end(mTimeline),
+          std::chrono::time_point_cast<Timestamp::duration>(boundary)
+        );
+    result[i] = static_cast<size_t>(next - previous);
+    previous = next;
+  }
+
+  return result;
+}
+
+size_t History::getTotal() const {
+  if (mView != nullptr) { return mView->size(); }
+  return mMessages.size();
+}
+
+size_t History::getGeneration() const { return mGeneration; }
+
+size_t History::countUntil(Timestamp timestamp) const {
+  if (mView != nullptr) {
+    if (timestamp == Timestamp::max()) { return mView->size(); }
+    return viewLowerBound(timestamp + Timestamp::duration(1));
+  }
+
+  const auto it = std::upper_bound(
+    std::begin(mTimeline),
+    std::end(mTimeline),
+    timestamp
+  );
+  return static_cast<size_t>(it - std::begin(mTimeline));
+}
+
+bool History::isView() const { return mView != nullptr; }
+
 std::string History::getFilter() const { return mFilter; }
 
+const std::vector<Payload::JsonPath> &History::getPathColumns() const {
+  return mPaths;
+}
+
 unsigned History::GetColumnCount() const {
-  return static_cast<uint32_t>(Column::Max);
+  return static_cast<uint32_t>(Column::Max)
+    + static_cast<uint32_t>(mPaths.size());
 }
 
 unsigned History::GetCount() const {
+  if (mView != nullptr && mViewContiguous) {
+    return static_cast<uint32_t>(mViewEnd - mViewBegin);
+  }
   return static_cast<uint32_t>(mRemap.size());
 }
 
@@ -319,7 +970,15 @@ void History::GetValueByRow(
   unsigned int row,
   unsigned int col
 ) const {
-  const auto &node = mMessages.at(mRemap.at(row));
+  constexpr auto PathsBegin = static_cast<unsigned>(Column::Max);
+  if (col >= PathsBegin) {
+    if (col - PathsBegin >= mPaths.size()) { return; }
+    const auto &value = pathValue(toIndex(row), col - PathsBegin);
+    variant = wxString::FromUTF8(value.data(), value.length());
+    return;
+  }
+
+  const auto node = record(toIndex(row));
 
   constexpr size_t MessageIconWidth = 10;
   constexpr size_t MessageIconHeight = 20;
@@ -339,10 +998,10 @@ void History::GetValueByRow(
     } break;
     case Column::Topic: {
       wxDataViewIconText result;
-      const auto &topic = node.message.topic;
+      const auto &topic = node.topic;
       const auto wxs = wxString::FromUTF8(topic.data(), topic.length());
       result.SetText(wxs);
-      if (node.message.retained) {
+      if (node.retained) {
         wxIcon icon;
         icon.CopyFromBitmap(*bin2cPinned18x18());
         result.SetIcon(icon);
@@ -351,7 +1010,7 @@ void History::GetValueByRow(
     } break;
     case Column::Qos: {
       const wxBitmap *result = nullptr;
-      switch (node.message.qos) {
+      switch (node.qos) {
         case MQTT::QoS::AtLeastOnce: {
           result = bin2cQos0();
         } break;
@@ -383,11 +1042,34 @@ void History::GetValueByRow(
 std::chrono::milliseconds History::deltaToSelected(size_t row) const {
   using namespace std::chrono;
   if (!mSelected.IsOk()) { return {}; }
-  const auto &current = mMessages.at(mRemap.at(row));
-  const auto &selected = mMessages.at(mRemap.at(GetRow(mSelected)));
-  return duration_cast<milliseconds>(
-    current.message.timestamp - selected.message.timestamp
-  );
+  const auto current = record(toIndex(static_cast<unsigned>(row))).timestamp;
+  const auto selected = record(toIndex(GetRow(mSelected))).timestamp;
+  return duration_cast<milliseconds>(current - selected);
+}
+
+// Extracts the values of all the path columns of a message at once, labeled
+// so that they can be told apart without a header.
+const std::string &History::pathValue(size_t index, size_t path) const {
+  auto it = mExtracted.find(index);
+  if (it == std::end(mExtracted)) {
+    if (mExtracted.size() >= ExtractedLimit) { mExtracted.clear(); }
+
+    const auto payload = record(index).payload;
+    std::vector<std::string> values(mPaths.size());
+    std::string_view token;
+    std::string text;
+    for (size_t i = 0; i != mPaths.size(); ++i) {
+      if (!mPaths[i].find(payload, token)) { continue; }
+      Payload::JsonPath::text(token, PathValueLength, text);
+      values[i] = fmt::format(
+        "<span color=\"#888888\">{}</span> {}",
+        quoteMarkup(mPaths[i].label()),
+        quoteMarkup(text)
+      );
+    }
+    it = mExtracted.emplace(index, std::move(values)).first;
+  }
+  return it->second.at(path);
 }
 
 bool History::GetAttrByRow(
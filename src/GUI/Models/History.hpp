@@ -1,16 +1,34 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
 #include <mqtt/message.h>
 #include <spdlog/spdlog.h>
 #include <wx/dataview.h>
 
+#include "Common/Arena.hpp"
+#include "GUI/Events/Recording.hpp"
 #include "GUI/Models/Subscriptions.hpp"
 #include "MQTT/Client.hpp"
 #include "MQTT/Message.hpp"
 #include "MQTT/Subscription.hpp"
+#include "Payload/JsonPath.hpp"
+#include "Recording/Journal.hpp"
+#include "Recording/Reader.hpp"
+#include "Recording/Record.hpp"
+#include "Recording/View.hpp"
 
 namespace Rapatas::Transmitron::GUI::Models {
 
+// Row changes larger than this are cheaper as a reset of the control, for
+// the history and the models that follow it.
+constexpr size_t ResetThreshold = 1024;
+
 class History :
   public wxEvtHandler,
   public wxDataViewVirtualListModel,
@@ -27,6 +45,9 @@ public:
     Observer &operator=(Observer &&) = default;
 
     virtual void onMessage(wxDataViewItem item) = 0;
+    // Every message that is added, whether it is shown or not, before it
+    // can be cleared or removed.
+    virtual void onAppended(const Recording::Record & /* record */) {}
   };
 
   enum class Column : uint8_t {
@@ -37,45 +58,160 @@ public:
     Max
   };
 
+  using Timestamp = std::chrono::system_clock::time_point;
+  using TopicVisitor =
+    std::function<void(size_t index, std::string_view topic)>;
+  using RecordVisitor =
+    std::function<void(size_t index, const Recording::Record &record)>;
+
+  struct Snapshot {
+    std::shared_ptr<const void> pin;
+    std::vector<Recording::Record> records;
+  };
+
   explicit History(const wxObjectDataPtr<Subscriptions> &subscriptions);
+  ~History() override;
+  History(const History &) = delete;
+  History(History &&) = delete;
+  History &operator=(const History &) = delete;
+  History &operator=(History &&) = delete;
 
   size_t attachObserver(Observer *observer);
   bool detachObserver(size_t id);
   void clear();
-  bool load(const std::string &recording);
+  // Rows are added without notifications, so this may run on a worker
+  // thread as long as the model is not associated with a control yet.
+  // Returning false from progress cancels the load.
+  bool load(
+    Recording::Reader &reader,
+    const std::function<bool(size_t done, size_t total)> &progress
+  );
+  // Serves the rows straight from the recording instead of loading it. The
+  // history is read-only from then on. Same threading rules as load.
+  //
+  // Filtering or muting the rows of a view then scans the recording on a
+  // worker, showing no rows until it is done. Meanwhile the history queues
+  // Events::RECORDING_PROGRESS to itself, and Events::RECORDING_LOADED once
+  // the rows are there or the scan was abandoned. Handlers bound to it
+  // should skip them.
+  void attach(std::unique_ptr<Recording::View> view);
+  // Every message that arrives and every clear from then on is journaled.
+  void setJournal(std::shared_ptr<Recording::Journal> journal);
   void setFilter(const std::string &filter);
   void setSelected(const wxDataViewItem &item);
   void showDt(bool show);
+  // Columns from Column::Max on show the value at these paths in each
+  // payload. Values are extracted for the rows that are shown and kept until
+  // the paths change.
+  void setPathColumns(std::vector<Payload::JsonPath> paths);
+  void setTimeWindow(Timestamp from, Timestamp to);
+  void clearTimeWindow();
+  // Hides the messages after the playhead. Moving it forward appends the
+  // revealed rows and notifies the observers, like live messages do.
+  void setPlayhead(Timestamp playhead);
+  void clearPlayhead();
+  // Visits the topics of the messages in [begin, end) in recorded order,
+  // regardless of filters.
+  void visit(size_t begin, size_t end, const TopicVisitor &visitor) const;
+  // Same as visit, with the whole records.
+  void visitRecords(size_t begin, size_t end, const RecordVisitor &visitor)
+    const;
 
   [[nodiscard]] std::string getPayload(const wxDataViewItem &item) const;
   [[nodiscard]] std::string getTopic(const wxDataViewItem &item) const;
   [[nodiscard]] MQTT::QoS getQos(const wxDataViewItem &item) const;
   [[nodiscard]] bool getRetained(const wxDataViewItem &item) const;
   [[nodiscard]] std::string getFilter() const;
+  [[nodiscard]] const std::vector<Payload::JsonPath> &getPathColumns() const;
   [[nodiscard]] nlohmann::json toJson() const;
-  [[nodiscard]] const MQTT::Message &getMessage( //
-    const wxDataViewItem &item
-  ) const;
+  // With visibleOnly, only the rows that pass the filters, mutes and time
+  // window, in the order they are shown.
+  [[nodiscard]] Snapshot snapshot(bool visibleOnly = false) const;
+  [[nodiscard]] MQTT::Message getMessage(const wxDataViewItem &item) const;
+  [[nodiscard]] MQTT::Message getMessageAt(size_t index) const;
+  // Same as getMessageAt without copying, valid until the history changes
+  // or reads another message.
+  [[nodiscard]] Recording::Record getRecordAt(size_t index) const;
+  [[nodiscard]] Timestamp getTimestamp(const wxDataViewItem &item) const;
+  [[nodiscard]] std::pair<Timestamp, Timestamp> getTimeRange() const;
+  [[nodiscard]] std::pair<Timestamp, Timestamp> getTimeWindow() const;
+  [[nodiscard]] wxDataViewItem findByTime(Timestamp timestamp) const;
+  [[nodiscard]] std::vector<size_t> getDensity(size_t buckets) const;
+  [[nodiscard]] size_t getTotal() const;
+  // Changes whenever messages are removed or replaced, which moves the
+  // indices of the rest.
+  [[nodiscard]] size_t getGeneration() const;
+  // Number of recorded messages up to and including the timestamp.
+  [[nodiscard]] size_t countUntil(Timestamp timestamp) const;
+  [[nodiscard]] bool isView() const;
 
 private:
 
+  using TopicId = uint32_t;
+
   struct Node {
-    MQTT::Message message;
+    std::string_view payload;
+    Timestamp timestamp;
     MQTT::Subscription::Id subscriptionId{};
+    TopicId topicId{};
+    MQTT::QoS qos = MQTT::QoS::AtLeastOnce;
+    bool retained = false;
   };
 
   std::shared_ptr<spdlog::logger> mLogger;
+  Common::Arena mArena;
+  std::vector<std::string_view> mTopics;
+  std::unordered_map<std::string_view, TopicId> mTopicIds;
   std::vector<Node> mMessages;
+  std::vector<Timestamp> mTimeline;
   std::vector<size_t> mRemap;
+  size_t mGeneration = 0;
   wxObjectDataPtr<Subscriptions> mSubscriptions;
   std::map<size_t, Observer *> mObservers;
+  std::shared_ptr<Recording::Journal> mJournal;
   std::string mFilter;
   wxDataViewItem mSelected;
   bool mShowDt = false;
-
+  Timestamp mWindowFrom = Timestamp::min();
+  Timestamp mWindowTo = Timestamp::max();
+  Timestamp mPlayhead = Timestamp::max();
+
+  std::vector<Payload::JsonPath> mPaths;
+  // The values at mPaths of the messages shown so far, by message index.
+  mutable std::unordered_map<size_t, std::vector<std::string>> mExtracted;
+
+  // With a view and nothing filtered out, rows map to the contiguous range
+  // of messages starting at mViewBegin and mRemap stays empty.
+  std::unique_ptr<Recording::View> mView;
+  bool mViewContiguous = false;
+  size_t mViewBegin = 0;
+  size_t mViewEnd = 0;
+  Timestamp mViewLast;
+
+  // Scans a clone of mView for the rows of a filter or a mute. mRemapped is
+  // only touched by the worker until it is joined.
+  std::thread mRemapThread;
+  std::atomic<bool> mRemapCancelled = false;
+  std::atomic<bool> mRemapDone = false;
+  std::vector<size_t> mRemapped;
+
+  void append(const Recording::Record &record);
+  void erase(MQTT::Subscription::Id subscriptionId);
+  void compact();
   void remap();
+  void remapView();
+  void stopRemap();
+  void onRemapped(Events::Recording &event);
   void refresh(MQTT::Subscription::Id subscriptionId);
+  TopicId intern(std::string_view topic);
+  [[nodiscard]] size_t toIndex(unsigned row) const;
+  [[nodiscard]] Recording::Record record(size_t index) const;
+  [[nodiscard]] size_t viewLowerBound(Timestamp timestamp) const;
+  [[nodiscard]] bool inTimeWindow(size_t index) const;
+  [[nodiscard]] Timestamp windowEnd() const;
+  void notifyResized(size_t before);
   std::chrono::milliseconds deltaToSelected(size_t row) const;
+  [[nodiscard]] const std::string &pathValue(size_t index, size_t path) const;
 
   // wxDataViewVirtualListModel interface.
   [[nodiscard]] unsigned GetColumnCount() const override;
@@ -1,106 +1,296 @@
 #include "KnownTopics.hpp"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <fstream>
 
 #include <system_error>
 
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif // _WIN32
+
+#include <fmt/format.h>
+
 #include "Common/Log.hpp"
 
 using namespace Rapatas::Transmitron;
 using namespace Common;
 using namespace GUI::Models;
 
+// More rows than the popups show at once, to scroll through. Looking any
+// further would only take time.
+constexpr size_t RowLimit = 100;
+// Past this many topics, the ones seen longest ago are forgotten, a
+// sixteenth at a time.
+constexpr size_t TopicLimit = 524288;
+constexpr size_t EvictShare = 16;
+// Uses weigh half as much after this long.
+constexpr std::chrono::hours HalfLife(72);
+// The journal is compacted once it has this many times as many lines as
+// there are topics, and no sooner than at this many lines.
+constexpr size_t CompactRatio = 2;
+constexpr size_t CompactMinimum = 4096;
+// Journal lines start with one of these, followed by a line of the file for
+// a topic that was set, or the topic that was erased.
+constexpr char JournalSet = '+';
+constexpr char JournalErase = '-';
+constexpr char JournalClear = '!';
+
+namespace {
+
+// Instead of every score decaying as time passes, later uses weigh more, by
+// twice every HalfLife, which ranks the same. Scores are logarithms to stay
+// in range.
+double weigh(
+  double score,
+  uint32_t count,
+  std::chrono::system_clock::time_point when
+) {
+  using Seconds = std::chrono::duration<double>;
+  const auto halfLives = Seconds(when.time_since_epoch()) / Seconds(HalfLife);
+  const auto weight = std::log(count) + halfLives * std::log(2.0);
+  if (std::isinf(score)) { return weight; }
+
+  const auto high = std::max(score, weight);
+  const auto low = std::min(score, weight);
+  return high + std::log1p(std::exp(low - high));
+}
+
+// Lines are the topic, a tab, the score, a tab and when the topic was last
+// seen in seconds. Files from before scores were kept have only the topic.
+bool parseScored(
+  const std::string &line,
+  std::string_view &topic,
+  double &score,
+  int64_t &seen
+) {
+  const auto second = line.rfind('\t');
+  if (second == std::string::npos || second == 0) { return false; }
+  const auto first = line.rfind('\t', second - 1);
+  if (first == std::string::npos) { return false; }
+
+  char *end = nullptr;
+  score = std::strtod(line.c_str() + first + 1, &end);
+  if (end != line.c_str() + second) { return false; }
+  constexpr int Base = 10;
+  seen = std::strtoll(line.c_str() + second + 1, &end, Base);
+  if (end != line.c_str() + line.size() || second + 1 == line.size()) {
+    return false;
+  }
+
+  topic = std::string_view(line).substr(0, first);
+  return true;
+}
+
+std::string formatScored(
+  std::string_view topic,
+  double score,
+  std::chrono::system_clock::time_point seen
+) {
+  const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+    seen.time_since_epoch()
+  );
+  return fmt::format("{}\t{}\t{}\n", topic, score, seconds.count());
+}
+
+Common::fs::path journalOf(const Common::fs::path &filepath) {
+  auto result = filepath;
+  result += ".journal";
+  return result;
+}
+
+} // namespace
+
 KnownTopics::KnownTopics() {
   mLogger = Common::Log::create("Models::KnownTopics");
   remap();
 }
 
-KnownTopics::~KnownTopics() { save(); }
+KnownTopics::~KnownTopics() { flush(); }
 
 bool KnownTopics::load(const Common::fs::path &filepath) {
   mLogger->debug("Loading {}", filepath.string());
+  wait();
   mFilepath = filepath;
+  const auto journal = journalOf(mFilepath);
   const bool exists = fs::exists(mFilepath);
-  if (!exists) {
+  const bool journaled = fs::exists(journal);
+  if (!exists && !journaled) {
     mLogger->debug(
-      "Could not load file '{}': Not found. Creating new cache",
+      "Could not load file '{}': Not found. Starting a new cache",
       mFilepath.string()
     );
-    save();
     return false;
   }
 
-  std::ifstream file(mFilepath);
-  if (!file.is_open()) {
-    const auto ec = std::error_code(errno, std::system_category());
-    mLogger->warn(
-      "Could not load file '{}': {}",
-      mFilepath.string(),
-      ec.message() //
-    );
-    return false;
-  }
+  if (exists && !read(mFilepath, false)) { return false; }
+  if (journaled && !read(journal, true)) { return false; }
 
-  std::string line;
-  while (std::getline(file, line)) {
-    if (line.empty()) { continue; }
-    mTopics.insert(line);
-  }
+  // What was read is on disk already.
+  for (const auto id : mDirty) { mEntries[id].dirty = false; }
+  mDirty.clear();
+  mErased.clear();
+  mCleared = false;
 
+  evict();
   remap();
 
+  if (mJournaled > std::max(mTopics.size(), CompactMinimum) * CompactRatio) {
+    compact();
+  }
+
   return true;
 }
 
 void KnownTopics::clear() {
+  mEntries.clear();
+  mMasks.clear();
+  mFree.clear();
   mTopics.clear();
+  mMatched.clear();
+  mRecycled = true;
+  mCleared = true;
+  mErased.clear();
+  mDirty.clear();
   remap();
 }
 
 void KnownTopics::setFilter(std::string filter) {
+  if (filter == mFilter && !mStale) { return; }
   mFilter = std::move(filter);
   remap();
 }
 
+void KnownTopics::refresh() {
+  if (mStale) { remap(); }
+}
+
 void KnownTopics::append(std::string topic) {
   if (topic == "#") { return; }
   if (topic.empty()) { return; }
 
-  const auto it = std::find(std::begin(mTopics), std::end(mTopics), topic);
-  if (it != std::end(mTopics)) { return; }
-
-  mTopics.insert(std::move(topic));
-  remap();
+  hit(insert(topic), 1, std::chrono::system_clock::now());
+  evict();
+  mStale = true;
 }
 
 void KnownTopics::append(std::set<std::string> topics) {
   topics.erase("");
-  mTopics.merge(topics);
+  for (const auto &topic : topics) { insert(topic); }
+  evict();
+  mStale = true;
+}
+
+void KnownTopics::learn(const MQTT::TopicCounter::Counts &counts) {
+  const auto now = std::chrono::system_clock::now();
+  for (const auto &[topic, count] : counts) { hit(insert(topic), count, now); }
+  evict();
+  mStale = true;
 }
 
 const std::string &KnownTopics::getTopic(const wxDataViewItem &item) const {
-  return *(mRemap.at(GetRow(item)));
+  return mEntries[mRemap.at(GetRow(item))].topic;
 }
 
 const std::string &KnownTopics::getFilter() const { return mFilter; }
 
-void KnownTopics::remap() {
-  const size_t before = mRemap.size();
-  mRemap.clear();
-  mRemap.reserve(mTopics.size());
+KnownTopics::Id KnownTopics::insert(std::string_view topic) {
+  auto id = mTopics.find(topic);
+  if (id != MQTT::TopicTrie::None) { return id; }
+
+  if (mFree.empty()) {
+    id = static_cast<Id>(mEntries.size());
+    mEntries.emplace_back();
+    mMasks.emplace_back();
+  } else {
+    id = mFree.back();
+    mFree.pop_back();
+    mRecycled = true;
+  }
+  mEntries[id].topic.assign(topic);
+  mMasks[id] = MQTT::FuzzyMatcher::mask(topic);
+  mTopics.insert(topic, id);
+  mMatched.clear();
+  touch(id);
+  return id;
+}
+
+void KnownTopics::erase(Id id) {
+  auto &entry = mEntries[id];
+  mTopics.erase(entry.topic);
+  mErased.push_back(std::move(entry.topic));
+  entry = {};
+  mMasks[id] = 0;
+  mFree.push_back(id);
+  mMatched.clear();
+}
+
+void KnownTopics::hit(Id id, uint32_t count, Timestamp when) {
+  auto &entry = mEntries[id];
+  entry.score = weigh(entry.score, count, when);
+  entry.seen = std::max(entry.seen, when);
+  mTopics.setRank(entry.topic, entry.score);
+  touch(id);
+}
+
+void KnownTopics::touch(Id id) {
+  auto &entry = mEntries[id];
+  if (entry.dirty) { return; }
+  entry.dirty = true;
+  mDirty.push_back(id);
+}
+
+void KnownTopics::evict() {
+  const auto size = mTopics.size();
+  if (size <= TopicLimit) { return; }
 
-  for (auto it = std::begin(mTopics); it != std::end(mTopics); ++it) {
-    const auto &topic = *it;
-    const auto pos = topic.find(mFilter);
-    if (mFilter.empty() || pos != std::string::npos) { mRemap.push_back(it); }
+  std::vector<Id> ids;
+  ids.reserve(size);
+  for (Id id = 0; id != mEntries.size(); ++id) {
+    if (!mEntries[id].topic.empty()) { ids.push_back(id); }
   }
 
-  mRemap.shrink_to_fit();
+  const auto forget = size - (TopicLimit - TopicLimit / EvictShare);
+  const auto end = std::begin(ids) + static_cast<ptrdiff_t>(forget);
+  std::nth_element(
+    std::begin(ids),
+    end,
+    std::end(ids),
+    [this](Id lhs, Id rhs) { return mEntries[lhs].seen < mEntries[rhs].seen; }
+  );
+  for (auto it = std::begin(ids); it != end; ++it) { erase(*it); }
+
+  mLogger->info("Forgot {} topics seen longest ago", forget);
+}
+
+void KnownTopics::remap() {
+  std::vector<Id> previous;
+  std::swap(previous, mRemap);
+
+  const MQTT::FuzzyMatcher matcher(mFilter);
+  if (matcher.empty() || mFilter.find_first_of("+#") != std::string::npos) {
+    complete();
+  } else {
+    match(matcher);
+  }
+
+  const size_t before = previous.size();
   const size_t after = mRemap.size();
 
+  // Only the rows that show another topic change, unless an entry was
+  // reused for another topic, which keeps its id.
   const auto common = std::min(before, after);
-  for (uint32_t i = 0; i != common; ++i) { RowChanged(i); }
+  for (uint32_t i = 0; i != common; ++i) {
+    if (mRecycled || mRemap[i] != previous[i]) { RowChanged(i); }
+  }
+  mRecycled = false;
+  mStale = false;
 
   if (after > before) {
     const size_t diff = after - common;
@@ -113,32 +303,291 @@ void KnownTopics::remap() {
   }
 }
 
+void KnownTopics::complete() {
+  // Topics come best first, so the first RowLimit are the rows.
+  mRemap.reserve(RowLimit);
+  mTopics.complete(mFilter, [this](Id id) {
+    mRemap.push_back(id);
+    return mRemap.size() != RowLimit;
+  });
+}
+
+void KnownTopics::match(const MQTT::FuzzyMatcher &matcher) {
+  struct Match {
+    int score;
+    Id id;
+  };
+
+  // The best RowLimit rows are kept in a heap with the worst of them on top.
+  // How well the topics match ranks first, then their scores, with shorter
+  // topics ahead of longer ones that rank the same.
+  const auto better = [this](const Match &lhs, const Match &rhs) {
+    if (lhs.score != rhs.score) { return lhs.score > rhs.score; }
+    const auto &left = mEntries[lhs.id];
+    const auto &right = mEntries[rhs.id];
+    if (left.score != right.score) { return left.score > right.score; }
+    if (left.topic.size() != right.topic.size()) {
+      return left.topic.size() < right.topic.size();
+    }
+    return left.topic < right.topic;
+  };
+
+  std::vector<Match> matches;
+  matches.reserve(RowLimit);
+  std::vector<Id> matched;
+  const auto mask = matcher.mask();
+  const auto consider = [&](Id id) {
+    // Most topics lack some character of the filter, which the masks tell
+    // without looking at the topics.
+    if ((mMasks[id] & mask) != mask) { return; }
+
+    Match candidate{0, id};
+    if (!matcher.match(mEntries[id].topic, candidate.score)) { return; }
+    matched.push_back(id);
+
+    if (matches.size() == RowLimit) {
+      if (!better(candidate, matches.front())) { return; }
+      std::pop_heap(std::begin(matches), std::end(matches), better);
+      matches.pop_back();
+    }
+    matches.push_back(candidate);
+    std::push_heap(std::begin(matches), std::end(matches), better);
+  };
+
+  const bool narrow = !mMatched.empty()
+    && mFilter.compare(0, mMatched.size(), mMatched) == 0;
+  if (narrow) {
+    for (const auto id : mMatches) { consider(id); }
+  } else {
+    for (Id id = 0; id != mMasks.size(); ++id) { consider(id); }
+  }
+  std::sort_heap(std::begin(matches), std::end(matches), better);
+
+  mMatched = mFilter;
+  mMatches = std::move(matched);
+
+  mRemap.reserve(matches.size());
+  for (const auto &match : matches) { mRemap.push_back(match.id); }
+}
+
 bool KnownTopics::save(const Common::fs::path &filepath) {
   if (filepath.empty()) { return true; }
+  if (filepath == mFilepath) {
+    flush();
+    if (mJournaled > std::max(mTopics.size(), CompactMinimum) * CompactRatio) {
+      compact();
+    }
+    return true;
+  }
+
+  // A journal only goes with the file it was kept for, so one left at the
+  // new path is stale and all topics go in a new file.
+  wait();
   mFilepath = filepath;
-  save();
+  std::error_code ec;
+  fs::remove(journalOf(mFilepath), ec);
+  mJournaled = 0;
+  compact();
   return true;
 }
 
-void KnownTopics::save() {
-  if (mFilepath.empty()) { return; }
+bool KnownTopics::read(const Common::fs::path &filepath, bool journal) {
+  std::ifstream file(filepath);
+  if (!file.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->warn(
+      "Could not load file '{}': {}",
+      filepath.string(),
+      ec.message() //
+    );
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(file, line)) {
+    if (line.empty()) { continue; }
+    if (journal) {
+      ++mJournaled;
+      replay(line);
+    } else {
+      restore(line);
+    }
+  }
 
-  auto dir = mFilepath.parent_path();
-  fs::create_directories(dir);
+  return true;
+}
 
-  mLogger->info("Saving to {}", mFilepath.string());
-  std::ofstream file(mFilepath);
+void KnownTopics::restore(const std::string &line) {
+  std::string_view topic = line;
+  double score = 0;
+  int64_t seen = 0;
+  if (!parseScored(line, topic, score, seen)) {
+    insert(line);
+    return;
+  }
+
+  auto &entry = mEntries[insert(topic)];
+  entry.score = score;
+  entry.seen = Timestamp(std::chrono::seconds(seen));
+  mTopics.setRank(entry.topic, entry.score);
+}
+
+void KnownTopics::replay(std::string &line) {
+  const char operation = line.front();
+  line.erase(0, 1);
+
+  switch (operation) {
+    case JournalSet: {
+      if (!line.empty()) { restore(line); }
+    } break;
+    case JournalErase: {
+      const auto id = mTopics.find(line);
+      if (id != MQTT::TopicTrie::None) { erase(id); }
+    } break;
+    case JournalClear: {
+      clear();
+    } break;
+    default: {
+      mLogger->warn("Skipping unknown journal line '{}{}'", operation, line);
+    } break;
+  }
+}
+
+void KnownTopics::flush() {
+  wait();
+  if (mFilepath.empty()) { return; }
+  if (!mCleared && mErased.empty() && mDirty.empty()) { return; }
+
+  const auto journal = journalOf(mFilepath);
+  fs::create_directories(mFilepath.parent_path());
+  std::ofstream file(journal, std::ios::app);
   if (!file.is_open()) {
     const auto ec = std::error_code(errno, std::system_category());
     mLogger->warn(
       "Could not save file '{}': {}",
-      mFilepath.string(),
+      journal.string(),
+      ec.message() //
+    );
+    return;
+  }
+
+  // In the order they can happen: erased topics may come back, cleared
+  // ones may not.
+  size_t lines = 0;
+  if (mCleared) {
+    file << JournalClear << '\n';
+    ++lines;
+  }
+  for (const auto &topic : mErased) {
+    file << JournalErase << topic << '\n';
+    ++lines;
+  }
+  for (const auto id : mDirty) {
+    auto &entry = mEntries[id];
+    if (!entry.dirty) { continue; }
+    entry.dirty = false;
+    file << JournalSet << formatScored(entry.topic, entry.score, entry.seen);
+    ++lines;
+  }
+  file.flush();
+  if (file.fail()) {
+    mLogger->warn("Could not save file '{}'", journal.string());
+    return;
+  }
+
+  mCleared = false;
+  mErased.clear();
+  mDirty.clear();
+  mJournaled += lines;
+  mLogger->info("Journaled {} changes to {}", lines, journal.string());
+}
+
+void KnownTopics::compact() {
+  // Journaled first, so that nothing is lost if the rewrite fails.
+  flush();
+  if (mFilepath.empty()) { return; }
+
+  std::vector<Entry> entries;
+  entries.reserve(mTopics.size());
+  for (const auto &entry : mEntries) {
+    if (!entry.topic.empty()) { entries.push_back(entry); }
+  }
+
+  fs::create_directories(mFilepath.parent_path());
+  mJournaled = 0;
+  mCompaction = std::thread(
+    [this, entries = std::move(entries), filepath = mFilepath]() mutable {
+      rewrite(std::move(entries), filepath);
+    }
+  );
+}
+
+// Writes the file beside the old one and renames it over it once synced, so
+// that there is a whole file either way. The journal is only removed after.
+void KnownTopics::rewrite(
+  std::vector<Entry> entries,
+  const Common::fs::path &filepath
+) const {
+  // In order, so that loading appends to each level.
+  std::sort(
+    std::begin(entries),
+    std::end(entries),
+    [](const Entry &lhs, const Entry &rhs) { return lhs.topic < rhs.topic; }
+  );
+
+  auto partial = filepath;
+  partial += ".part";
+#ifdef _WIN32
+  std::FILE *file = ::_wfopen(partial.c_str(), L"wb");
+#else
+  std::FILE *file = std::fopen(partial.c_str(), "wb");
+#endif // _WIN32
+  if (file == nullptr) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->warn(
+      "Could not save file '{}': {}",
+      partial.string(),
       ec.message() //
     );
     return;
   }
 
-  for (const auto &topic : mTopics) { file << topic << "\n"; }
+  for (const auto &entry : entries) {
+    const auto line = formatScored(entry.topic, entry.score, entry.seen);
+    std::fwrite(line.data(), 1, line.size(), file);
+  }
+
+#ifdef _WIN32
+  const bool synced = std::fflush(file) == 0
+    && ::_commit(::_fileno(file)) == 0;
+#else
+  const bool synced = std::fflush(file) == 0 && ::fsync(::fileno(file)) == 0;
+#endif // _WIN32
+  const bool written = std::ferror(file) == 0 && synced;
+  std::fclose(file);
+  std::error_code ec;
+  if (!written) {
+    mLogger->warn("Could not save file '{}'", partial.string());
+    fs::remove(partial, ec);
+    return;
+  }
+
+  fs::rename(partial, filepath, ec);
+  if (ec) {
+    mLogger->warn(
+      "Could not rename '{}': {}",
+      partial.string(),
+      ec.message() //
+    );
+    return;
+  }
+  fs::remove(journalOf(filepath), ec);
+
+  mLogger->info("Saved {} topics to {}", entries.size(), filepath.string());
+}
+
+void KnownTopics::wait() {
+  if (mCompaction.joinable()) { mCompaction.join(); }
 }
 
 // wxDataViewVirtualListModel interface {
@@ -164,7 +613,7 @@ void KnownTopics::GetValueByRow(
 ) const {
   if (static_cast<Column>(col) != Column::Topic) { return; }
 
-  const auto &topic = *(mRemap.at(row));
+  const auto &topic = mEntries[mRemap.at(row)].topic;
   const auto wxs = wxString::FromUTF8(topic.data(), topic.length());
   variant = wxs;
 }
@@ -1,15 +1,32 @@
 #pragma once
 
+#include <chrono>
+#include <limits>
 #include <set>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include <spdlog/logger.h>
 #include <wx/dataview.h>
 
 #include "Common/Filesystem.hpp"
+#include "MQTT/FuzzyMatcher.hpp"
+#include "MQTT/TopicCounter.hpp"
+#include "MQTT/TopicTrie.hpp"
 
 namespace Rapatas::Transmitron::GUI::Models {
 
+// The topics used so far, ranked by how often and how recently they were
+// used. The rows are the best ranked topics that match the filter. Filters
+// with `+` or `#` complete level by level, with those as wildcards. Others
+// are matched fuzzily, like `b3 pmp pres` for `building3/pump/pressure`, and
+// rank by how well they match first.
+//
+// Topics are kept in a file and a journal next to it, of what changed since
+// the file was written. Saving appends only the changes to the journal. Once
+// the journal outgrows the file, the file is rewritten in the background and
+// renamed into place, and the journal starts over.
 class KnownTopics : public wxDataViewVirtualListModel
 {
 public:
@@ -32,8 +49,15 @@ public:
 
   void clear();
   void setFilter(std::string filter);
+  // Topics that come or go leave the rows as they are until the filter is
+  // set again or this is called, as they are only seen in popups.
+  void refresh();
+  // A topic that was used, which ranks it higher.
   void append(std::string topic);
+  // Topics to know of, without ranking them.
   void append(std::set<std::string> topics);
+  // Topics of received messages, ranked by how many messages each had.
+  void learn(const MQTT::TopicCounter::Counts &counts);
 
   [[nodiscard]] const std::string &getTopic(const wxDataViewItem &item) const;
   [[nodiscard]] const std::string &getFilter() const;
@@ -60,16 +84,67 @@ public:
 
 private:
 
-  using Topics = std::set<std::string>;
+  using Id = MQTT::TopicTrie::Id;
+  using Timestamp = std::chrono::system_clock::time_point;
+
+  struct Entry {
+    // Empty while the entry is free.
+    std::string topic;
+    // The logarithm of the uses, each weighted by when it happened, so that
+    // scores compare the same however much time passes.
+    double score = -std::numeric_limits<double>::infinity();
+    Timestamp seen;
+    // Changed since it was last journaled.
+    bool dirty = false;
+  };
 
   std::shared_ptr<spdlog::logger> mLogger;
   Common::fs::path mFilepath;
-  Topics mTopics;
-  std::vector<Topics::const_iterator> mRemap;
+  std::vector<Entry> mEntries;
+  // The FuzzyMatcher mask of each entry's topic, apart to scan quickly.
+  std::vector<uint64_t> mMasks;
+  std::vector<Id> mFree;
+  MQTT::TopicTrie mTopics;
+  std::vector<Id> mRemap;
   std::string mFilter;
-
+  // Topics came or went since the rows were mapped. Entries are freed but
+  // never removed then, so the rows stay valid ids until remapped.
+  bool mStale = false;
+  // An entry was reused since the rows were mapped.
+  bool mRecycled = false;
+  // The topics that matched mMatched, the last filter matched fuzzily. Only
+  // those can match a filter that extends it, as one does while typing.
+  // Cleared whenever topics come or go.
+  std::string mMatched;
+  std::vector<Id> mMatches;
+
+  // What changed since the journal was last appended to.
+  bool mCleared = false;
+  std::vector<std::string> mErased;
+  std::vector<Id> mDirty;
+  // Lines in the journal, to tell when to compact it.
+  size_t mJournaled = 0;
+  std::thread mCompaction;
+
+  Id insert(std::string_view topic);
+  void erase(Id id);
+  void hit(Id id, uint32_t count, Timestamp when);
+  void touch(Id id);
+  void evict();
   void remap();
-  void save();
+  void complete();
+  void match(const MQTT::FuzzyMatcher &matcher);
+
+  bool read(const Common::fs::path &filepath, bool journal);
+  void restore(const std::string &line);
+  void replay(std::string &line);
+  void flush();
+  void compact();
+  void rewrite(
+    std::vector<Entry> entries,
+    const Common::fs::path &filepath
+  ) const;
+  void wait();
 };
 
 } // namespace Rapatas::Transmitron::GUI::Models
@@ -0,0 +1,200 @@
+#include "LastValues.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "Common/Log.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace GUI::Models;
+
+// The fewest messages between keyframes, however few topics there are.
+constexpr size_t KeyframeInterval = 16384;
+constexpr size_t None = std::numeric_limits<size_t>::max();
+constexpr size_t PayloadPreviewLength = 128;
+
+LastValues::LastValues(const wxObjectDataPtr<History> &history) :
+  mHistory(history) //
+{
+  mLogger = Common::Log::create("Models::LastValues");
+  clear();
+}
+
+void LastValues::seek(size_t end) {
+  const auto total = mHistory->getTotal();
+  if (total < mIndexed) {
+    // Messages were removed from the history, so the indices moved.
+    clear();
+    Reset(0);
+  }
+
+  end = std::min(end, total);
+  index(end);
+
+  const size_t before = GetCount();
+  const auto next = std::upper_bound(
+    std::begin(mKeyframes),
+    std::end(mKeyframes),
+    end,
+    [](size_t index, const Keyframe &keyframe) {
+      return index < keyframe.begin;
+    }
+  );
+  const auto &keyframe = *std::prev(next);
+  const auto keyframeBegin = keyframe.begin;
+
+  std::vector<TopicId> changed;
+  bool incremental = false;
+  if (mEnd <= end && mEnd >= keyframeBegin) {
+    apply(mEnd, end, changed);
+    incremental = true;
+  } else if (end == mIndexed) {
+    mState = mIndexedState;
+  } else {
+    mState = keyframe.state;
+    apply(keyframeBegin, end, changed);
+  }
+  mEnd = end;
+
+  const size_t count = GetCount();
+  if (!incremental || changed.size() > ResetThreshold) {
+    Reset(static_cast<unsigned>(count));
+    return;
+  }
+
+  std::sort(std::begin(changed), std::end(changed));
+  changed.erase(
+    std::unique(std::begin(changed), std::end(changed)),
+    std::end(changed)
+  );
+  for (const auto topicId : changed) {
+    if (topicId < before) { RowChanged(topicId); }
+  }
+  for (size_t i = before; i < count; ++i) { RowAppended(); }
+}
+
+MQTT::Message LastValues::getMessage(const wxDataViewItem &item) const {
+  const auto index = mState.at(GetRow(item));
+  if (index == None) { return {}; }
+  return mHistory->getMessageAt(index);
+}
+
+void LastValues::clear() {
+  mTopics.clear();
+  mTopicIds.clear();
+  mFirst.clear();
+  mKeyframes.clear();
+  mKeyframes.emplace_back();
+  mIndexedState.clear();
+  mIndexed = 0;
+  mState.clear();
+  mEnd = 0;
+}
+
+void LastValues::index(size_t end) {
+  if (end <= mIndexed) { return; }
+
+  mHistory->visit(mIndexed, end, [this](size_t index, std::string_view topic) {
+    const auto spacing = std::max(KeyframeInterval, mTopics.size());
+    if (index - mKeyframes.back().begin >= spacing) {
+      mKeyframes.push_back({index, mIndexedState});
+    }
+
+    const auto it = mTopicIds.find(topic);
+    if (it != std::end(mTopicIds)) {
+      mIndexedState[it->second] = index;
+      return;
+    }
+
+    const auto topicId = static_cast<TopicId>(mTopics.size());
+    mTopics.emplace_back(topic);
+    mTopicIds.emplace(mTopics.back(), topicId);
+    mFirst.push_back(index);
+    mIndexedState.push_back(index);
+  });
+
+  mLogger->debug(
+    "Indexed {} messages, {} topics in {} keyframes",
+    end,
+    mTopics.size(),
+    mKeyframes.size()
+  );
+  mIndexed = end;
+}
+
+void LastValues::apply(
+  size_t begin,
+  size_t end,
+  std::vector<TopicId> &changed
+) {
+  mState.resize(mTopics.size(), None);
+  mHistory->visit(
+    begin,
+    end,
+    [this, &changed](size_t index, std::string_view topic) {
+      const auto topicId = mTopicIds.at(topic);
+      mState[topicId] = index;
+      changed.push_back(topicId);
+    }
+  );
+}
+
+size_t LastValues::visible(size_t end) const {
+  const auto it = std::lower_bound(std::begin(mFirst), std::end(mFirst), end);
+  return static_cast<size_t>(it - std::begin(mFirst));
+}
+
+unsigned LastValues::GetColumnCount() const {
+  return static_cast<unsigned>(Column::Max);
+}
+
+wxString LastValues::GetColumnType(unsigned int /* col */) const {
+  return wxDataViewTextRenderer::GetDefaultType();
+}
+
+unsigned LastValues::GetCount() const {
+  return static_cast<unsigned>(visible(mEnd));
+}
+
+void LastValues::GetValueByRow(
+  wxVariant &variant,
+  unsigned int row,
+  unsigned int col
+) const {
+  switch (static_cast<Column>(col)) {
+    case Column::Topic: {
+      const auto &topic = mTopics.at(row);
+      variant = wxString::FromUTF8(topic.data(), topic.length());
+    } break;
+    case Column::Payload: {
+      const auto index = mState.at(row);
+      if (index == None) {
+        variant = "";
+        break;
+      }
+      // Only the part that is shown is copied.
+      const auto record = mHistory->getRecordAt(index);
+      auto payload = record.payload.substr(0, record.payload.find('\n'));
+      payload = payload.substr(0, PayloadPreviewLength);
+      variant = wxString::FromUTF8(payload.data(), payload.length());
+    } break;
+    default: {
+    }
+  }
+}
+
+bool LastValues::GetAttrByRow(
+  unsigned int /* row */,
+  unsigned int /* col */,
+  wxDataViewItemAttr & /* attr */
+) const {
+  return false;
+}
+
+bool LastValues::SetValueByRow(
+  const wxVariant & /* variant */,
+  unsigned int /* row */,
+  unsigned int /* col */
+) {
+  return false;
+}
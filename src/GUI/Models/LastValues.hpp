@@ -0,0 +1,95 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/logger.h>
+#include <wx/dataview.h>
+
+#include "GUI/Models/History.hpp"
+#include "MQTT/Message.hpp"
+
+namespace Rapatas::Transmitron::GUI::Models {
+
+// The last message of every topic at a point of the history. Keyframes of
+// that state are kept as messages go, so any point can be reconstructed from
+// the keyframe before it instead of from the start. They are at least as
+// many messages apart as there are topics, so that they take no more memory
+// than the messages they skip.
+class LastValues : public wxDataViewVirtualListModel
+{
+public:
+
+  enum class Column : uint8_t {
+    Topic,
+    Payload,
+    Max
+  };
+
+  explicit LastValues(const wxObjectDataPtr<History> &history);
+
+  // Shows the state after the first `end` messages of the history.
+  void seek(size_t end);
+
+  [[nodiscard]] MQTT::Message getMessage(const wxDataViewItem &item) const;
+
+  // wxDataViewVirtualListModel interface.
+  [[nodiscard]] unsigned GetColumnCount() const override;
+  [[nodiscard]] wxString GetColumnType(unsigned int col) const override;
+  [[nodiscard]] unsigned GetCount() const override;
+  void GetValueByRow(
+    wxVariant &variant,
+    unsigned int row,
+    unsigned int col //
+  ) const override;
+  bool GetAttrByRow(
+    unsigned int row,
+    unsigned int col,
+    wxDataViewItemAttr &attr
+  ) const override;
+  bool SetValueByRow(
+    const wxVariant &variant,
+    unsigned int row,
+    unsigned int col
+  ) override;
+
+private:
+
+  using TopicId = uint32_t;
+  // Index of the last message per topic, or None before its first one.
+  using State = std::vector<size_t>;
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  wxObjectDataPtr<History> mHistory;
+
+  // Topics are numbered in order of first appearance, so the topics seen up
+  // to any point are always a prefix of them and rows map to topic ids.
+  std::deque<std::string> mTopics;
+  std::unordered_map<std::string_view, TopicId> mTopicIds;
+  std::vector<size_t> mFirst;
+
+  struct Keyframe {
+    // The state before this message.
+    size_t begin = 0;
+    State state;
+  };
+
+  // In order of begin, built up to mIndexed, where mIndexedState holds the
+  // state.
+  std::vector<Keyframe> mKeyframes;
+  State mIndexedState;
+  size_t mIndexed = 0;
+
+  State mState;
+  size_t mEnd = 0;
+
+  void clear();
+  void index(size_t end);
+  void apply(size_t begin, size_t end, std::vector<TopicId> &changed);
+  [[nodiscard]] size_t visible(size_t end) const;
+};
+
+} // namespace Rapatas::Transmitron::GUI::Models
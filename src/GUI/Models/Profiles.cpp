@@ -1,6 +1,7 @@
 #include "Profiles.hpp"
 
 #include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <limits>
 #include <optional>
@@ -155,14 +156,13 @@ void Profiles::createQuickConnect() {
   mQuickConnect.topicsSubscribed = topicsSubscribed;
   mQuickConnect.topicsPublished = topicsPublished;
 
-  if (canSave) {
-    const auto cache = String::replace(
-      path,
-      mConfigProfilesDir,
-      mCacheProfilesDir
-    );
-    mQuickConnect.save(path, cache);
-  }
+  const auto cache = String::replace(
+    path,
+    mConfigProfilesDir,
+    mCacheProfilesDir
+  );
+  mQuickConnect.cacheDir = cache;
+  if (canSave) { mQuickConnect.save(path, cache); }
 }
 
 wxDataViewItem Profiles::createProfile(wxDataViewItem parentItem) {
@@ -248,6 +248,53 @@ wxObjectDataPtr<KnownTopics> Profiles::getTopicsPublished(wxDataViewItem item) {
   return profile.topicsPublished;
 }
 
+std::string Profiles::createJournalPath(wxDataViewItem item) const {
+  auto *leaf = getLeaf(item);
+  if (leaf == nullptr) { return {}; }
+
+  auto &profile = *dynamic_cast<Profile *>(leaf);
+  if (profile.cacheDir.empty()) { return {}; }
+  const auto now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::system_clock::now().time_since_epoch()
+  );
+  const auto filename = fmt::format(
+    "{}-{}{}",
+    JournalPrefix,
+    now.count(),
+    JournalExtension
+  );
+  return (profile.cacheDir / filename).string();
+}
+
+std::vector<std::string> Profiles::getJournalPaths(wxDataViewItem item
+) const {
+  auto *leaf = getLeaf(item);
+  if (leaf == nullptr) { return {}; }
+
+  auto &profile = *dynamic_cast<Profile *>(leaf);
+  std::error_code ec;
+  if (profile.cacheDir.empty() || !fs::is_directory(profile.cacheDir, ec)) {
+    return {};
+  }
+
+  std::vector<std::pair<fs::file_time_type, std::string>> journals;
+  for (const auto &entry : fs::directory_iterator(profile.cacheDir, ec)) {
+    const auto &path = entry.path();
+    const auto filename = path.filename().string();
+    if (!entry.is_regular_file(ec) || path.extension() != JournalExtension
+        || filename.compare(0, JournalPrefix.size(), JournalPrefix) != 0) {
+      continue;
+    }
+    journals.emplace_back(fs::last_write_time(path, ec), path.string());
+  }
+  std::sort(std::begin(journals), std::end(journals));
+
+  std::vector<std::string> result;
+  result.reserve(journals.size());
+  for (auto &[time, path] : journals) { result.push_back(std::move(path)); }
+  return result;
+}
+
 void Profiles::leafValue(
   Id id,
   wxDataViewIconText &value,
@@ -298,6 +345,7 @@ bool Profiles::Profile::save(
 ) {
   fs::create_directories(config);
   fs::create_directories(cache);
+  cacheDir = cache;
 
   return true                    // NOLINT
     && saveOptionsBroker(config) //
@@ -369,6 +417,7 @@ bool Profiles::Profile::load(
   const Common::fs::path &cache
 ) {
   mLogger->debug("Profile::load({})", config.string());
+  cacheDir = cache;
 
   if (const auto opt = loadOptionsClient(config)) {
     clientOptions = opt.value();
@@ -496,7 +545,11 @@ void Profiles::renameLayoutIfMissing(const std::string &newName) {
     );
     if (it != std::end(layouts)) { continue; }
 
-    profile.clientOptions = Types::ClientOptions{newName};
+    profile.clientOptions = Types::ClientOptions{
+      newName,
+      profile.clientOptions.getJournal(),
+      profile.clientOptions.getLearnTopics(),
+    };
     leafSave(nodeId);
   }
 }
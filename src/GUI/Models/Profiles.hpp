@@ -1,6 +1,8 @@
 #pragma once
 
 #include <optional>
+#include <string>
+#include <vector>
 
 #include <spdlog/spdlog.h>
 #include <wx/dataview.h>
@@ -54,6 +56,12 @@ public:
   wxObjectDataPtr<Messages> getMessagesModel(wxDataViewItem item);
   wxObjectDataPtr<KnownTopics> getTopicsSubscribed(wxDataViewItem item);
   wxObjectDataPtr<KnownTopics> getTopicsPublished(wxDataViewItem item);
+  // Where a new session of the profile journals, whether enabled or not.
+  // Every session has its own, as a profile can be open in several tabs.
+  [[nodiscard]] std::string createJournalPath(wxDataViewItem item) const;
+  // The journals of sessions of the profile, open or not, oldest first.
+  [[nodiscard]] std::vector<std::string> getJournalPaths(wxDataViewItem item
+  ) const;
 
 private:
 
@@ -82,12 +90,15 @@ private:
     wxObjectDataPtr<Messages> messages;
     wxObjectDataPtr<KnownTopics> topicsSubscribed;
     wxObjectDataPtr<KnownTopics> topicsPublished;
+    Common::fs::path cacheDir;
   };
 
   static constexpr std::string_view
     BrokerOptionsFilename = "broker-options.json";
   static constexpr std::string_view
     ClientOptionsFilename = "client-options.json";
+  static constexpr std::string_view JournalPrefix = "session";
+  static constexpr std::string_view JournalExtension = ".tmrj";
 
   std::shared_ptr<spdlog::logger> mLogger;
   const ArtProvider &mArtProvider;
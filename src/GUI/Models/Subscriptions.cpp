@@ -45,76 +45,16 @@ bool Subscriptions::detachObserver(size_t id) {
   return true;
 }
 
-bool Subscriptions::load(const std::string &recording) {
-  if (recording.empty()) {
-    mLogger->error("No file provided");
-    return false;
-  }
-
-  const bool exists = fs::exists(recording);
-  if (!exists) {
-    mLogger->warn("File does not exist: {}", recording);
-    return false;
-  }
-
-  std::ifstream input(recording);
-  if (!input.is_open()) {
-    const auto ec = std::error_code(errno, std::system_category());
-    mLogger->warn("Could not open '{}': {}", recording, ec.message());
-    return false;
-  }
-
-  std::stringstream buffer;
-  buffer << input.rdbuf();
-  if (!nlohmann::json::accept(buffer.str())) {
-    mLogger->warn("Could not parse '{}'", recording);
-    return false;
-  }
-  const auto data = nlohmann::json::parse(buffer.str());
-
-  const auto subscriptionsIt = data.find("subscriptions");
-  if (subscriptionsIt == std::end(data)) {
-    mLogger->warn("Could not find key 'subscriptions' in '{}'", recording);
-    return false;
-  }
-  if (!subscriptionsIt->is_array()) {
-    mLogger->warn("Key 'subscriptions' is not an array");
-    return false;
-  }
-
-  for (const auto &sub : *subscriptionsIt) {
-    MQTT::Subscription::Id id{};
-    std::string filter;
-    MQTT::QoS qos = MQTT::QoS::AtLeastOnce;
-
-    const auto idIt = sub.find("id");
-    if (false // NOLINT
-        || idIt == std::end(sub) || !idIt->is_number_unsigned()) {
-      mLogger->warn("Subscription is missing id");
-      return false;
-    }
-    id = *idIt;
-
-    const auto filterIt = sub.find("filter");
-    if (true // NOLINT
-        && filterIt != std::end(sub) && filterIt->is_string()) {
-      filter = *filterIt;
-    }
-
-    const auto qosIt = sub.find("qos");
-    if (true // NOLINT
-        && qosIt != std::end(sub) && qosIt->is_number_unsigned()) {
-      qos = *qosIt;
-    }
-
+void Subscriptions::load(
+  const std::vector<Recording::Subscription> &subscriptions
+) {
+  for (const auto &[id, filter, qos] : subscriptions) {
     auto subscription = std::make_unique<Types::Subscription>(id, filter, qos);
     mSubscriptions.emplace(id, std::move(subscription));
     mRemap.push_back(id);
   }
 
   mLogger->info("Loaded {} subscriptions", mSubscriptions.size());
-
-  return true;
 }
 
 nlohmann::json Subscriptions::toJson() const {
@@ -131,6 +71,15 @@ nlohmann::json Subscriptions::toJson() const {
   return result;
 }
 
+std::vector<Recording::Subscription> Subscriptions::snapshot() const {
+  std::vector<Recording::Subscription> result;
+  result.reserve(mSubscriptions.size());
+  for (const auto &[id, subscription] : mSubscriptions) {
+    result.push_back({id, subscription->getFilter(), subscription->getQos()});
+  }
+  return result;
+}
+
 std::string Subscriptions::getFilter(wxDataViewItem item) const {
   const auto &sub = mSubscriptions.at(mRemap.at(GetRow(item)));
   return sub->getFilter();
@@ -8,6 +8,7 @@
 #include "GUI/Events/Subscription.hpp"
 #include "GUI/Types/Subscription.hpp"
 #include "MQTT/Client.hpp"
+#include "Recording/Record.hpp"
 
 namespace Rapatas::Transmitron::GUI::Models {
 
@@ -50,7 +51,7 @@ public:
 
   size_t attachObserver(Observer *observer);
   bool detachObserver(size_t id);
-  bool load(const std::string &recording);
+  void load(const std::vector<Recording::Subscription> &subscriptions);
 
   void mute(wxDataViewItem item);
   void setColor(wxDataViewItem item, const wxColor &color);
@@ -65,6 +66,7 @@ public:
   [[nodiscard]] std::string getFilter(wxDataViewItem item) const;
   [[nodiscard]] wxColor getColor(MQTT::Subscription::Id subscriptionId) const;
   [[nodiscard]] nlohmann::json toJson() const;
+  [[nodiscard]] std::vector<Recording::Subscription> snapshot() const;
   [[nodiscard]] std::string getFilter( //
     MQTT::Subscription::Id subscriptionId
   ) const;
@@ -1,13 +1,20 @@
 #include "Client.hpp"
 
+#include <algorithm>
+#include <array>
 #include <memory>
 
+#include <fmt/format.h>
 #include <nlohmann/json.hpp>
 #include <wx/artprov.h>
 #include <wx/clipbrd.h>
+#include <wx/filedlg.h>
+#include <wx/gauge.h>
 
+#include "Common/Filesystem.hpp"
 #include "Common/Helpers.hpp"
 #include "Common/Log.hpp"
+#include "Common/Url.hpp"
 #include "GUI/Events/Layout.hpp"
 #include "GUI/Events/Recording.hpp"
 #include "GUI/Resources/history/history-18x14.hpp"
@@ -16,7 +23,12 @@
 #include "GUI/Resources/send/send-18x14.hpp"
 #include "GUI/Resources/subscription/subscription-18x14.hpp"
 #include "GUI/Widgets/Edit.hpp"
+#include "GUI/Widgets/Export.hpp"
+#include "GUI/Widgets/Replay.hpp"
 #include "MQTT/Message.hpp"
+#include "Recording/Reader.hpp"
+#include "Recording/Replay.hpp"
+#include "Recording/Writer.hpp"
 
 using namespace Rapatas::Transmitron;
 using namespace GUI::Tabs;
@@ -25,15 +37,26 @@ using namespace GUI;
 using namespace Common;
 
 constexpr size_t FontSize = 9;
+// Topics of arriving messages are taken in at most this often.
+constexpr int LearnIntervalMs = 1000;
 static constexpr size_t PaneMinWidth = 100;
 static constexpr size_t PaneMinHeight = 100;
 static constexpr size_t PaneBestWidth = 412;
 static constexpr size_t MessagesBestWidth = 200;
+static constexpr size_t RecordProgressInterval = 4096;
+static constexpr int RecordProgressRange = 1000;
+static constexpr int PlaybackTickMs = 33;
+static constexpr int PlaybackSeekRange = 10000;
+static constexpr std::array<double, 7> PlaybackSpeeds = {
+  0.1, 0.5, 1, 2, 5, 10, 100, // NOLINT
+};
+static constexpr int DefaultPlaybackSpeed = 2;
 
 Client::Client(
   wxWindow *parent,
   const MQTT::BrokerOptions &brokerOptions,
   Types::ClientOptions clientOptions,
+  const std::string &journalPath,
   const wxObjectDataPtr<Models::Messages> &messages,
   const wxObjectDataPtr<Models::KnownTopics> &topicsSubscribed,
   const wxObjectDataPtr<Models::KnownTopics> &topicsPublished,
@@ -74,6 +97,22 @@ Client::Client(
 
   mClient->setBrokerOptions(brokerOptions);
   setupPanels();
+
+  if (mClientOptions.getLearnTopics()) {
+    mLearnTimer.SetOwner(this);
+    Bind(wxEVT_TIMER, &Client::onLearnTimer, this, mLearnTimer.GetId());
+    mLearnTimer.Start(LearnIntervalMs);
+  }
+
+  if (mClientOptions.getJournal() && !journalPath.empty()) {
+    mJournal = std::make_shared<Recording::Journal>(journalPath);
+    if (mJournal->failed()) {
+      mJournal.reset();
+    } else {
+      mHistoryModel->setJournal(mJournal);
+    }
+  }
+
   mClient->connect();
 }
 
@@ -197,8 +236,54 @@ void Client::setupPanels() {
 
     mPanes.at(Panes::Messages).info.MinSize(MessagesBestWidth, -1);
     mPanes.at(Panes::Publish).info.MinSize(PaneBestWidth, -1);
+  } else {
+    mPanes.insert({
+      Panes::LastValues,
+      {
+        "Last values",
+        {},
+        nullptr,
+        mArtProvider.bitmap(Icon::History),
+        bin2cHistory18x14(),
+        nullptr,
+      },
+    });
+
+    mPanes.at(Panes::LastValues).info.Left();
+    mPanes.at(Panes::LastValues).info.Layer(2);
+    mPanes.at(Panes::LastValues).info.MinSize(PaneBestWidth, -1);
   }
 
+  mPanes.insert({
+    Panes::Plot,
+    {
+      "Plot",
+      {},
+      nullptr,
+      mArtProvider.bitmap(Icon::History),
+      bin2cHistory18x14(),
+      nullptr,
+    },
+  });
+  mPanes.at(Panes::Plot).info.Bottom();
+  mPanes.at(Panes::Plot).info.Layer(1);
+  mPanes.at(Panes::Plot).info.MinSize(PaneBestWidth, PaneMinHeight);
+
+  mPanes.insert({
+    Panes::Aggregates,
+    {
+      "Statistics",
+      {},
+      nullptr,
+      mArtProvider.bitmap(Icon::Search),
+      bin2cHistory18x14(),
+      nullptr,
+    },
+  });
+  mPanes.at(Panes::Aggregates).info.Bottom();
+  mPanes.at(Panes::Aggregates).info.Layer(1);
+  mPanes.at(Panes::Aggregates).info.MinSize(PaneBestWidth, PaneMinHeight);
+
   for (auto &pane : mPanes) {
     const auto fixed = pane.first == Panes::History;
     pane.second.info.Caption(pane.second.name);
@@ -219,6 +304,9 @@ void Client::setupPanels() {
   setupPanelSubscriptions(managed);
   setupPanelPreview(managed);
   setupPanelHistory(managed);
+  if (mClient == nullptr) { setupPanelLastValues(managed); }
+  setupPanelPlot(managed);
+  setupPanelAggregates(managed);
   setupPanelConnect(this);
 
   auto *sizer = new wxBoxSizer(wxVERTICAL);
@@ -245,10 +333,27 @@ void Client::setupPanels() {
 }
 
 Client::~Client() {
+  // The model may outlive this tab.
+  mHistoryModel->Unbind(
+    Events::RECORDING_PROGRESS,
+    &Client::onHistoryRemapProgress,
+    this
+  );
+  mHistoryModel->Unbind(
+    Events::RECORDING_LOADED,
+    &Client::onHistoryRemapped,
+    this
+  );
+  mHistoryRecordCancelled = true;
+  if (mHistoryRecordThread.joinable()) { mHistoryRecordThread.join(); }
+  mReplayCancelled = true;
+  if (mReplayThread.joinable()) { mReplayThread.join(); }
   if (mClient != nullptr) {
     mClient->disconnect();
     mClient->detachObserver(mMqttObserverId);
   }
+  // Closed cleanly, nothing to restore next time.
+  if (mJournal != nullptr) { mJournal->discard(); }
   mAuiMan.UnInit();
 }
 
@@ -331,6 +436,63 @@ void Client::setupPanelHistory(wxWindow *parent) {
     this //
   );
 
+  mHistoryJump = new wxTextCtrl(
+    panel,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxTE_PROCESS_ENTER
+  );
+  mHistoryJump->SetHint("Jump to time...");
+  mHistoryJump->SetToolTip("HH:MM:SS or YYYY-MM-DD HH:MM:SS");
+  mHistoryJump->Bind(wxEVT_TEXT_ENTER, &Client::onHistoryJumpEnter, this);
+
+  mHistoryFrom = new wxTextCtrl(
+    panel,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxTE_PROCESS_ENTER
+  );
+  mHistoryFrom->SetHint("From...");
+  mHistoryFrom->Bind(wxEVT_TEXT_ENTER, &Client::onHistoryWindowEnter, this);
+
+  mHistoryTo = new wxTextCtrl(
+    panel,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxTE_PROCESS_ENTER
+  );
+  mHistoryTo->SetHint("To...");
+  mHistoryTo->Bind(wxEVT_TEXT_ENTER, &Client::onHistoryWindowEnter, this);
+
+  mHistoryColumns = new wxTextCtrl(
+    panel,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxTE_PROCESS_ENTER
+  );
+  mHistoryColumns->SetHint("Columns...");
+  mHistoryColumns->SetToolTip("JSON paths, e.g. $.sensor.temp, $.values[0]");
+  mHistoryColumns->Bind(
+    wxEVT_TEXT_ENTER,
+    &Client::onHistoryColumnsEnter,
+    this
+  );
+
+  mHistoryTimeline = new Widgets::Timeline(panel, -1, mHistoryModel, mDarkMode);
+  mHistoryTimeline->Bind(
+    Events::TIMELINE_SELECTED,
+    &Client::onHistoryTimelineSelected,
+    this
+  );
+
   mAutoScroll = new wxCheckBox(panel, -1, "auto-scroll");
   mAutoScroll->SetValue(true);
 
@@ -357,13 +519,47 @@ void Client::setupPanelHistory(wxWindow *parent) {
   );
   mHistoryRecord->SetToolTip("Store history recording");
   mHistoryRecord->SetBitmap(mArtProvider.bitmap(Icon::Save));
+  if (mHistoryModel->isView()) {
+    // The recording is already on disk and is not loaded.
+    mHistoryRecord->Disable();
+  }
+
+  mHistoryRecordProgress = new wxGauge(
+    panel,
+    -1,
+    RecordProgressRange,
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+  mHistoryRecordProgress->Hide();
+
+  mHistoryRecordCancel = new wxButton(
+    panel,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxSize(mOptionsHeight, mOptionsHeight)
+  );
+  mHistoryRecordCancel->SetToolTip("Cancel storing");
+  mHistoryRecordCancel->SetBitmap(mArtProvider.bitmap(Icon::Cancel));
+  mHistoryRecordCancel->Hide();
 
   auto *topSizer = new wxBoxSizer(wxOrientation::wxHORIZONTAL);
   topSizer->Add(mHistorySearchFilter, 1, wxEXPAND);
   topSizer->Add(mHistorySearchButton, 0, wxEXPAND);
+  auto *timeSizer = new wxBoxSizer(wxOrientation::wxHORIZONTAL);
+  timeSizer->Add(mHistoryJump, 1, wxEXPAND);
+  timeSizer->Add(mHistoryFrom, 1, wxEXPAND);
+  timeSizer->Add(mHistoryTo, 1, wxEXPAND);
+  timeSizer->Add(mHistoryColumns, 1, wxEXPAND);
+  auto *listSizer = new wxBoxSizer(wxOrientation::wxHORIZONTAL);
+  listSizer->Add(mHistoryCtrl, 1, wxEXPAND);
+  listSizer->Add(mHistoryTimeline, 0, wxEXPAND);
   auto *hsizer = new wxBoxSizer(wxOrientation::wxHORIZONTAL);
   hsizer->SetMinSize(0, mOptionsHeight);
   hsizer->Add(mHistoryRecord, 0, wxEXPAND);
+  hsizer->Add(mHistoryRecordProgress, 1, wxEXPAND);
+  hsizer->Add(mHistoryRecordCancel, 0, wxEXPAND);
   hsizer->AddStretchSpacer(1);
   hsizer->Add(mAutoScroll, 0, wxEXPAND);
   hsizer->AddStretchSpacer(1);
@@ -372,7 +568,8 @@ void Client::setupPanelHistory(wxWindow *parent) {
   hsizer->Add(mHistoryClear, 0, wxEXPAND);
   auto *vsizer = new wxBoxSizer(wxOrientation::wxVERTICAL);
   vsizer->Add(topSizer, 0, wxEXPAND);
-  vsizer->Add(mHistoryCtrl, 1, wxEXPAND);
+  vsizer->Add(timeSizer, 0, wxEXPAND);
+  vsizer->Add(listSizer, 1, wxEXPAND);
   vsizer->Add(hsizer, 0, wxEXPAND);
   panel->SetSizer(vsizer);
 
@@ -393,6 +590,26 @@ void Client::setupPanelHistory(wxWindow *parent) {
   );
   mHistoryClear->Bind(wxEVT_BUTTON, &Client::onHistoryClearClicked, this);
   mHistoryRecord->Bind(wxEVT_BUTTON, &Client::onHistoryRecordClicked, this);
+  mHistoryRecordCancel->Bind(
+    wxEVT_BUTTON,
+    &Client::onHistoryRecordCancelClicked,
+    this
+  );
+  Bind(Events::RECORDING_PROGRESS, &Client::onHistoryRecordProgress, this);
+  Bind(Events::RECORDING_STORED, &Client::onHistoryRecordStored, this);
+  if (mHistoryModel->isView()) {
+    // Views never record, so the gauge shows filtering the recording.
+    mHistoryModel->Bind(
+      Events::RECORDING_PROGRESS,
+      &Client::onHistoryRemapProgress,
+      this
+    );
+    mHistoryModel->Bind(
+      Events::RECORDING_LOADED,
+      &Client::onHistoryRemapped,
+      this
+    );
+  }
 
   if (mClient == nullptr) {
     vsizer->Hide(hsizer);
@@ -434,6 +651,39 @@ void Client::setupPanelConnect(wxWindow *parent) {
   );
   mCancel->SetToolTip("Stop connection attempt");
 
+  mReplay = new wxButton(
+    mProfileBar,
+    -1,
+    "Replay",
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+  mReplay->SetToolTip("Publish a recording to the broker");
+  mReplay->SetBitmap(mArtProvider.bitmap(Icon::History));
+  mReplay->Bind(wxEVT_BUTTON, &Client::onReplayClicked, this);
+
+  mReplayProgress = new wxGauge(
+    mProfileBar,
+    -1,
+    RecordProgressRange,
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+
+  mReplayCancel = new wxButton(
+    mProfileBar,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxSize(mOptionsHeight, mOptionsHeight)
+  );
+  mReplayCancel->SetToolTip("Stop replaying");
+  mReplayCancel->SetBitmap(mArtProvider.bitmap(Icon::Cancel));
+  mReplayCancel->Bind(wxEVT_BUTTON, &Client::onReplayCancelClicked, this);
+
+  Bind(Events::RECORDING_REPLAYING, &Client::onReplayProgress, this);
+  Bind(Events::RECORDING_REPLAYED, &Client::onReplayDone, this);
+
   mLayouts = new Widgets::Layouts(
     mProfileBar,
     -1,
@@ -488,8 +738,15 @@ void Client::setupPanelConnect(wxWindow *parent) {
   mProfileSizer->Add(mConnect, 0, wxEXPAND);
   mProfileSizer->Add(mDisconnect, 0, wxEXPAND);
   mProfileSizer->Add(mCancel, 0, wxEXPAND);
+  mProfileSizer->Add(mReplay, 0, wxEXPAND);
+  mProfileSizer->Add(mReplayProgress, 0, wxEXPAND);
+  mProfileSizer->Add(mReplayCancel, 0, wxEXPAND);
+  mProfileSizer->Hide(mReplayProgress);
+  mProfileSizer->Hide(mReplayCancel);
   allowCancel();
 
+  if (mClient == nullptr) { setupPanelPlayback(mProfileBar); }
+
   auto *panelSelector = new wxBoxSizer(wxHORIZONTAL);
   for (auto &pane : mPanes) {
     if (pane.first == Panes::History) { continue; }
@@ -523,6 +780,225 @@ void Client::setupPanelConnect(wxWindow *parent) {
   mCancel->Bind(wxEVT_BUTTON, &Client::onCancelClicked, this);
 }
 
+void Client::setupPanelPlayback(wxWindow *parent) {
+  auto *panel = new wxPanel(parent);
+
+  mPlaybackPlay = new wxButton(
+    panel,
+    -1,
+    "Play",
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+  mPlaybackPlay->SetToolTip("Play the recording at its recorded timing");
+  mPlaybackPlay->SetBitmap(mArtProvider.bitmap(Icon::History));
+
+  mPlaybackStop = new wxButton(
+    panel,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxSize(mOptionsHeight, mOptionsHeight)
+  );
+  mPlaybackStop->SetToolTip("Stop playback and show the whole recording");
+  mPlaybackStop->SetBitmap(mArtProvider.bitmap(Icon::Cancel));
+  mPlaybackStop->Disable();
+
+  wxArrayString speeds;
+  for (const auto speed : PlaybackSpeeds) {
+    const auto utf8 = fmt::format("×{}", speed);
+    speeds.Add(wxString::FromUTF8(utf8.data(), utf8.length()));
+  }
+  mPlaybackSpeed = new wxChoice(
+    panel,
+    -1,
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight),
+    speeds
+  );
+  mPlaybackSpeed->SetSelection(DefaultPlaybackSpeed);
+  mPlaybackSpeed->SetToolTip("Playback speed");
+
+  mPlaybackSeek = new wxSlider(
+    panel,
+    -1,
+    PlaybackSeekRange,
+    0,
+    PlaybackSeekRange,
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+  mPlaybackSeek->SetToolTip("Seek");
+
+  mPlaybackTime = new wxStaticText(panel, -1, "");
+
+  mPlaybackTimer.SetOwner(this);
+
+  auto *sizer = new wxBoxSizer(wxOrientation::wxHORIZONTAL);
+  sizer->Add(mPlaybackPlay, 0, wxEXPAND);
+  sizer->Add(mPlaybackStop, 0, wxEXPAND);
+  sizer->Add(mPlaybackSpeed, 0, wxEXPAND);
+  sizer->Add(mPlaybackSeek, 1, wxEXPAND);
+  sizer->Add(mPlaybackTime, 0, wxALIGN_CENTER_VERTICAL);
+  panel->SetSizer(sizer);
+
+  mPlaybackPlay->Bind(wxEVT_BUTTON, &Client::onPlaybackPlayClicked, this);
+  mPlaybackStop->Bind(wxEVT_BUTTON, &Client::onPlaybackStopClicked, this);
+  mPlaybackSpeed->Bind(
+    wxEVT_CHOICE,
+    &Client::onPlaybackSpeedSelected,
+    this //
+  );
+  mPlaybackSeek->Bind(wxEVT_SLIDER, &Client::onPlaybackSeek, this);
+  Bind(wxEVT_TIMER, &Client::onPlaybackTimer, this, mPlaybackTimer.GetId());
+
+  mProfileSizer->Add(panel, 1, wxEXPAND);
+}
+
+void Client::setupPanelLastValues(wxWindow *parent) {
+  auto *const topic = new wxDataViewColumn(
+    L"topic",
+    new wxDataViewTextRenderer(),
+    static_cast<unsigned>(Models::LastValues::Column::Topic),
+    wxCOL_WIDTH_AUTOSIZE,
+    wxALIGN_LEFT
+  );
+  auto *const payload = new wxDataViewColumn(
+    L"payload",
+    new wxDataViewTextRenderer(),
+    static_cast<unsigned>(Models::LastValues::Column::Payload),
+    wxCOL_WIDTH_DEFAULT,
+    wxALIGN_LEFT
+  );
+
+  auto *panel = new wxPanel(parent);
+  mPanes.at(Panes::LastValues).panel = panel;
+
+  mLastValuesCtrl = new wxDataViewCtrl(
+    panel,
+    -1,
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxDV_NO_HEADER | wxDV_ROW_LINES
+  );
+
+  mLastValuesModel = new Models::LastValues(mHistoryModel);
+  mLastValuesCtrl->AssociateModel(mLastValuesModel.get());
+  mLastValuesCtrl->SetFont(mFont);
+  mLastValuesCtrl->AppendColumn(topic);
+  mLastValuesCtrl->AppendColumn(payload);
+
+  // Indexing a whole recording view is a pass over the file, so views only
+  // show last values once playback starts.
+  if (!mHistoryModel->isView()) {
+    mLastValuesModel->seek(mHistoryModel->getTotal());
+  }
+
+  auto *vsizer = new wxBoxSizer(wxOrientation::wxVERTICAL);
+  vsizer->Add(mLastValuesCtrl, 1, wxEXPAND);
+  panel->SetSizer(vsizer);
+
+  mLastValuesCtrl->Bind(
+    wxEVT_DATAVIEW_SELECTION_CHANGED,
+    &Client::onLastValuesSelected,
+    this
+  );
+}
+
+void Client::setupPanelPlot(wxWindow *parent) {
+  mPanes.at(Panes::Plot).panel = new Widgets::Plot(
+    parent,
+    -1,
+    mHistoryModel,
+    mArtProvider,
+    mOptionsHeight,
+    mDarkMode
+  );
+}
+
+void Client::setupPanelAggregates(wxWindow *parent) {
+  auto *panel = new wxPanel(parent);
+  mPanes.at(Panes::Aggregates).panel = panel;
+
+  mAggregatesPaths = new wxTextCtrl(
+    panel,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxTE_PROCESS_ENTER
+  );
+  mAggregatesPaths->SetHint("JSON paths...");
+  mAggregatesPaths->SetToolTip("e.g. $.sensor.temp, $.values[0]");
+
+  auto *clear = new wxButton(
+    panel,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxSize(mOptionsHeight, mOptionsHeight)
+  );
+  clear->SetToolTip("Clear the statistics");
+  clear->SetBitmap(mArtProvider.bitmap(Icon::Clear));
+
+  mAggregatesCtrl = new wxDataViewCtrl(
+    panel,
+    -1,
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxDV_ROW_LINES
+  );
+
+  mAggregatesModel = new Models::Aggregates(mHistoryModel);
+  mAggregatesCtrl->AssociateModel(mAggregatesModel.get());
+  mAggregatesCtrl->SetFont(mFont);
+
+  using Column = Models::Aggregates::Column;
+  const std::vector<std::pair<Column, const wchar_t *>> columns{
+    {Column::Topic, L"topic"},
+    {Column::Path, L"path"},
+    {Column::Count, L"count"},
+    {Column::Minimum, L"min"},
+    {Column::Maximum, L"max"},
+    {Column::Mean, L"mean"},
+    {Column::Deviation, L"stddev"},
+    {Column::Median, L"p50"},
+    {Column::P90, L"p90"},
+    {Column::P99, L"p99"},
+  };
+  for (const auto &[column, title] : columns) {
+    const auto text = column == Column::Topic || column == Column::Path;
+    mAggregatesCtrl->AppendColumn(new wxDataViewColumn(
+      title,
+      new wxDataViewTextRenderer(),
+      static_cast<unsigned>(column),
+      wxCOL_WIDTH_AUTOSIZE,
+      text ? wxALIGN_LEFT : wxALIGN_RIGHT
+    ));
+  }
+
+  auto *hsizer = new wxBoxSizer(wxOrientation::wxHORIZONTAL);
+  hsizer->Add(mAggregatesPaths, 1, wxEXPAND);
+  hsizer->Add(clear, 0, wxEXPAND);
+
+  auto *vsizer = new wxBoxSizer(wxOrientation::wxVERTICAL);
+  vsizer->Add(hsizer, 0, wxEXPAND);
+  vsizer->Add(mAggregatesCtrl, 1, wxEXPAND);
+  panel->SetSizer(vsizer);
+
+  mAggregatesPaths->Bind(
+    wxEVT_TEXT_ENTER,
+    &Client::onAggregatesPathsEnter,
+    this
+  );
+  clear->Bind(wxEVT_BUTTON, &Client::onAggregatesClearClicked, this);
+  mAggregatesCtrl->Bind(
+    wxEVT_DATAVIEW_COLUMN_HEADER_CLICK,
+    &Client::onAggregatesHeaderClicked,
+    this
+  );
+}
+
 void Client::setupPanelSubscriptions(wxWindow *parent) {
   auto *panel = new wxPanel(parent);
   mPanes.at(Panes::Subscriptions).panel = panel;
@@ -612,6 +1088,7 @@ void Client::setupPanelPreview(wxWindow *parent) {
   );
   mPanes.at(Panes::Preview).panel = panel;
   panel->setReadOnly(true);
+  panel->setPreviewCache(mPreviewCache);
   panel->Bind(Events::EDIT_SAVE_MESSAGE, &Client::onPreviewSaveMessage, this);
 }
 
@@ -624,6 +1101,7 @@ void Client::setupPanelPublish(wxWindow *parent) {
     mDarkMode
   );
   panel->addKnownTopics(mTopicsPublished);
+  panel->setPreviewCache(mPreviewCache);
   mPanes.at(Panes::Publish).panel = panel;
   panel->Bind(Events::EDIT_PUBLISH, &Client::onPublishClicked, this);
   panel->Bind(Events::EDIT_SAVE_MESSAGE, &Client::onPublishSaveMessage, this);
@@ -909,6 +1387,7 @@ void Client::allowConnect() {
   mProfileSizer->Show(mConnect);
   mProfileSizer->Hide(mDisconnect);
   mProfileSizer->Hide(mCancel);
+  mProfileSizer->Hide(mReplay);
   mIndicator->SetBitmap(mArtProvider.bitmap(Icon::Disconnected));
   const uint8_t brightness = mDarkMode ? 150 : 250;
   mIndicator->SetBackgroundColour(wxColor(brightness, 0, 0));
@@ -923,6 +1402,7 @@ void Client::allowDisconnect() {
   mProfileSizer->Hide(mConnect);
   mProfileSizer->Show(mDisconnect);
   mProfileSizer->Hide(mCancel);
+  mProfileSizer->Show(mReplay, !mReplayThread.joinable());
   mIndicator->SetBitmap(mArtProvider.bitmap(Icon::Connected));
   const uint8_t brightness = mDarkMode ? 150 : 250;
   mIndicator->SetBackgroundColour(wxColor(0, brightness, 0));
@@ -937,6 +1417,7 @@ void Client::allowCancel() {
   mProfileSizer->Hide(mConnect);
   mProfileSizer->Hide(mDisconnect);
   mProfileSizer->Show(mCancel);
+  mProfileSizer->Hide(mReplay);
   mIndicator->SetBitmap(mArtProvider.bitmap(Icon::Connecting));
   const uint8_t brightness = mDarkMode ? 150 : 250;
   mIndicator->SetBackgroundColour(wxColor(brightness, brightness, 0));
@@ -947,12 +1428,253 @@ void Client::allowNothing() {
   mProfileSizer->Hide(mConnect);
   mProfileSizer->Hide(mDisconnect);
   mProfileSizer->Hide(mCancel);
+  mProfileSizer->Hide(mReplay);
   mProfileSizer->Hide(mIndicator);
   mProfileSizer->Layout();
 }
 
 // Connection }
 
+// Replay {
+
+void Client::onReplayClicked(wxCommandEvent & /* event */) {
+  if (mClient == nullptr || mReplayThread.joinable()) { return; }
+
+  wxFileDialog openFileDialog(
+    this,
+    _("Replay recording"),
+    "",
+    "",
+    "Recordings (*.tmrc;*.json;*.ndjson;*.jsonl;*.csv)"
+    "|*.tmrc;*.json;*.ndjson;*.jsonl;*.csv",
+    wxFD_OPEN | wxFD_FILE_MUST_EXIST
+  );
+  if (openFileDialog.ShowModal() == wxID_CANCEL) { return; }
+
+  const auto pathUtf8 = openFileDialog.GetPath().ToUTF8();
+  const std::string path(pathUtf8.data(), pathUtf8.length());
+
+  auto reader = Recording::Reader::open(path);
+  if (reader == nullptr) {
+    mLogger->warn("Could not open recording: '{}'", path);
+    return;
+  }
+
+  Widgets::Replay dialog(this, reader->subscriptions(), mOptionsHeight);
+  if (dialog.ShowModal() != wxID_OK) { return; }
+  auto options = dialog.getOptions();
+
+  mLogger->info("Replaying '{}'", path);
+
+  mReplayCancelled = false;
+  mReplayProgress->SetValue(0);
+  mProfileSizer->Hide(mReplay);
+  mProfileSizer->Show(mReplayProgress);
+  mProfileSizer->Show(mReplayCancel);
+  mProfileSizer->Layout();
+
+  mReplayThread = std::thread(
+    [this,
+     path,
+     options = std::move(options),
+     reader = std::move(reader)]() {
+      Recording::Replay replay(mClient, options);
+      const bool succeeded = replay.run(
+        *reader,
+        mReplayCancelled,
+        [this](size_t done, size_t total) {
+          auto *progress = new Events::Recording(Events::RECORDING_REPLAYING);
+          progress->setProgress(done, total);
+          wxQueueEvent(this, progress);
+        }
+      );
+
+      auto *replayed = new Events::Recording(Events::RECORDING_REPLAYED);
+      replayed->setPath(path);
+      replayed->setProgress(replay.stats().published, 0);
+      replayed->setSucceeded(succeeded);
+      wxQueueEvent(this, replayed);
+    }
+  );
+}
+
+void Client::onReplayCancelClicked(wxCommandEvent & /* event */) {
+  mReplayCancelled = true;
+}
+
+void Client::onReplayProgress(Events::Recording &event) {
+  if (event.getTotal() == 0) { return; }
+  const auto ratio = static_cast<double>(event.getDone())
+    / static_cast<double>(event.getTotal());
+  mReplayProgress->SetValue(static_cast<int>(ratio * RecordProgressRange));
+}
+
+void Client::onReplayDone(Events::Recording &event) {
+  if (mReplayThread.joinable()) { mReplayThread.join(); }
+
+  mProfileSizer->Hide(mReplayProgress);
+  mProfileSizer->Hide(mReplayCancel);
+  mProfileSizer->Show(mReplay, mClient->connected());
+  mProfileSizer->Layout();
+
+  if (event.getSucceeded()) {
+    mLogger->info(
+      "Replayed {} messages from '{}'",
+      event.getDone(),
+      event.getPath()
+    );
+  } else if (mReplayCancelled) {
+    mLogger->info("Replaying '{}' cancelled", event.getPath());
+  } else {
+    mLogger->error("Replaying '{}' stopped early", event.getPath());
+  }
+}
+
+// Replay }
+
+// Playback {
+
+void Client::onPlaybackPlayClicked(wxCommandEvent & /* event */) {
+  if (mPlaybackTimer.IsRunning()) {
+    playbackPause();
+    return;
+  }
+
+  const auto range = mHistoryModel->getTimeRange();
+  if (!mPlaybackActive || mPlaybackPosition >= range.second) {
+    mPlaybackPosition = range.first;
+  }
+
+  mPlaybackActive = true;
+  mPlaybackAnchor = mPlaybackPosition;
+  mPlaybackAnchorTime = std::chrono::steady_clock::now();
+  playbackTo(mPlaybackPosition);
+
+  mPlaybackTimer.Start(PlaybackTickMs);
+  mPlaybackPlay->SetLabel("Pause");
+  mPlaybackStop->Enable();
+}
+
+void Client::onPlaybackStopClicked(wxCommandEvent & /* event */) {
+  playbackPause();
+  mPlaybackActive = false;
+  mPlaybackStop->Disable();
+  mPlaybackSeek->SetValue(PlaybackSeekRange);
+  mPlaybackTime->SetLabel("");
+
+  mHistoryModel->clearPlayhead();
+  if (!mHistoryModel->isView()) {
+    mLastValuesModel->seek(mHistoryModel->getTotal());
+  }
+}
+
+void Client::onPlaybackSpeedSelected(wxCommandEvent & /* event */) {
+  // Later positions are scaled from here on.
+  mPlaybackAnchor = mPlaybackPosition;
+  mPlaybackAnchorTime = std::chrono::steady_clock::now();
+}
+
+void Client::onPlaybackSeek(wxCommandEvent & /* event */) {
+  const auto [first, last] = mHistoryModel->getTimeRange();
+  const auto ratio = static_cast<double>(mPlaybackSeek->GetValue())
+    / PlaybackSeekRange;
+  const auto offset = std::chrono::duration_cast<
+    std::chrono::system_clock::duration>((last - first) * ratio);
+
+  mPlaybackActive = true;
+  mPlaybackStop->Enable();
+  mPlaybackAnchor = first + offset;
+  mPlaybackAnchorTime = std::chrono::steady_clock::now();
+  playbackTo(mPlaybackAnchor);
+}
+
+void Client::onPlaybackTimer(wxTimerEvent & /* event */) {
+  // Positions are computed from the anchor instead of accumulated per tick,
+  // so late timer events do not make playback drift.
+  const auto elapsed = std::chrono::steady_clock::now() - mPlaybackAnchorTime;
+  const auto scaled = std::chrono::duration_cast<
+    std::chrono::system_clock::duration>(elapsed * playbackSpeed());
+  playbackTo(mPlaybackAnchor + scaled);
+
+  if (mPlaybackPosition >= mHistoryModel->getTimeRange().second) {
+    playbackPause();
+  }
+}
+
+void Client::playbackTo(std::chrono::system_clock::time_point position) {
+  const auto [first, last] = mHistoryModel->getTimeRange();
+  mPlaybackPosition = std::clamp(position, first, last);
+
+  mHistoryModel->setPlayhead(mPlaybackPosition);
+  mLastValuesModel->seek(mHistoryModel->countUntil(mPlaybackPosition));
+  mHistoryTimeline->setMarker(mPlaybackPosition);
+
+  const auto span = (last - first).count();
+  const auto offset = (mPlaybackPosition - first).count();
+  const auto value = span == 0
+    ? PlaybackSeekRange
+    : static_cast<int>(
+        static_cast<double>(offset) * PlaybackSeekRange
+        / static_cast<double>(span)
+      );
+  mPlaybackSeek->SetValue(value);
+
+  const auto utf8 = Helpers::timeToString(mPlaybackPosition);
+  mPlaybackTime->SetLabel(wxString::FromUTF8(utf8.data(), utf8.length()));
+}
+
+void Client::playbackPause() {
+  mPlaybackTimer.Stop();
+  mPlaybackPlay->SetLabel("Play");
+}
+
+double Client::playbackSpeed() const {
+  const auto selection = mPlaybackSpeed->GetSelection();
+  if (selection == wxNOT_FOUND) { return 1; }
+  return PlaybackSpeeds.at(static_cast<size_t>(selection));
+}
+
+// Playback }
+
+// Last values {
+
+void Client::onAggregatesPathsEnter(wxCommandEvent & /* event */) {
+  const auto utf8 = mAggregatesPaths->GetValue().ToUTF8();
+  const std::string_view text(utf8.data(), utf8.length());
+
+  std::vector<Payload::JsonPath> paths;
+  std::string error;
+  if (!Payload::JsonPath::parseList(text, paths, error)) {
+    mLogger->warn("Could not parse paths '{}': {}", text, error);
+    return;
+  }
+
+  mAggregatesModel->setPaths(std::move(paths));
+}
+
+void Client::onAggregatesClearClicked(wxCommandEvent & /* event */) {
+  mAggregatesModel->clear();
+}
+
+void Client::onAggregatesHeaderClicked(wxDataViewEvent &event) {
+  const auto *column = event.GetDataViewColumn();
+  if (column == nullptr) { return; }
+  mAggregatesModel->sortBy(
+    static_cast<Models::Aggregates::Column>(column->GetModelColumn())
+  );
+}
+
+void Client::onLastValuesSelected(wxDataViewEvent & /* event */) {
+  const auto item = mLastValuesCtrl->GetSelection();
+  if (!item.IsOk()) { return; }
+
+  auto *preview = dynamic_cast<Widgets::Edit *>(mPanes.at(Panes::Preview).panel
+  );
+  preview->setMessage(mLastValuesModel->getMessage(item));
+}
+
+// Last values }
+
 // Context {
 
 void Client::onSubscriptionContext(wxDataViewEvent &event) {
@@ -1466,6 +2188,11 @@ void Client::onConnectionFailure() {
   wxQueueEvent(this, event);
 }
 
+void Client::onMessageArrived(const std::string &topic) {
+  if (!mClientOptions.getLearnTopics()) { return; }
+  mArrivedTopics.add(topic);
+}
+
 void Client::onConnectedSync(Events::Connection &event) {
   (void)event;
   mLogger->info("Connected");
@@ -1490,6 +2217,16 @@ void Client::onConnectionFailureSync(Events::Connection &event) {
   allowConnect();
 }
 
+void Client::onLearnTimer(wxTimerEvent & /* event */) {
+  size_t dropped = 0;
+  const auto counts = mArrivedTopics.take(dropped);
+  if (dropped != 0) {
+    mLogger->warn("Too many new topics, left out {} messages", dropped);
+  }
+  if (counts.empty()) { return; }
+  mTopicsSubscribed->learn(counts);
+}
+
 // MQTT::Client::Observer }
 
 // Models::History::Observer {
@@ -1635,6 +2372,8 @@ void Client::onHistorySelected(wxDataViewEvent &event) {
   auto *edit = dynamic_cast<Widgets::Edit *>(preview);
   const auto message = mHistoryModel->getMessage(item);
   edit->setMessage(message);
+
+  mHistoryTimeline->setMarker(message.timestamp);
 }
 
 void Client::onHistoryClearClicked(wxCommandEvent &event) {
@@ -1646,18 +2385,167 @@ void Client::onHistoryClearClicked(wxCommandEvent &event) {
   preview->clear();
 }
 
-void Client::onHistoryRecordClicked(wxCommandEvent &event) {
-  (void)event;
-  const nlohmann::json contents{
-    {"subscriptions", mSubscriptionsModel->toJson()},
-    {"messages", mHistoryModel->toJson()},
+void Client::onHistoryRecordClicked(wxCommandEvent & /* event */) {
+  const auto nameUtf8 = mName.ToUTF8();
+  const std::string nameStr(nameUtf8.data(), nameUtf8.length());
+  const auto now = std::chrono::system_clock::now();
+  const auto timestamp = Helpers::timeToFilename(now);
+  const auto filename = Url::encode(nameStr) + "-" + timestamp + ".tmrc";
+
+  wxFileDialog saveFileDialog(
+    this,
+    _("Save TMRC file"),
+    "",
+    filename,
+    "TMRC files (*.tmrc)|*.tmrc"
+    "|JSON recordings (*.json)|*.json"
+    "|NDJSON (*.ndjson)|*.ndjson"
+    "|CSV (*.csv)|*.csv",
+    wxFD_SAVE | wxFD_OVERWRITE_PROMPT
+  );
+
+  if (saveFileDialog.ShowModal() == wxID_CANCEL) { return; }
+
+  const auto pathUtf8 = saveFileDialog.GetPath().ToUTF8();
+  std::string path(pathUtf8.data(), pathUtf8.length());
+
+  // Recordings are read back by their extension, so a known one that was
+  // typed picks the format. Otherwise the selected filter does, and its
+  // extension is added.
+  constexpr std::array<std::string_view, 4> Extensions{
+    ".tmrc",
+    ".json",
+    ".ndjson",
+    ".csv",
   };
+  const auto typed = Common::fs::path(path).extension().string();
+  const auto known = std::find(
+    std::begin(Extensions),
+    std::end(Extensions),
+    typed
+  );
+  std::string_view extension;
+  if (known != std::end(Extensions)) {
+    extension = *known;
+  } else {
+    const auto filterIndex = static_cast<size_t>(
+      std::max(saveFileDialog.GetFilterIndex(), 0)
+    );
+    extension = Extensions.at(std::min(filterIndex, Extensions.size() - 1));
+    path.append(extension);
+  }
+
+  const bool encodable = extension == ".ndjson" || extension == ".csv";
+  Widgets::Export dialog(this, encodable, mOptionsHeight);
+  if (dialog.ShowModal() != wxID_OK) { return; }
+  const auto options = dialog.getOptions();
+
+  // The snapshot pins the stored payloads, so messages keep arriving and the
+  // history can even be cleared while the recording is being written.
+  auto subscriptions = mSubscriptionsModel->snapshot();
+  auto snapshot = mHistoryModel->snapshot(options.visibleOnly);
+  mLogger->info(
+    "Storing {} messages in '{}'",
+    snapshot.records.size(),
+    path
+  );
+
+  if (mHistoryRecordThread.joinable()) { mHistoryRecordThread.join(); }
+  mHistoryRecordCancelled = false;
+
+  mHistoryRecord->Disable();
+  mHistoryRecordProgress->SetValue(0);
+  mHistoryRecordProgress->Show();
+  mHistoryRecordCancel->Show();
+  mHistoryRecord->GetParent()->Layout();
+
+  mHistoryRecordThread = std::thread(
+    [this,
+     path,
+     extension,
+     options,
+     subscriptions = std::move(subscriptions),
+     snapshot = std::move(snapshot)]() {
+      auto writer = Recording::Writer::create(
+        path,
+        extension,
+        options.encoding
+      );
+      const auto total = snapshot.records.size();
+
+      bool succeeded = writer->begin(subscriptions);
+      size_t done = 0;
+      for (const auto &record : snapshot.records) {
+        if (!succeeded || mHistoryRecordCancelled) { break; }
+        succeeded = writer->write(record);
+        ++done;
+
+        if (done % RecordProgressInterval == 0) {
+          auto *progress = new Events::Recording(Events::RECORDING_PROGRESS);
+          progress->setProgress(done, total);
+          wxQueueEvent(this, progress);
+        }
+      }
+      succeeded = succeeded && !mHistoryRecordCancelled && writer->end();
+
+      auto *stored = new Events::Recording(Events::RECORDING_STORED);
+      stored->setPath(path);
+      stored->setProgress(done, total);
+      stored->setSucceeded(succeeded);
+      wxQueueEvent(this, stored);
+    }
+  );
+}
+
+void Client::onHistoryRecordCancelClicked(wxCommandEvent & /* event */) {
+  mHistoryRecordCancelled = true;
+}
+
+void Client::onHistoryRecordProgress(Events::Recording &event) {
+  if (event.getTotal() == 0) { return; }
+  const auto ratio = static_cast<double>(event.getDone())
+    / static_cast<double>(event.getTotal());
+  mHistoryRecordProgress->SetValue(
+    static_cast<int>(ratio * RecordProgressRange)
+  );
+}
+
+void Client::onHistoryRemapProgress(Events::Recording &event) {
+  event.Skip();
+  if (!mHistoryRecordProgress->IsShown()) {
+    mHistoryRecordProgress->SetValue(0);
+    mHistoryRecordProgress->Show();
+    mHistoryRecordProgress->GetParent()->Layout();
+  }
+  onHistoryRecordProgress(event);
+}
+
+void Client::onHistoryRemapped(Events::Recording &event) {
+  event.Skip();
+  if (!mHistoryRecordProgress->IsShown()) { return; }
+  mHistoryRecordProgress->Hide();
+  mHistoryRecordProgress->GetParent()->Layout();
+}
 
-  mLogger->info("Queuing up recording event");
-  auto *recording = new Events::Recording(Events::RECORDING_SAVE);
-  recording->setContents(contents.dump());
-  recording->setName(mName);
-  wxQueueEvent(this, recording);
+void Client::onHistoryRecordStored(Events::Recording &event) {
+  if (mHistoryRecordThread.joinable()) { mHistoryRecordThread.join(); }
+
+  mHistoryRecord->Enable();
+  mHistoryRecordProgress->Hide();
+  mHistoryRecordCancel->Hide();
+  mHistoryRecord->GetParent()->Layout();
+
+  if (event.getSucceeded()) {
+    mLogger->info(
+      "Stored {} messages in '{}'",
+      event.getDone(),
+      event.getPath()
+    );
+  } else if (mHistoryRecordCancelled) {
+    mLogger->info("Storing '{}' cancelled", event.getPath());
+  } else {
+    mLogger->error("Could not store recording in '{}'", event.getPath());
+  }
 }
 
 void Client::onHistoryDoubleClicked(wxDataViewEvent &event) {
@@ -1703,6 +2591,107 @@ void Client::onHistorySearchButton(wxCommandEvent &event) {
   mHistoryModel->setFilter(filter);
 }
 
+void Client::onHistoryJumpEnter(wxCommandEvent & /* event */) {
+  const auto text = mHistoryJump->GetValue().ToStdString();
+  const auto [first, last] = mHistoryModel->getTimeRange();
+  const auto timestamp = Helpers::localTimeFromString(text, last);
+  if (!timestamp.has_value()) {
+    mLogger->warn("Could not parse time: '{}'", text);
+    return;
+  }
+  historyJumpTo(*timestamp);
+}
+
+void Client::onHistoryWindowEnter(wxCommandEvent & /* event */) {
+  using Timestamp = Models::History::Timestamp;
+
+  const auto [first, last] = mHistoryModel->getTimeRange();
+  const auto fromText = mHistoryFrom->GetValue().ToStdString();
+  const auto toText = mHistoryTo->GetValue().ToStdString();
+
+  auto from = Timestamp::min();
+  if (!fromText.empty()) {
+    const auto parsed = Helpers::localTimeFromString(fromText, first);
+    if (!parsed.has_value()) {
+      mLogger->warn("Could not parse time: '{}'", fromText);
+      return;
+    }
+    from = *parsed;
+  }
+
+  auto to = Timestamp::max();
+  if (!toText.empty()) {
+    const auto parsed = Helpers::localTimeFromString(toText, last);
+    if (!parsed.has_value()) {
+      mLogger->warn("Could not parse time: '{}'", toText);
+      return;
+    }
+    // Whole seconds are typed, include the entire last second.
+    to = *parsed + std::chrono::seconds(1) - Timestamp::duration(1);
+  }
+
+  mHistoryModel->setTimeWindow(from, to);
+}
+
+void Client::onHistoryColumnsEnter(wxCommandEvent & /* event */) {
+  const auto utf8 = mHistoryColumns->GetValue().ToUTF8();
+  const std::string_view text(utf8.data(), utf8.length());
+
+  std::vector<Payload::JsonPath> paths;
+  std::string error;
+  if (!Payload::JsonPath::parseList(text, paths, error)) {
+    mLogger->warn("Could not parse paths '{}': {}", text, error);
+    return;
+  }
+
+  for (auto *column : mHistoryPathColumns) {
+    mHistoryCtrl->DeleteColumn(column);
+  }
+  mHistoryPathColumns.clear();
+
+  constexpr auto PathsBegin = static_cast<size_t>(
+    Models::History::Column::Max
+  );
+  for (size_t i = 0; i != paths.size(); ++i) {
+    auto *renderer = new wxDataViewTextRenderer();
+    renderer->EnableMarkup();
+    const auto &expression = paths[i].expression();
+    auto *const column = new wxDataViewColumn(
+      wxString::FromUTF8(expression.data(), expression.length()),
+      renderer,
+      static_cast<unsigned>(PathsBegin + i),
+      wxCOL_WIDTH_DEFAULT,
+      wxALIGN_LEFT
+    );
+    mHistoryPathColumns.push_back(column);
+  }
+
+  mHistoryModel->setPathColumns(std::move(paths));
+  for (auto *column : mHistoryPathColumns) {
+    mHistoryCtrl->AppendColumn(column);
+  }
+  mHistoryCtrl->Refresh();
+}
+
+void Client::onHistoryTimelineSelected(Events::Timeline &event) {
+  historyJumpTo(event.getTimestamp());
+}
+
+void Client::historyJumpTo(std::chrono::system_clock::time_point timestamp) {
+  const auto item = mHistoryModel->findByTime(timestamp);
+  if (!item.IsOk()) { return; }
+
+  mAutoScroll->SetValue(false);
+  mHistoryCtrl->Select(item);
+  mHistoryCtrl->EnsureVisible(item);
+  mHistoryModel->setSelected(item);
+  mHistoryTimeline->setMarker(mHistoryModel->getTimestamp(item));
+
+  auto *preview = dynamic_cast<Widgets::Edit *>(mPanes.at(Panes::Preview).panel
+  );
+  preview->setMessage(mHistoryModel->getMessage(item));
+}
+
 void Client::onHistoryShowDtChanged(wxCommandEvent &event){
   (void)event;
   mHistoryModel->showDt(mShowDt->GetValue());
@@ -1,28 +1,43 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
 #include <random>
+#include <thread>
 
 #include <spdlog/spdlog.h>
 #include <wx/aui/aui.h>
+#include <wx/choice.h>
 #include <wx/combobox.h>
 #include <wx/event.h>
 #include <wx/listctrl.h>
+#include <wx/slider.h>
 #include <wx/splitter.h>
 #include <wx/tglbtn.h>
+#include <wx/timer.h>
 
 #include "GUI/ArtProvider.hpp"
 #include "GUI/Events/Connection.hpp"
 #include "GUI/Events/Edit.hpp"
 #include "GUI/Events/Layout.hpp"
+#include "GUI/Events/Recording.hpp"
+#include "GUI/Events/Timeline.hpp"
+#include "GUI/Models/Aggregates.hpp"
 #include "GUI/Models/History.hpp"
 #include "GUI/Models/KnownTopics.hpp"
+#include "GUI/Models/LastValues.hpp"
 #include "GUI/Models/Layouts.hpp"
 #include "GUI/Models/Messages.hpp"
 #include "GUI/Models/Subscriptions.hpp"
 #include "GUI/Types/ClientOptions.hpp"
 #include "GUI/Widgets/Layouts.hpp"
+#include "GUI/Widgets/Plot.hpp"
+#include "GUI/Widgets/PreviewCache.hpp"
+#include "GUI/Widgets/Timeline.hpp"
 #include "GUI/Widgets/TopicCtrl.hpp"
 #include "MQTT/Client.hpp"
+#include "MQTT/TopicCounter.hpp"
+#include "Recording/Journal.hpp"
 
 namespace Rapatas::Transmitron::GUI::Tabs {
 
@@ -37,6 +52,7 @@ public:
     wxWindow *parent,
     const MQTT::BrokerOptions &brokerOptions,
     Types::ClientOptions clientOptions,
+    const std::string &journalPath,
     const wxObjectDataPtr<Models::Messages> &messages,
     const wxObjectDataPtr<Models::KnownTopics> &topicsSubscribed,
     const wxObjectDataPtr<Models::KnownTopics> &topicsPublished,
@@ -95,6 +111,9 @@ private:
     Messages = 2,
     Publish = 3,
     Preview = 4,
+    LastValues = 5,
+    Plot = 6,
+    Aggregates = 7,
   };
 
   struct Pane {
@@ -130,6 +149,11 @@ private:
   wxButton *mDisconnect = nullptr;
   wxButton *mCancel = nullptr;
   wxStaticBitmap *mIndicator = nullptr;
+  wxButton *mReplay = nullptr;
+  wxButton *mReplayCancel = nullptr;
+  wxGauge *mReplayProgress = nullptr;
+  std::thread mReplayThread;
+  std::atomic<bool> mReplayCancelled = false;
 
   // History:
   wxObjectDataPtr<Models::History> mHistoryModel;
@@ -138,8 +162,39 @@ private:
   wxCheckBox *mShowDt = nullptr;
   wxButton *mHistoryClear = nullptr;
   wxButton *mHistoryRecord = nullptr;
+  wxButton *mHistoryRecordCancel = nullptr;
+  wxGauge *mHistoryRecordProgress = nullptr;
+  std::thread mHistoryRecordThread;
+  std::atomic<bool> mHistoryRecordCancelled = false;
   Widgets::TopicCtrl *mHistorySearchFilter = nullptr;
   wxButton *mHistorySearchButton = nullptr;
+  wxTextCtrl *mHistoryJump = nullptr;
+  wxTextCtrl *mHistoryFrom = nullptr;
+  wxTextCtrl *mHistoryTo = nullptr;
+  wxTextCtrl *mHistoryColumns = nullptr;
+  std::vector<wxDataViewColumn *> mHistoryPathColumns;
+  Widgets::Timeline *mHistoryTimeline = nullptr;
+
+  // Playback:
+  wxButton *mPlaybackPlay = nullptr;
+  wxButton *mPlaybackStop = nullptr;
+  wxChoice *mPlaybackSpeed = nullptr;
+  wxSlider *mPlaybackSeek = nullptr;
+  wxStaticText *mPlaybackTime = nullptr;
+  wxTimer mPlaybackTimer;
+  bool mPlaybackActive = false;
+  std::chrono::system_clock::time_point mPlaybackPosition;
+  std::chrono::system_clock::time_point mPlaybackAnchor;
+  std::chrono::steady_clock::time_point mPlaybackAnchorTime;
+
+  // Last values:
+  wxObjectDataPtr<Models::LastValues> mLastValuesModel;
+  wxDataViewCtrl *mLastValuesCtrl = nullptr;
+
+  // Aggregates:
+  wxObjectDataPtr<Models::Aggregates> mAggregatesModel;
+  wxDataViewCtrl *mAggregatesCtrl = nullptr;
+  wxTextCtrl *mAggregatesPaths = nullptr;
 
   // Subscriptions:
   wxButton *mSubscribe = nullptr;
@@ -157,6 +212,13 @@ private:
 
   std::shared_ptr<MQTT::Client> mClient;
   size_t mMqttObserverId = 0;
+  std::shared_ptr<Recording::Journal> mJournal;
+  // Topics of arriving messages, for the subscribed known topics.
+  MQTT::TopicCounter mArrivedTopics;
+  wxTimer mLearnTimer;
+  // Shared by the preview and publish panes.
+  std::shared_ptr<Widgets::PreviewCache> mPreviewCache =
+    std::make_shared<Widgets::PreviewCache>();
 
   void onClose(wxCloseEvent &event);
 
@@ -169,6 +231,30 @@ private:
   void onConnectClicked(wxCommandEvent &event);
   void onDisconnectClicked(wxCommandEvent &event);
 
+  // Replay.
+  void onReplayClicked(wxCommandEvent &event);
+  void onReplayCancelClicked(wxCommandEvent &event);
+  void onReplayProgress(Events::Recording &event);
+  void onReplayDone(Events::Recording &event);
+
+  // Playback.
+  void onPlaybackPlayClicked(wxCommandEvent &event);
+  void onPlaybackStopClicked(wxCommandEvent &event);
+  void onPlaybackSpeedSelected(wxCommandEvent &event);
+  void onPlaybackSeek(wxCommandEvent &event);
+  void onPlaybackTimer(wxTimerEvent &event);
+  void playbackTo(std::chrono::system_clock::time_point position);
+  void playbackPause();
+  [[nodiscard]] double playbackSpeed() const;
+
+  // Last values.
+  void onLastValuesSelected(wxDataViewEvent &event);
+
+  // Aggregates.
+  void onAggregatesPathsEnter(wxCommandEvent &event);
+  void onAggregatesClearClicked(wxCommandEvent &event);
+  void onAggregatesHeaderClicked(wxDataViewEvent &event);
+
   // Context.
   void onContextSelected(wxCommandEvent &event);
   void onContextSelectedHistoryEdit(wxCommandEvent &event);
@@ -196,11 +282,21 @@ private:
   // History.
   void onHistoryClearClicked(wxCommandEvent &event);
   void onHistoryRecordClicked(wxCommandEvent &event);
+  void onHistoryRecordCancelClicked(wxCommandEvent &event);
+  void onHistoryRecordProgress(Events::Recording &event);
+  void onHistoryRecordStored(Events::Recording &event);
+  void onHistoryRemapProgress(Events::Recording &event);
+  void onHistoryRemapped(Events::Recording &event);
   void onHistorySelected(wxDataViewEvent &event);
   void onHistoryDoubleClicked(wxDataViewEvent &event);
   void onHistorySearchKey(wxKeyEvent &event);
   void onHistorySearchButton(wxCommandEvent &event);
   void onHistoryShowDtChanged(wxCommandEvent &event);
+  void onHistoryJumpEnter(wxCommandEvent &event);
+  void onHistoryWindowEnter(wxCommandEvent &event);
+  void onHistoryColumnsEnter(wxCommandEvent &event);
+  void onHistoryTimelineSelected(Events::Timeline &event);
+  void historyJumpTo(std::chrono::system_clock::time_point timestamp);
 
   // Preview.
   void onPreviewSaveMessage(Events::Edit &event);
@@ -211,8 +307,12 @@ private:
 
   // Setup.
   void setupPanels();
+  void setupPanelAggregates(wxWindow *parent);
   void setupPanelConnect(wxWindow *parent);
   void setupPanelHistory(wxWindow *parent);
+  void setupPanelLastValues(wxWindow *parent);
+  void setupPanelPlot(wxWindow *parent);
+  void setupPanelPlayback(wxWindow *parent);
   void setupPanelPreview(wxWindow *parent);
   void setupPanelPublish(wxWindow *parent);
   void setupPanelMessages(wxWindow *parent);
@@ -241,11 +341,13 @@ private:
   void onDisconnected() override;
   void onConnectionLost() override;
   void onConnectionFailure() override;
+  void onMessageArrived(const std::string &topic) override;
 
   // MQTT::Client::Observer on GUI thread.
   void onConnectedSync(Events::Connection &event);
   void onDisconnectedSync(Events::Connection &event);
   void onConnectionLostSync(Events::Connection &event);
+  void onLearnTimer(wxTimerEvent &event);
   void onConnectionFailureSync(Events::Connection &event);
 
   // Models::History::Observer interface.
@@ -268,9 +268,25 @@ void Homepage::setupRecordings(wxPanel *parent) {
   recordingOpen->Bind(wxEVT_BUTTON, &Homepage::onRecordingOpen, this);
   recordingOpen->SetBitmap(mArtProvider.bitmap(Icon::History));
 
+  auto *recordingView = new wxButton(
+    mRecordings,
+    -1,
+    "Open as view...",
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+  recordingView->SetToolTip(
+    "Browse a large recording in place without loading it into memory"
+  );
+  recordingView->Bind(wxEVT_BUTTON, &Homepage::onRecordingView, this);
+
+  auto *hsizer = new wxBoxSizer(wxHORIZONTAL);
+  hsizer->Add(recordingOpen, 0);
+  hsizer->Add(recordingView, 0);
+
   auto *vsizer = new wxBoxSizer(wxVERTICAL);
   vsizer->Add(label, 0, wxEXPAND);
-  vsizer->Add(recordingOpen, 0);
+  vsizer->Add(hsizer, 0);
   mRecordings->SetSizer(vsizer);
 }
 
@@ -301,6 +317,13 @@ void Homepage::onRecordingOpen(wxCommandEvent &event) {
   event.Skip();
 }
 
+void Homepage::onRecordingView(wxCommandEvent &event) {
+  auto *recordingEvent = new Events::Recording(RECORDING_OPEN);
+  recordingEvent->setAsView(true);
+  wxQueueEvent(this, recordingEvent);
+  event.Skip();
+}
+
 void Homepage::onConnectClicked(wxCommandEvent & /* event */) {
   const auto item = mProfilesCtrl->GetSelection();
   if (!item.IsOk()) { return; }
@@ -66,6 +66,7 @@ private:
 
   void onCancelClicked(wxCommandEvent &event);
   void onRecordingOpen(wxCommandEvent &event);
+  void onRecordingView(wxCommandEvent &event);
 
   void onConnectClicked(wxCommandEvent &event);
   void onContextSelected(wxCommandEvent &event);
@@ -374,6 +374,18 @@ void Settings::setupProfileOptions(wxPanel *parent) {
   const auto layoutLabels = mLayoutsModel->getLabelArray();
   auto *layoutPtr = new wxEnumProperty("Layout", "", layoutLabels);
   pfp.at(Properties::Layout) = pfg->AppendIn(mGridCategoryClient, layoutPtr);
+  pfp.at(Properties::Journal) = pfg->AppendIn(
+    mGridCategoryClient,
+    new wxBoolProperty("Session Journal", "", {})
+  );
+  pfp.at(Properties::Journal)
+    ->SetHelpString("Keep the history on disk to restore it after a crash");
+  pfp.at(Properties::LearnTopics) = pfg->AppendIn(
+    mGridCategoryClient,
+    new wxBoolProperty("Learn Topics", "", {})
+  );
+  pfp.at(Properties::LearnTopics)
+    ->SetHelpString("Suggest the topics of received messages when subscribing");
 
   mProfileGrid->Bind(wxEVT_PG_CHANGED, &Settings::onProfileGridChanged, this);
   mProfileGrid->Bind(wxEVT_PG_CHANGING, &Settings::onProfileGridChanged, this);
@@ -822,6 +834,8 @@ void Settings::propertyGridClear() {
   pfp.at(Properties::SSL)->SetValue({});
   pfp.at(Properties::Username)->SetValue({});
   pfp.at(Properties::Layout)->SetValue({});
+  pfp.at(Properties::Journal)->SetValue({});
+  pfp.at(Properties::LearnTopics)->SetValue({});
 }
 
 void Settings::propertyGridFill(
@@ -857,6 +871,8 @@ void Settings::propertyGridFill(
     clientOptions.getLayout()
   );
   if (hasValue) { pfpLayout->SetValue(layoutValue); }
+  pfp.at(Properties::Journal)->SetValue(clientOptions.getJournal());
+  pfp.at(Properties::LearnTopics)->SetValue(clientOptions.getLearnTopics());
 
   mSave->Enable(true);
   mConnect->Enable(true);
@@ -914,9 +930,14 @@ Types::ClientOptions Settings::clientOptionsFromPropertyGrid() const {
   const auto layoutValue = pfpLayout->GetValue();
   const auto layoutIndex = static_cast<size_t>(layoutValue.GetInteger());
   const auto layout = mLayoutsModel->getLabelArray()[layoutIndex];
+  const auto journal = pfp.at(Properties::Journal)->GetValue().GetBool();
+  const auto learnTopics =
+    pfp.at(Properties::LearnTopics)->GetValue().GetBool();
 
   return Types::ClientOptions{
     layout.ToStdString(),
+    journal,
+    learnTopics,
   };
 }
 
@@ -955,7 +976,7 @@ void Settings::onLayoutChanged(Events::Layout & /* event */) {
 
   const auto layoutLabels = mLayoutsModel->getLabelArray();
   auto *layoutPtr = new wxEnumProperty("Layout", "", layoutLabels);
-  pfpLayout = pfg->AppendIn(mGridCategoryClient, layoutPtr);
+  pfpLayout = pfg->Insert(mGridCategoryClient, 0, layoutPtr);
 
   pfpLayout->SetValue(layoutValue);
 }
@@ -980,7 +1001,7 @@ void Settings::refreshLayouts() {
   pfg->RemoveProperty(pfpLayout);
 
   auto *layoutPtr = new wxEnumProperty("Layout", "", layoutLabels);
-  pfpLayout = pfg->AppendIn(mGridCategoryClient, layoutPtr);
+  pfpLayout = pfg->Insert(mGridCategoryClient, 0, layoutPtr);
 
   if (selectedValue) {
     wxVariant newLayoutValue;
@@ -55,6 +55,8 @@ private:
     SSL,
     Username,
     Layout,
+    Journal,
+    LearnTopics,
     Max,
   };
 
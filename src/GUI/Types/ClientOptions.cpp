@@ -6,8 +6,14 @@
 using namespace Rapatas::Transmitron;
 using namespace GUI::Types;
 
-ClientOptions::ClientOptions(std::string layout) :
-  mLayout(std::move(layout)) //
+ClientOptions::ClientOptions(
+  std::string layout,
+  bool journal,
+  bool learnTopics
+) :
+  mLayout(std::move(layout)),
+  mJournal(journal),
+  mLearnTopics(learnTopics) //
 {}
 
 ClientOptions ClientOptions::fromJson(const nlohmann::json &data) {
@@ -18,9 +24,23 @@ ClientOptions ClientOptions::fromJson(const nlohmann::json &data) {
     std::string(Models::Layouts::DefaultName)
   );
 
-  return ClientOptions{layout};
+  const auto journal = extract<bool>(data, "journal").value_or(false);
+  const auto learnTopics =
+    extract<bool>(data, "learnTopics").value_or(false);
+
+  return ClientOptions{layout, journal, learnTopics};
 }
 
-nlohmann::json ClientOptions::toJson() const { return {{"layout", mLayout}}; }
+nlohmann::json ClientOptions::toJson() const {
+  return {
+    {"layout", mLayout},
+    {"journal", mJournal},
+    {"learnTopics", mLearnTopics},
+  };
+}
 
 std::string ClientOptions::getLayout() const { return mLayout; }
+
+bool ClientOptions::getJournal() const { return mJournal; }
+
+bool ClientOptions::getLearnTopics() const { return mLearnTopics; }
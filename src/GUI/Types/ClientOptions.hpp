@@ -13,16 +13,24 @@ class ClientOptions
 public:
 
   explicit ClientOptions() = default;
-  explicit ClientOptions(std::string layout);
+  explicit ClientOptions(
+    std::string layout,
+    bool journal = false,
+    bool learnTopics = false
+  );
 
   static ClientOptions fromJson(const nlohmann::json &data);
   [[nodiscard]] nlohmann::json toJson() const;
 
   [[nodiscard]] std::string getLayout() const;
+  [[nodiscard]] bool getJournal() const;
+  [[nodiscard]] bool getLearnTopics() const;
 
 private:
 
   std::string mLayout{Models::Layouts::DefaultName};
+  bool mJournal = false;
+  bool mLearnTopics = false;
 };
 
 } // namespace Rapatas::Transmitron::GUI::Types
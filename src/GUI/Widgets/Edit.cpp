@@ -3,9 +3,8 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
-#include <tinyxml2.h>
 
-#include <nlohmann/json.hpp>
+#include <fmt/format.h>
 #include <wx/clipbrd.h>
 #include <wx/sizer.h>
 #include <wx/stc/stc.h>
@@ -18,18 +17,73 @@
 #include "GUI/Resources/qos/qos-0.hpp"
 #include "GUI/Resources/qos/qos-1.hpp"
 #include "GUI/Resources/qos/qos-2.hpp"
+#include "Payload/Cbor.hpp"
+#include "Payload/Json.hpp"
+#include "Payload/MessagePack.hpp"
+#include "Payload/Sniffer.hpp"
+#include "Payload/Xml.hpp"
+#include "PreviewCache.hpp"
 
 #define SSF StyleSetForeground
 #define SSB StyleSetBackground
 
 using namespace Rapatas::Transmitron;
-using namespace nlohmann;
 using namespace GUI;
 using namespace Common;
 using namespace GUI::Widgets;
 
 constexpr size_t BinaryFormatWidth = 10;
 constexpr uint8_t ByteSize = std::numeric_limits<uint8_t>::digits;
+// Below this the payload is formatted right away, a worker is not worth it.
+constexpr size_t InlineFormatLimit = 64 * 1024;
+// Above this formatting only happens when the user asks for it.
+constexpr size_t AutoFormatLimit = 2 * 1024 * 1024;
+constexpr size_t MaxKnownKinds = 4096;
+// Below this formatting costs less than keeping the result.
+constexpr size_t MinCachedSize = 4 * 1024;
+// Text is loaded in the editor by pages of this size.
+constexpr size_t PageSize = 256 * 1024;
+// Above this the text is neither highlighted nor folded.
+constexpr size_t PlainLimit = 1024 * 1024;
+// A line this long turns wrapping off, Scintilla lays it out as a whole.
+constexpr size_t LongLineLimit = 16 * 1024;
+constexpr size_t KiB = 1024;
+
+namespace {
+
+bool hasLongLine(std::string_view text) {
+  size_t begin = 0;
+  while (text.size() - begin > LongLineLimit) {
+    const auto newline = text.find('\n', begin);
+    if (newline == std::string_view::npos || newline - begin > LongLineLimit) {
+      return true;
+    }
+    begin = newline + 1;
+  }
+  return false;
+}
+
+// A page ends after a line when there is one in its second half, otherwise
+// where a UTF-8 sequence starts.
+size_t pageEnd(std::string_view text, size_t begin, size_t size) {
+  constexpr uint8_t ContinuationMask = 0xC0;
+  constexpr uint8_t Continuation = 0x80;
+
+  if (text.size() - begin <= size) { return text.size(); }
+  auto end = begin + size;
+  const auto newline = text.rfind('\n', end - 1);
+  if (newline != std::string_view::npos && newline >= begin + size / 2) {
+    return newline + 1;
+  }
+  while (end > begin
+         && (static_cast<uint8_t>(text[end]) & ContinuationMask)
+           == Continuation) {
+    --end;
+  }
+  return end;
+}
+
+} // namespace
 
 Edit::Edit(
   wxWindow *parent,
@@ -74,6 +128,17 @@ Edit::Edit(
 
   setupScintilla();
 
+  const auto &normal = styles().at(mTheme).at(Style::Normal);
+  mHexView = new HexView(
+    this,
+    -1,
+    BinaryFormatWidth,
+    mFont,
+    wxColour(normal.first),
+    wxColour(styles().at(mTheme).at(Style::Editor).second)
+  );
+  mHexView->Hide();
+
   mSaveMessage = new wxButton(
     this,
     -1,
@@ -130,7 +195,47 @@ Edit::Edit(
   mQos1->Hide();
   mQos2->Hide();
 
+  mFormatLarge = new wxButton(
+    this,
+    -1,
+    "Format",
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+  mFormatLarge->SetToolTip("The payload is large, format it anyway");
+  mFormatLarge->Bind(wxEVT_BUTTON, [this](wxCommandEvent & /* event */) {
+    format();
+  });
+  mFormatLarge->Hide();
+
+  mLoadMore = new wxButton(
+    this,
+    -1,
+    "Load more",
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+  mLoadMore->Bind(wxEVT_BUTTON, [this](wxCommandEvent & /* event */) {
+    loadMore(PageSize);
+  });
+  mLoadMore->Hide();
+
+  mShowAll = new wxButton(
+    this,
+    -1,
+    "Show all",
+    wxDefaultPosition,
+    wxSize(-1, mOptionsHeight)
+  );
+  mShowAll->SetToolTip("Load the full payload in the editor");
+  mShowAll->Bind(wxEVT_BUTTON, [this](wxCommandEvent & /* event */) {
+    loadMore(mFullText.size());
+  });
+  mShowAll->Hide();
+
   mFormatSelect->Bind(wxEVT_COMBOBOX, &Edit::onFormatSelected, this);
+  mText->Bind(wxEVT_STC_MODIFIED, &Edit::onTextModified, this);
+  Bind(Events::EDIT_FORMATTED, &Edit::onFormatted, this);
 
   mTop->Add(mTopic, 1, wxEXPAND);
   mTop->AddSpacer(2);
@@ -144,6 +249,9 @@ Edit::Edit(
   mTop->Add(mPublish, 0, wxEXPAND);
   mBottom->Add(mSaveMessage, 0, wxEXPAND);
   mBottom->AddStretchSpacer(1);
+  mBottom->Add(mLoadMore, 0, wxEXPAND);
+  mBottom->Add(mShowAll, 0, wxEXPAND);
+  mBottom->Add(mFormatLarge, 0, wxEXPAND);
   mBottom->Add(formatLabel, 0, wxALIGN_CENTER_VERTICAL);
   mBottom->Add(mFormatSelect, 0, wxEXPAND);
   mVsizer->Add(mTop, 0, wxEXPAND);
@@ -154,11 +262,22 @@ Edit::Edit(
     timestampBorderPx
   );
   mVsizer->Add(mText, 1, wxEXPAND);
+  mVsizer->Add(mHexView, 1, wxEXPAND);
   mVsizer->Add(mBottom, 0, wxEXPAND);
 
   SetSizer(mVsizer);
 }
 
+Edit::~Edit() {
+  ++mGeneration;
+  {
+    std::lock_guard lock(mFormatMutex);
+    mFormatStopping = true;
+  }
+  mFormatWake.notify_one();
+  if (mFormatThread.joinable()) { mFormatThread.join(); }
+}
+
 void Edit::setupScintilla() {
   mText = new wxStyledTextCtrl(this, wxID_ANY, wxDefaultPosition);
 
@@ -207,8 +326,9 @@ void Edit::setStyle(Format format) {
   const auto &style = styles().at(mTheme);
 
   switch (format) {
-    case Format::Json: {
-      mText->SetLexer(wxSTC_LEX_JSON);
+    case Format::Json:
+    case Format::MessagePack:
+    case Format::Cbor: {
       mText->SetKeyWords(0, "true false null");
 
       mText->SSF(wxSTC_JSON_OPERATOR, style.at(Style::Normal).first);
@@ -229,8 +349,6 @@ void Edit::setStyle(Format format) {
     } break;
 
     case Format::Xml: {
-      mText->SetLexer(wxSTC_LEX_XML);
-
       mText->SSF(wxSTC_H_ATTRIBUTE, style.at(Style::Key).first);
       mText->SSF(wxSTC_H_ATTRIBUTEUNKNOWN, style.at(Style::Error).first);
       mText->SSF(wxSTC_H_COMMENT, style.at(Style::Comment).first);
@@ -260,9 +378,7 @@ void Edit::setStyle(Format format) {
 
     case Format::Binary:
     case Format::Text:
-    default: {
-      mText->SetLexer(wxSTC_LEX_NULL);
-    } break;
+    default: break;
   }
 
   // Setup folding.
@@ -275,22 +391,16 @@ void Edit::setStyle(Format format) {
 
 void Edit::setMessage(const MQTT::Message &message) {
   setTopic(message.topic);
-  setPayload(message.payload);
+  mPayload = message.payload;
+  showPayload(message.payload, false, message.topic);
   setQos(message.qos);
   setRetained(message.retained);
   setTimestamp(message.timestamp);
 }
 
 void Edit::setPayload(const std::string &text) {
-  auto format = mFormatSelect->GetValue().ToStdString();
-  if (mReadOnly || mCurrentFormat == Format::Binary) {
-    mText->SetReadOnly(false);
-  }
-  auto payloadUtf8 = formatTry(text, formats().at(format));
-  mText->SetText(wxString::FromUTF8(payloadUtf8.data(), payloadUtf8.length()));
-  if (mReadOnly || mCurrentFormat == Format::Binary) {
-    mText->SetReadOnly(true);
-  }
+  mPayload = text;
+  showPayload(text, false);
 }
 
 void Edit::setTimestamp(const std::chrono::system_clock::time_point &timestamp
@@ -306,7 +416,7 @@ void Edit::setInfoLine(const std::string &info) {
 void Edit::setReadOnly(bool readonly) {
   mReadOnly = readonly;
 
-  mText->SetReadOnly(readonly);
+  lockText();
   mTopic->setReadOnly(readonly);
 
   mPublish->Show(!readonly);
@@ -319,12 +429,16 @@ void Edit::addKnownTopics(
   mTopic->addKnownTopics(knownTopicsModel);
 }
 
+void Edit::setPreviewCache(std::shared_ptr<PreviewCache> previews) {
+  mPreviews = std::move(previews);
+}
+
 MQTT::Message Edit::getMessage() const {
   return {getTopic(), getPayload(), mQoS, mRetained, {}};
 }
 
 std::string Edit::getPayload() const {
-  if (mCurrentFormat == Format::Binary) { return mPayload; }
+  if (isDecoded(mCurrentFormat) || isTruncated()) { return mPayload; }
 
   const auto wxs = mText->GetValue();
   const auto utf8 = wxs.ToUTF8();
@@ -334,82 +448,335 @@ std::string Edit::getPayload() const {
 bool Edit::getReadOnly() const { return mReadOnly; }
 
 void Edit::format() {
-  const auto text = getPayload();
+  if (!isDecoded(mCurrentFormat)) { mPayload = getPayload(); }
+  showPayload(mPayload, true);
+}
 
-  if (mCurrentFormat != Format::Binary) { mPayload = getPayload(); }
+void Edit::showPayload(
+  const std::string &text,
+  bool force,
+  std::string_view topic
+) {
+  const size_t generation = ++mGeneration;
 
-  auto format = mFormatSelect->GetValue().ToStdString();
-  if (mReadOnly || mCurrentFormat == Format::Binary) {
-    mText->SetReadOnly(false);
+  if (mFormatLarge->IsShown()) {
+    mFormatLarge->Hide();
+    mBottom->Layout();
   }
-  auto payloadUtf8 = formatTry(text, formats().at(format));
-  mText->SetText(wxString::FromUTF8(payloadUtf8.data(), payloadUtf8.length()));
 
-  if (mReadOnly || mCurrentFormat == Format::Binary) {
-    mText->SetReadOnly(true);
+  if (text.empty()) {
+    showHexView(false);
+    setText("", mCurrentFormat);
+    return;
   }
-}
 
-std::string Edit::formatTry(const std::string &text, Format format) {
-  if (text.empty()) { return ""; }
+  const auto selected = selectedFormat();
+  const auto format = selected == Format::Auto ? formatGuess(text, topic)
+                                               : selected;
+
+  // Large binaries are dumped only as far as they are scrolled into view.
+  const bool virtualized = format == Format::Binary
+    && text.size() > InlineFormatLimit;
+  showHexView(virtualized);
+  if (virtualized) {
+    setText("", format);
+    mHexView->setData(text);
+    return;
+  }
+
+  const bool cached = mPreviews != nullptr && format != Format::Text
+    && text.size() >= MinCachedSize;
+  if (cached) {
+    if (const auto *preview = mPreviews->find(format, text)) {
+      setText(preview->text, preview->format);
+      return;
+    }
+  }
 
-  if (format == Format::Auto) { return formatTry(text, formatGuess(text)); }
+  if (format == Format::Text || text.size() <= InlineFormatLimit) {
+    std::string error;
+    auto formatted = formatTry(text, format, {}, error);
+    if (!error.empty()) {
+      mLogger->debug("Not formatted: {}", error);
+    } else if (cached) {
+      mPreviews->insert(format, text, {formatted, format});
+    }
+    setText(std::move(formatted), format);
+    return;
+  }
+
+  // The raw payload is shown until the formatted one is ready.
+  setText(text, format);
+
+  if (!force && text.size() > AutoFormatLimit) {
+    mFormatLarge->Show();
+    mBottom->Layout();
+    return;
+  }
+
+  {
+    std::lock_guard lock(mFormatMutex);
+    mFormatJob = FormatJob{generation, text, format};
+  }
+  mFormatWake.notify_one();
 
+  if (!mFormatThread.joinable()) {
+    mFormatThread = std::thread(&Edit::formatRun, this);
+  }
+}
+
+void Edit::setText(std::string utf8, Format format) {
   setStyle(format);
 
-  if (format == Format::Json) {
-    try {
-      auto data = json::parse(text);
-      return data.dump(2);
-    } catch (std::exception &event) {}
+  // Scintilla lexes and wraps everything it is given, which does not end for
+  // large payloads and long lines.
+  const bool plain = utf8.size() > PlainLimit;
+  const bool wrap = !plain && !hasLongLine(utf8);
+  mText->SetLexer(plain ? wxSTC_LEX_NULL : lexer(format));
+  mText->SetWrapMode(wrap ? wxSTC_WRAP_WORD : wxSTC_WRAP_NONE);
+
+  mFullText = std::move(utf8);
+  mLoaded = 0;
+  loadMore(PageSize);
+}
+
+void Edit::loadMore(size_t bytes) {
+  const auto end = pageEnd(mFullText, mLoaded, bytes);
+  const auto page = std::string_view(mFullText).substr(mLoaded, end - mLoaded);
+  const auto text = wxString::FromUTF8(page.data(), page.size());
+
+  mText->SetReadOnly(false);
+  mLoading = true;
+  if (mLoaded == 0) {
+    mText->SetText(text);
+  } else {
+    mText->AppendText(text);
+  }
+  mLoading = false;
+  mLoaded = end;
+
+  // The editor holds the whole text from now on.
+  if (mLoaded == mFullText.size()) {
+    mFullText = {};
+    mLoaded = 0;
+  }
+  lockText();
+
+  const bool truncated = isTruncated();
+  if (truncated) {
+    mLoadMore->SetToolTip(fmt::format(
+      "{} of {} KiB shown, load the next {} KiB",
+      mLoaded / KiB,
+      mFullText.size() / KiB,
+      PageSize / KiB
+    ));
   }
+  if (mLoadMore->IsShown() != truncated) {
+    mLoadMore->Show(truncated);
+    mShowAll->Show(truncated);
+    mBottom->Layout();
+  }
+}
+
+bool Edit::isTruncated() const { return mLoaded != mFullText.size(); }
+
+// Partly loaded text is not edited, it would be published as it is.
+void Edit::lockText() {
+  mText->SetReadOnly(
+    mReadOnly || isDecoded(mCurrentFormat) || isTruncated()
+  );
+}
+
+void Edit::showHexView(bool show) {
+  if (mHexView->IsShown() == show) { return; }
+  if (!show) { mHexView->setData({}); }
+  mVsizer->Show(mHexView, show);
+  mVsizer->Show(mText, !show);
+  mVsizer->Layout();
+}
+
+void Edit::formatRun() {
+  while (true) {
+    FormatJob job;
+    {
+      std::unique_lock lock(mFormatMutex);
+      mFormatWake.wait(lock, [this]() {
+        return mFormatStopping || mFormatJob.has_value();
+      });
+      if (mFormatStopping) { return; }
+      job = std::move(*mFormatJob);
+      mFormatJob.reset();
+    }
+
+    const auto cancelled = [this, &job]() {
+      return mGeneration != job.generation;
+    };
 
-  if (format == Format::Xml) {
-    tinyxml2::XMLDocument doc;
-    auto res = doc.Parse(text.c_str());
-    if (res == tinyxml2::XMLError::XML_SUCCESS) {
-      tinyxml2::XMLPrinter printer;
-      doc.Print(&printer);
-      return printer.CStr();
+    const auto start = std::chrono::steady_clock::now();
+    std::string error;
+    auto text = formatTry(job.text, job.format, cancelled, error);
+    if (cancelled()) {
+      mLogger->debug("Formatting of {} bytes cancelled", job.text.size());
+      continue;
     }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+      std::chrono::steady_clock::now() - start
+    );
+    mLogger->debug(
+      "Formatted {} bytes in {} ms",
+      job.text.size(),
+      elapsed.count()
+    );
+
+    // Nothing to replace when the payload could not be formatted.
+    if (!error.empty()) {
+      mLogger->debug("Not formatted: {}", error);
+      continue;
+    }
+    if (text == job.text) { continue; }
+
+    auto *event = new Events::Edit(Events::EDIT_FORMATTED);
+    event->setGeneration(job.generation);
+    event->setPayload(std::move(text));
+    wxQueueEvent(this, event);
+  }
+}
+
+void Edit::onFormatted(Events::Edit &event) {
+  if (event.getGeneration() != mGeneration) { return; }
+  // The payload shown is always mPayload, edits bump the generation.
+  if (mPreviews != nullptr) {
+    mPreviews->insert(
+      mCurrentFormat,
+      mPayload,
+      {event.getPayload(), mCurrentFormat}
+    );
+  }
+  setText(event.getPayload(), mCurrentFormat);
+}
+
+void Edit::onTextModified(wxStyledTextEvent &event) {
+  event.Skip();
+  // Scintilla reports text set by loadMore as performed by the user too.
+  if (mLoading) { return; }
+
+  constexpr int PerformedByUser = wxSTC_PERFORMED_USER | wxSTC_PERFORMED_UNDO
+    | wxSTC_PERFORMED_REDO;
+  constexpr int Modified = wxSTC_MOD_INSERTTEXT | wxSTC_MOD_DELETETEXT;
+  const int type = event.GetModificationType();
+
+  // Edits must not be overwritten by a formatting still in progress.
+  if ((type & PerformedByUser) != 0 && (type & Modified) != 0) {
+    ++mGeneration;
+  }
+}
+
+std::string Edit::formatTry(
+  const std::string &text,
+  Format format,
+  const std::function<bool()> &cancelled,
+  std::string &error
+) {
+  if (text.empty()) { return ""; }
+
+  if (format == Format::Auto) {
+    const auto guess = toFormat(Payload::sniff(text));
+    return formatTry(text, guess, cancelled, error);
+  }
+
+  if (format == Format::Json || format == Format::Xml) {
+    std::string formatted;
+    const bool succeeded = format == Format::Json
+      ? Payload::Json::pretty(text, formatted, error, cancelled)
+      : Payload::Xml::pretty(text, formatted, error, cancelled);
+    if (succeeded) { return formatted; }
+    return text;
+  }
+
+  if (format == Format::MessagePack || format == Format::Cbor) {
+    // A payload that cannot be decoded is still shown, with the reason.
+    std::string decoded;
+    std::string reason;
+    const bool succeeded = format == Format::MessagePack
+      ? Payload::MessagePack::toJson(text, decoded, reason, cancelled)
+      : Payload::Cbor::toJson(text, decoded, reason, cancelled);
+    if (succeeded) { return decoded; }
+    return fmt::format(
+      "Could not decode: {}\n\n{}",
+      reason,
+      Helpers::hexDump(text, BinaryFormatWidth)
+    );
   }
 
   if (format == Format::Binary) {
-    const std::vector<uint8_t> bytes{std::begin(text), std::end(text)};
-    return Helpers::hexDump(bytes, BinaryFormatWidth);
+    return Helpers::hexDump(text, BinaryFormatWidth);
   }
 
   return text;
 }
 
-Edit::Format Edit::formatGuess(const std::string &text) {
-  if (text.empty()) { return Format::Text; }
+Edit::Format Edit::selectedFormat() const {
+  return formats().at(mFormatSelect->GetValue().ToStdString());
+}
 
-  // NOLINTNEXTLINE(readability-identifier-length)
-  const char c = text[0];
+Edit::Format Edit::formatGuess(
+  const std::string &text,
+  std::string_view topic
+) {
+  if (topic.empty()) { return toFormat(Payload::sniff(text)); }
 
-  if (c == '<') { return Format::Xml; }
+  // Topics rarely change encoding, what was found for the last message is
+  // reused as long as the first bytes agree with it.
+  const auto it = mKinds.find(topic);
+  if (it != std::end(mKinds) && Payload::plausible(text, it->second)) {
+    return toFormat(it->second);
+  }
+
+  const auto kind = Payload::sniff(text);
+  if (it != std::end(mKinds)) {
+    it->second = kind;
+  } else {
+    if (mKinds.size() == MaxKnownKinds) {
+      mKinds.clear();
+      mKindTopics.clear();
+    }
+    mKinds.emplace(mKindTopics.emplace_back(topic), kind);
+  }
+  return toFormat(kind);
+}
 
-  if (
-    // clang-format off
-    isdigit(c) != 0
-    || c == '"'
-    || c == '{'
-    || c == '['
-    || c == 't'
-    || c == 'f'
-    || c == 'n'
-    // clang-format on
-  ) {
-    return Format::Json;
+int Edit::lexer(Format format) {
+  switch (format) {
+    case Format::Json:
+    case Format::MessagePack:
+    case Format::Cbor: return wxSTC_LEX_JSON;
+    case Format::Xml: return wxSTC_LEX_XML;
+    default: return wxSTC_LEX_NULL;
   }
+}
 
-  if (::isprint(c) == 0) { return Format::Binary; }
+bool Edit::isDecoded(Format format) {
+  return format == Format::Binary
+    || format == Format::MessagePack
+    || format == Format::Cbor;
+}
 
-  return Format::Text;
+Edit::Format Edit::toFormat(Payload::Kind kind) {
+  switch (kind) {
+    case Payload::Kind::Text: return Format::Text;
+    case Payload::Kind::Json: return Format::Json;
+    case Payload::Kind::Xml: return Format::Xml;
+    case Payload::Kind::MessagePack: return Format::MessagePack;
+    case Payload::Kind::Cbor: return Format::Cbor;
+    default: return Format::Binary;
+  }
 }
 
-void Edit::onFormatSelected(wxCommandEvent & /* event */) { format(); }
+void Edit::onFormatSelected(wxCommandEvent & /* event */) {
+  if (mPreviews != nullptr) { mPreviews->clear(); }
+  format();
+}
 
 void Edit::onTopicCtrlReturn(Events::TopicCtrl & /* event */) {
   auto *event = new Events::Edit(Events::EDIT_PUBLISH);
@@ -548,6 +915,8 @@ const std::map<std::string, Edit::Format> &Edit::formats() {
     {"Json", Format::Json},
     {"Xml", Format::Xml},
     {"Binary", Format::Binary},
+    {"MessagePack", Format::MessagePack},
+    {"Cbor", Format::Cbor},
   };
   return result;
 }
@@ -1,6 +1,15 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
 
 #include <spdlog/spdlog.h>
 #include <wx/stattext.h>
@@ -12,14 +21,28 @@
 #include "GUI/Events/TopicCtrl.hpp"
 #include "MQTT/Client.hpp"
 #include "MQTT/Message.hpp"
+#include "Payload/Sniffer.hpp"
+#include "HexView.hpp"
 #include "TopicCtrl.hpp"
 
 namespace Rapatas::Transmitron::GUI::Widgets {
 
+class PreviewCache;
+
 class Edit : public wxPanel
 {
 public:
 
+  enum class Format : uint8_t {
+    Auto,
+    Text,
+    Json,
+    Xml,
+    Binary,
+    MessagePack,
+    Cbor,
+  };
+
   explicit Edit(
     wxWindow *parent,
     wxWindowID id,
@@ -28,6 +51,12 @@ public:
     bool darkMode
   );
 
+  Edit(const Edit &other) = delete;
+  Edit(Edit &&other) = delete;
+  Edit &operator=(const Edit &other) = delete;
+  Edit &operator=(Edit &&other) = delete;
+  ~Edit() override;
+
   void format();
 
   [[nodiscard]] MQTT::Message getMessage() const;
@@ -50,6 +79,7 @@ public:
   void addKnownTopics(
     const wxObjectDataPtr<Models::KnownTopics> &knownTopicsModel
   );
+  void setPreviewCache(std::shared_ptr<PreviewCache> previews);
 
 private:
 
@@ -71,16 +101,14 @@ private:
     Uri,
   };
 
-  enum class Format : uint8_t {
-    Auto,
-    Text,
-    Json,
-    Xml,
-    Binary,
-  };
-
   using ThemeStyles = std::map<Style, std::pair<uint32_t, uint32_t>>;
 
+  struct FormatJob {
+    size_t generation = 0;
+    std::string text;
+    Format format = Format::Auto;
+  };
+
   std::shared_ptr<spdlog::logger> mLogger;
 
   Theme mTheme;
@@ -108,14 +136,39 @@ private:
   wxButton *mPublish = nullptr;
 
   wxStyledTextCtrl *mText = nullptr;
+  HexView *mHexView = nullptr;
   std::string mPayload;
 
+  // Large texts are loaded in the editor a page at a time, mFullText holds
+  // the text until all of it is loaded.
+  std::string mFullText;
+  size_t mLoaded = 0;
+  // Set while a page is put in the editor, which is not an edit.
+  bool mLoading = false;
+  wxButton *mLoadMore = nullptr;
+  wxButton *mShowAll = nullptr;
+
   wxStaticText *mInfoLine = nullptr;
 
   wxButton *mSaveMessage = nullptr;
   wxComboBox *mFormatSelect = nullptr;
 
   Format mCurrentFormat = Format::Auto;
+  // The kind last sniffed for each topic, keyed into mKindTopics so that
+  // looking one up takes no copy of the topic.
+  std::deque<std::string> mKindTopics;
+  std::unordered_map<std::string_view, Payload::Kind> mKinds;
+  std::shared_ptr<PreviewCache> mPreviews;
+  wxButton *mFormatLarge = nullptr;
+
+  // Large payloads are formatted on mFormatThread. Every new payload bumps
+  // mGeneration, which cancels the job in progress and drops its result.
+  std::atomic<size_t> mGeneration = 0;
+  std::optional<FormatJob> mFormatJob;
+  bool mFormatStopping = false;
+  std::mutex mFormatMutex;
+  std::condition_variable mFormatWake;
+  std::thread mFormatThread;
 
   void onQosClicked(wxMouseEvent &event);
   void onRetainedClicked(wxMouseEvent &event);
@@ -124,10 +177,39 @@ private:
   void setStyle(Format format);
   void onFormatSelected(wxCommandEvent &event);
   void onTopicCtrlReturn(Events::TopicCtrl &event);
+  void onFormatted(Events::Edit &event);
+  void onTextModified(wxStyledTextEvent &event);
+
+  // Messages with a topic reuse the format detected for the topic.
+  void showPayload(
+    const std::string &text,
+    bool force,
+    std::string_view topic = {}
+  );
+  void setText(std::string utf8, Format format);
+  void loadMore(size_t bytes);
+  [[nodiscard]] bool isTruncated() const;
+  void lockText();
+  void showHexView(bool show);
+  void formatRun();
+
+  // When the payload cannot be formatted it is returned as is and `error`
+  // tells why.
+  static std::string formatTry(
+    const std::string &text,
+    Format format,
+    const std::function<bool()> &cancelled,
+    std::string &error
+  );
 
-  std::string formatTry(const std::string &text, Format format);
+  [[nodiscard]] Format selectedFormat() const;
+  Format formatGuess(const std::string &text, std::string_view topic);
 
-  static Format formatGuess(const std::string &text);
+  static Format toFormat(Payload::Kind kind);
+  static int lexer(Format format);
+  // Whether the payload is shown read-only in a form it cannot be edited
+  // back from.
+  static bool isDecoded(Format format);
   static const std::map<std::string, Format> &formats();
   static const std::map<Theme, ThemeStyles> &styles();
 };
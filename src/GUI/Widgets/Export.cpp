@@ -0,0 +1,75 @@
+#include "Export.hpp"
+
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+
+using namespace Rapatas::Transmitron;
+using namespace GUI::Widgets;
+
+Export::Export(wxWindow *parent, bool encodable, int optionsHeight) :
+  wxDialog(
+    parent,
+    wxID_ANY,
+    "Store history",
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER
+  ) //
+{
+  const wxString encodings[] = {
+    "UTF-8",
+    "Base64",
+    "Hex",
+  };
+  mEncoding = new wxChoice(
+    this,
+    wxID_ANY,
+    wxDefaultPosition,
+    wxSize(-1, optionsHeight),
+    std::size(encodings),
+    encodings // NOLINT
+  );
+  mEncoding->SetSelection(0);
+  mEncoding->SetToolTip("Binary payloads need Base64 or Hex");
+  mEncoding->Enable(encodable);
+
+  mVisibleOnly = new wxCheckBox(
+    this,
+    wxID_ANY,
+    "Only the messages shown in the history"
+  );
+
+  auto *grid = new wxFlexGridSizer(2);
+  grid->AddGrowableCol(1, 1);
+  grid->Add(
+    new wxStaticText(this, wxID_ANY, "Payload encoding"),
+    0,
+    wxALIGN_CENTER_VERTICAL
+  );
+  grid->Add(mEncoding, 1, wxEXPAND);
+
+  auto *vsizer = new wxBoxSizer(wxOrientation::wxVERTICAL);
+  vsizer->Add(grid, 0, wxEXPAND);
+  vsizer->Add(mVisibleOnly, 0, wxEXPAND);
+  vsizer->Add(CreateStdDialogButtonSizer(wxOK | wxCANCEL), 0, wxEXPAND);
+  SetSizerAndFit(vsizer);
+}
+
+Export::Options Export::getOptions() const {
+  Options result;
+
+  switch (mEncoding->GetSelection()) {
+    case 1: {
+      result.encoding = Recording::Encoding::Base64;
+    } break;
+    case 2: {
+      result.encoding = Recording::Encoding::Hex;
+    } break;
+    default: {
+      result.encoding = Recording::Encoding::Utf8;
+    }
+  }
+  result.visibleOnly = mVisibleOnly->GetValue();
+
+  return result;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <wx/checkbox.h>
+#include <wx/choice.h>
+#include <wx/dialog.h>
+
+#include "Recording/Encoding.hpp"
+
+namespace Rapatas::Transmitron::GUI::Widgets {
+
+// Asks what part of the history to store and how to encode payloads.
+class Export : public wxDialog
+{
+public:
+
+  struct Options {
+    Recording::Encoding encoding = Recording::Encoding::Utf8;
+    bool visibleOnly = false;
+  };
+
+  // Payloads can only be encoded in the text formats.
+  explicit Export(wxWindow *parent, bool encodable, int optionsHeight);
+
+  [[nodiscard]] Options getOptions() const;
+
+private:
+
+  wxChoice *mEncoding = nullptr;
+  wxCheckBox *mVisibleOnly = nullptr;
+};
+
+} // namespace Rapatas::Transmitron::GUI::Widgets
@@ -0,0 +1,64 @@
+#include "HexView.hpp"
+
+#include <algorithm>
+#include <string_view>
+
+#include <wx/dcbuffer.h>
+
+#include "Common/Helpers.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace GUI::Widgets;
+using namespace Common;
+
+constexpr int Margin = 4;
+
+HexView::HexView(
+  wxWindow *parent,
+  wxWindowID id,
+  size_t columns,
+  const wxFont &font,
+  const wxColour &foreground,
+  const wxColour &background
+) :
+  wxVScrolledWindow(parent, id),
+  mColumns(columns),
+  mFont(font),
+  mForeground(foreground),
+  mBackground(background) //
+{
+  SetBackgroundStyle(wxBG_STYLE_PAINT);
+  SetFont(mFont);
+  mLineHeight = std::max(1, GetCharHeight());
+
+  Bind(wxEVT_PAINT, &HexView::onPaint, this);
+}
+
+void HexView::setData(std::string data) {
+  mData = std::move(data);
+  SetRowCount((mData.size() + mColumns - 1) / mColumns);
+  ScrollToRow(0);
+  Refresh();
+}
+
+void HexView::onPaint(wxPaintEvent & /* event */) {
+  wxAutoBufferedPaintDC dc(this);
+  dc.SetBackground(wxBrush(mBackground));
+  dc.Clear();
+  dc.SetFont(mFont);
+  dc.SetTextForeground(mForeground);
+
+  const std::string_view data = mData;
+  const auto begin = GetVisibleRowsBegin();
+  const auto end = GetVisibleRowsEnd();
+  for (size_t row = begin; row < end; ++row) {
+    const auto offset = row * mColumns;
+    const auto bytes = data.substr(offset, mColumns);
+    auto line = Helpers::hexDump(bytes, mColumns, offset);
+    line.pop_back();
+    const auto y = static_cast<int>(row - begin) * mLineHeight;
+    dc.DrawText(wxString::FromAscii(line.data(), line.size()), Margin, y);
+  }
+}
+
+wxCoord HexView::OnGetRowHeight(size_t /* row */) const { return mLineHeight; }
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+#include <wx/font.h>
+#include <wx/vscroll.h>
+
+namespace Rapatas::Transmitron::GUI::Widgets {
+
+// Read-only hex dump that only formats the lines scrolled into view, so its
+// cost does not depend on the size of the payload.
+class HexView : public wxVScrolledWindow
+{
+public:
+
+  explicit HexView(
+    wxWindow *parent,
+    wxWindowID id,
+    size_t columns,
+    const wxFont &font,
+    const wxColour &foreground,
+    const wxColour &background
+  );
+
+  void setData(std::string data);
+
+private:
+
+  size_t mColumns;
+  wxFont mFont;
+  wxColour mForeground;
+  wxColour mBackground;
+  int mLineHeight = 1;
+  std::string mData;
+
+  void onPaint(wxPaintEvent &event);
+
+  [[nodiscard]] wxCoord OnGetRowHeight(size_t row) const override;
+};
+
+} // namespace Rapatas::Transmitron::GUI::Widgets
@@ -0,0 +1,409 @@
+#include "Plot.hpp"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+
+#include <fmt/format.h>
+#include <wx/button.h>
+#include <wx/dcbuffer.h>
+#include <wx/sizer.h>
+
+#include "Common/Helpers.hpp"
+#include "Common/Log.hpp"
+#include "MQTT/Client.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace GUI::Widgets;
+using namespace GUI;
+
+constexpr int RefreshIntervalMs = 100;
+// Messages taken in per refresh, so that a large history is taken in over
+// several refreshes instead of blocking the window.
+constexpr size_t IndexBatch = 64 * 1024;
+constexpr double ZoomStep = 1.25;
+constexpr int Margin = 4;
+
+namespace {
+
+// NOLINTBEGIN(readability-magic-numbers)
+const std::array<wxColour, 6> &palette() {
+  static const std::array<wxColour, 6> colours{
+    wxColour(70, 120, 190),
+    wxColour(220, 80, 60),
+    wxColour(80, 170, 90),
+    wxColour(200, 150, 40),
+    wxColour(150, 90, 190),
+    wxColour(60, 170, 170),
+  };
+  return colours;
+}
+// NOLINTEND(readability-magic-numbers)
+
+// The value on the line between two points at the given time.
+double interpolate(
+  const Common::Series::Point &a,
+  const Common::Series::Point &b,
+  Plot::Timestamp time
+) {
+  const auto span = static_cast<double>((b.time - a.time).count());
+  if (span <= 0) { return b.value; }
+  const auto ratio = static_cast<double>((time - a.time).count()) / span;
+  return a.value + (b.value - a.value) * ratio;
+}
+
+} // namespace
+
+Plot::Plot(
+  wxWindow *parent,
+  wxWindowID id,
+  const wxObjectDataPtr<Models::History> &historyModel,
+  const ArtProvider &artProvider,
+  int optionsHeight,
+  bool darkMode
+) :
+  wxPanel(parent, id),
+  mHistoryModel(historyModel),
+  mDarkMode(darkMode),
+  mTimer(this) //
+{
+  mLogger = Common::Log::create("Widgets::Plot");
+
+  mTopic = new TopicCtrl(this, -1);
+  mTopic->SetHint("Topic...");
+
+  mPath = new wxTextCtrl(
+    this,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxTE_PROCESS_ENTER
+  );
+  mPath->SetHint("JSON path...");
+  mPath->SetToolTip("e.g. $.sensor.temp, or $ for plain numbers");
+
+  mAdd = new wxButton(
+    this,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxSize(optionsHeight, optionsHeight)
+  );
+  mAdd->SetToolTip("Plot the values at the path");
+  mAdd->SetBitmap(artProvider.bitmap(Icon::Add));
+
+  mClear = new wxButton(
+    this,
+    -1,
+    "",
+    wxDefaultPosition,
+    wxSize(optionsHeight, optionsHeight)
+  );
+  mClear->SetToolTip("Remove all plots");
+  mClear->SetBitmap(artProvider.bitmap(Icon::Clear));
+
+  mCanvas = new wxPanel(this);
+  mCanvas->SetBackgroundStyle(wxBG_STYLE_PAINT);
+  mCanvas->SetToolTip(
+    "Scroll to zoom, drag to pan, double-click to show everything"
+  );
+
+  auto *hsizer = new wxBoxSizer(wxOrientation::wxHORIZONTAL);
+  hsizer->SetMinSize(0, optionsHeight);
+  hsizer->Add(mTopic, 1, wxEXPAND);
+  hsizer->Add(mPath, 1, wxEXPAND);
+  hsizer->Add(mAdd, 0, wxEXPAND);
+  hsizer->Add(mClear, 0, wxEXPAND);
+  auto *vsizer = new wxBoxSizer(wxOrientation::wxVERTICAL);
+  vsizer->Add(hsizer, 0, wxEXPAND);
+  vsizer->Add(mCanvas, 1, wxEXPAND);
+  SetSizer(vsizer);
+
+  mAdd->Bind(wxEVT_BUTTON, &Plot::onAdd, this);
+  mPath->Bind(wxEVT_TEXT_ENTER, &Plot::onAdd, this);
+  mClear->Bind(wxEVT_BUTTON, &Plot::onClear, this);
+  mCanvas->Bind(wxEVT_PAINT, &Plot::onPaint, this);
+  mCanvas->Bind(wxEVT_MOUSEWHEEL, &Plot::onWheel, this);
+  mCanvas->Bind(wxEVT_LEFT_DOWN, &Plot::onMouse, this);
+  mCanvas->Bind(wxEVT_LEFT_UP, &Plot::onMouse, this);
+  mCanvas->Bind(wxEVT_MOTION, &Plot::onMouse, this);
+  mCanvas->Bind(wxEVT_LEFT_DCLICK, &Plot::onDoubleClick, this);
+  Bind(wxEVT_TIMER, &Plot::onTimer, this);
+
+  mTimer.Start(RefreshIntervalMs);
+}
+
+void Plot::onAdd(wxCommandEvent & /* event */) {
+  const auto filterUtf8 = mTopic->GetValue().ToUTF8();
+  const auto pathUtf8 = mPath->GetValue().ToUTF8();
+  std::string filter(filterUtf8.data(), filterUtf8.length());
+  const std::string_view expression(pathUtf8.data(), pathUtf8.length());
+  if (filter.empty()) { filter = "#"; }
+
+  Trace trace;
+  std::string error;
+  if (!trace.path.parse(expression.empty() ? "$" : expression, error)) {
+    mLogger->warn("Could not parse path '{}': {}", expression, error);
+    return;
+  }
+  trace.filter = std::move(filter);
+  trace.colour = palette().at(mTraces.size() % palette().size());
+  mTraces.push_back(std::move(trace));
+
+  mPath->SetValue({});
+  reindex();
+}
+
+void Plot::onClear(wxCommandEvent & /* event */) {
+  mTraces.clear();
+  mFollow = true;
+  mSpan = {};
+  mCanvas->Refresh();
+}
+
+void Plot::onTimer(wxTimerEvent & /* event */) {
+  if (!IsShown()) { return; }
+  if (index()) { mCanvas->Refresh(); }
+}
+
+// Takes in the next batch of messages of the history, true when anything
+// changed.
+bool Plot::index() {
+  if (mHistoryModel->getGeneration() != mGeneration) {
+    // Messages were removed from the history, so the indices moved.
+    reindex();
+    return true;
+  }
+  const auto total = mHistoryModel->getTotal();
+  if (mTraces.empty()) {
+    mIndexed = total;
+    return false;
+  }
+
+  const auto end = std::min(total, mIndexed + IndexBatch);
+  if (end == mIndexed) { return false; }
+
+  mHistoryModel->visitRecords(
+    mIndexed,
+    end,
+    [this](size_t /* index */, const Recording::Record &record) {
+      mTopicScratch.assign(record.topic);
+      for (auto &trace : mTraces) {
+        auto match = trace.matches.find(mTopicScratch);
+        if (match == std::end(trace.matches)) {
+          const auto matches = MQTT::Client::match(trace.filter, mTopicScratch);
+          match = trace.matches.emplace(mTopicScratch, matches).first;
+        }
+        if (!match->second) { continue; }
+
+        double value = 0;
+        if (!trace.path.number(record.payload, value)) { continue; }
+        trace.series.append(record.timestamp, value);
+      }
+    }
+  );
+
+  mIndexed = end;
+  return true;
+}
+
+void Plot::reindex() {
+  for (auto &trace : mTraces) { trace.series.clear(); }
+  mIndexed = 0;
+  mGeneration = mHistoryModel->getGeneration();
+  index();
+  mCanvas->Refresh();
+}
+
+void Plot::onPaint(wxPaintEvent & /* event */) {
+  wxAutoBufferedPaintDC dc(mCanvas);
+
+  const auto size = mCanvas->GetClientSize();
+  const auto background = mDarkMode ? wxColour(40, 40, 40)
+                                    : wxColour(245, 245, 245);
+  const auto text = mDarkMode ? wxColour(160, 160, 160)
+                              : wxColour(110, 110, 110);
+
+  dc.SetBackground(wxBrush(background));
+  dc.Clear();
+  dc.SetFont(GetFont());
+  dc.SetTextForeground(text);
+
+  const auto lineHeight = dc.GetCharHeight();
+  const auto top = Margin + lineHeight;
+  const auto bottom = size.GetHeight() - Margin - lineHeight;
+  if (size.GetWidth() <= 0 || bottom <= top) { return; }
+
+  const auto [from, to] = getRange();
+  if (to <= from) {
+    dc.DrawText("Add a topic and a path to plot", Margin, Margin);
+    return;
+  }
+
+  // Lines to the points outside of the range are cut at its edges.
+  const auto columns = static_cast<size_t>(size.GetWidth());
+  auto low = std::numeric_limits<double>::max();
+  auto high = std::numeric_limits<double>::lowest();
+  for (auto &trace : mTraces) {
+    auto &points = trace.visible;
+    trace.series.downsample(from, to, columns, points);
+    if (points.size() >= 2 && points.front().time < from) {
+      points.front().value = interpolate(points[0], points[1], from);
+      points.front().time = from;
+    }
+    if (points.size() >= 2 && points.back().time >= to) {
+      const auto last = points.size() - 1;
+      points.back().value = interpolate(points[last - 1], points[last], to);
+      points.back().time = to;
+    }
+    for (const auto &point : points) {
+      if (point.time < from || point.time > to) { continue; }
+      low = std::min(low, point.value);
+      high = std::max(high, point.value);
+    }
+  }
+  if (low > high) { return; }
+  if (low == high) {
+    low -= 1;
+    high += 1;
+  }
+
+  const auto span = static_cast<double>((to - from).count());
+  const auto width = static_cast<double>(size.GetWidth() - 1);
+  const auto height = static_cast<double>(bottom - top);
+  const auto toPoint = [&](const Common::Series::Point &point) {
+    const auto x = static_cast<double>((point.time - from).count()) / span;
+    const auto y = (point.value - low) / (high - low);
+    return wxPoint(
+      static_cast<int>(x * width),
+      bottom - static_cast<int>(y * height)
+    );
+  };
+
+  std::vector<wxPoint> pixels;
+  for (const auto &trace : mTraces) {
+    pixels.clear();
+    for (const auto &point : trace.visible) {
+      if (point.time < from || point.time > to) { continue; }
+      pixels.push_back(toPoint(point));
+    }
+    dc.SetPen(wxPen(trace.colour));
+    if (pixels.size() == 1) {
+      dc.SetBrush(wxBrush(trace.colour));
+      dc.DrawCircle(pixels.front(), 2);
+    } else if (!pixels.empty()) {
+      dc.DrawLines(static_cast<int>(pixels.size()), pixels.data());
+    }
+  }
+
+  dc.DrawText(fmt::format("{:g}", high), Margin, Margin);
+  dc.DrawText(fmt::format("{:g}", low), Margin, bottom);
+
+  const auto fromText = Common::Helpers::timeToString(from);
+  const auto toText = Common::Helpers::timeToString(to);
+  const auto toWidth = dc.GetTextExtent(toText).GetWidth();
+  dc.DrawText(fromText, Margin, bottom + lineHeight);
+  dc.DrawText(toText, size.GetWidth() - Margin - toWidth, bottom + lineHeight);
+
+  int y = Margin;
+  for (const auto &trace : mTraces) {
+    const auto legend = fmt::format(
+      "{} {}",
+      trace.filter,
+      trace.path.expression()
+    );
+    const auto wxs = wxString::FromUTF8(legend.data(), legend.length());
+    const auto legendWidth = dc.GetTextExtent(wxs).GetWidth();
+    dc.SetTextForeground(trace.colour);
+    dc.DrawText(wxs, size.GetWidth() - Margin - legendWidth, y);
+    y += lineHeight;
+  }
+}
+
+void Plot::onWheel(wxMouseEvent &event) {
+  const auto [from, to] = getRange();
+  if (to <= from || event.GetWheelRotation() == 0) { return; }
+
+  const auto factor = event.GetWheelRotation() > 0 ? 1 / ZoomStep : ZoomStep;
+  const auto anchor = fromPixel(event.GetX());
+  const auto scale = [factor](Timestamp::duration duration) {
+    const auto scaled = static_cast<double>(duration.count()) * factor;
+    return Timestamp::duration(static_cast<Timestamp::rep>(scaled));
+  };
+  setRange(anchor - scale(anchor - from), anchor + scale(to - anchor));
+}
+
+void Plot::onMouse(wxMouseEvent &event) {
+  event.Skip();
+  if (event.LeftDown()) {
+    mDragX = event.GetX();
+    mDragRange = getRange();
+    return;
+  }
+  if (!event.LeftIsDown() || !mDragX.has_value()) {
+    mDragX.reset();
+    return;
+  }
+
+  const auto [from, to] = mDragRange;
+  const auto width = mCanvas->GetClientSize().GetWidth();
+  if (width <= 0 || to <= from) { return; }
+  const auto ratio = static_cast<double>(event.GetX() - *mDragX)
+    / static_cast<double>(width);
+  const auto shift = Timestamp::duration(static_cast<Timestamp::rep>(
+    ratio * static_cast<double>((to - from).count())
+  ));
+  setRange(from - shift, to - shift);
+}
+
+void Plot::onDoubleClick(wxMouseEvent & /* event */) {
+  mFollow = true;
+  mSpan = {};
+  mCanvas->Refresh();
+}
+
+std::pair<Plot::Timestamp, Plot::Timestamp> Plot::getRange() const {
+  if (!mFollow) { return {mFrom, mTo}; }
+  const auto [first, end] = getDataRange();
+  if (mSpan != Timestamp::duration::zero()) { return {end - mSpan, end}; }
+  return {first, end};
+}
+
+// Up to right after the newest point, so that it is in range.
+std::pair<Plot::Timestamp, Plot::Timestamp> Plot::getDataRange() const {
+  auto first = Timestamp::max();
+  auto last = Timestamp::min();
+  for (const auto &trace : mTraces) {
+    if (trace.series.empty()) { continue; }
+    const auto [begin, end] = trace.series.getTimeRange();
+    first = std::min(first, begin);
+    last = std::max(last, end);
+  }
+  if (first > last) { return {}; }
+  return {first, last + Timestamp::duration(1)};
+}
+
+// Zooming or panning up to the newest point keeps following new points.
+void Plot::setRange(Timestamp from, Timestamp to) {
+  if (to <= from) { return; }
+
+  if (to >= getDataRange().second) {
+    mFollow = true;
+    mSpan = to - from;
+  } else {
+    mFollow = false;
+    mFrom = from;
+    mTo = to;
+  }
+  mCanvas->Refresh();
+}
+
+Plot::Timestamp Plot::fromPixel(int pixel) const {
+  const auto [from, to] = getRange();
+  const auto width = mCanvas->GetClientSize().GetWidth();
+  if (width <= 0) { return from; }
+  const auto ratio = static_cast<double>(pixel) / static_cast<double>(width);
+  const auto span = static_cast<double>((to - from).count());
+  return from + Timestamp::duration(static_cast<Timestamp::rep>(ratio * span));
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+#include <wx/panel.h>
+#include <wx/textctrl.h>
+#include <wx/timer.h>
+
+#include "Common/Series.hpp"
+#include "GUI/ArtProvider.hpp"
+#include "GUI/Models/History.hpp"
+#include "Payload/JsonPath.hpp"
+#include "TopicCtrl.hpp"
+
+namespace Rapatas::Transmitron::GUI::Widgets {
+
+// Plots the numbers at a JSON path of the messages of a topic over time. New
+// messages of the history are taken in as they arrive, and each repaint draws
+// at most two points per pixel column whatever the zoom.
+class Plot : public wxPanel
+{
+public:
+
+  using Timestamp = std::chrono::system_clock::time_point;
+
+  explicit Plot(
+    wxWindow *parent,
+    wxWindowID id,
+    const wxObjectDataPtr<Models::History> &historyModel,
+    const ArtProvider &artProvider,
+    int optionsHeight,
+    bool darkMode
+  );
+
+private:
+
+  struct Trace {
+    std::string filter;
+    Payload::JsonPath path;
+    wxColour colour;
+    Common::Series series;
+    // Whether each topic seen so far matches the filter.
+    std::unordered_map<std::string, bool> matches;
+    std::vector<Common::Series::Point> visible;
+  };
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  wxObjectDataPtr<Models::History> mHistoryModel;
+  bool mDarkMode;
+  wxTimer mTimer;
+
+  TopicCtrl *mTopic = nullptr;
+  wxTextCtrl *mPath = nullptr;
+  wxButton *mAdd = nullptr;
+  wxButton *mClear = nullptr;
+  wxPanel *mCanvas = nullptr;
+
+  std::vector<Trace> mTraces;
+  // Messages of the history taken in so far, in its mGeneration.
+  size_t mIndexed = 0;
+  size_t mGeneration = 0;
+  std::string mTopicScratch;
+
+  // While following, the range ends at the newest point and spans mSpan, or
+  // everything when zero. Otherwise it stays at [mFrom, mTo).
+  bool mFollow = true;
+  Timestamp::duration mSpan{};
+  Timestamp mFrom;
+  Timestamp mTo;
+  std::optional<int> mDragX;
+  std::pair<Timestamp, Timestamp> mDragRange;
+
+  void onAdd(wxCommandEvent &event);
+  void onClear(wxCommandEvent &event);
+  void onTimer(wxTimerEvent &event);
+  void onPaint(wxPaintEvent &event);
+  void onWheel(wxMouseEvent &event);
+  void onMouse(wxMouseEvent &event);
+  void onDoubleClick(wxMouseEvent &event);
+
+  bool index();
+  void reindex();
+
+  [[nodiscard]] std::pair<Timestamp, Timestamp> getRange() const;
+  [[nodiscard]] std::pair<Timestamp, Timestamp> getDataRange() const;
+  void setRange(Timestamp from, Timestamp to);
+  [[nodiscard]] Timestamp fromPixel(int pixel) const;
+};
+
+} // namespace Rapatas::Transmitron::GUI::Widgets
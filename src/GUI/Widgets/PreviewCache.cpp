@@ -0,0 +1,84 @@
+#include "PreviewCache.hpp"
+
+#include <functional>
+
+using namespace Rapatas::Transmitron;
+using namespace GUI::Widgets;
+
+// Roughly what a list node, an index node and the key take.
+constexpr size_t EntryOverhead = 256;
+// A single preview may not take more than this part of the budget.
+constexpr size_t LargestShare = 4;
+
+bool PreviewCache::Key::operator==(const Key &other) const {
+  return hash == other.hash && format == other.format;
+}
+
+size_t PreviewCache::KeyHash::operator()(const Key &key) const {
+  // NOLINTNEXTLINE(readability-magic-numbers)
+  constexpr size_t Mix = 0x9E3779B97F4A7C15ULL;
+  const auto format = static_cast<size_t>(key.format);
+  return key.hash ^ (format + Mix + (key.hash << 6U));
+}
+
+PreviewCache::PreviewCache(size_t budget) :
+  mBudget(budget) //
+{}
+
+const PreviewCache::Preview *PreviewCache::find(
+  Edit::Format format,
+  std::string_view payload
+) {
+  const auto it = mIndex.find(key(format, payload));
+  if (it == std::end(mIndex)) { return nullptr; }
+  if (it->second->payload != payload) { return nullptr; }
+  mEntries.splice(std::begin(mEntries), mEntries, it->second);
+  return &it->second->preview;
+}
+
+void PreviewCache::insert(
+  Edit::Format format,
+  std::string_view payload,
+  Preview preview
+) {
+  // Replaces a payload with the same hash too.
+  const auto entryKey = key(format, payload);
+  const auto existing = mIndex.find(entryKey);
+  if (existing != std::end(mIndex)) { erase(existing->second); }
+
+  Entry entry{entryKey, std::string(payload), std::move(preview)};
+  const auto entryCost = cost(entry);
+  if (entryCost > mBudget / LargestShare) { return; }
+
+  while (!mEntries.empty() && mUsed + entryCost > mBudget) {
+    erase(std::prev(std::end(mEntries)));
+  }
+
+  mEntries.push_front(std::move(entry));
+  mIndex.emplace(entryKey, std::begin(mEntries));
+  mUsed += entryCost;
+}
+
+void PreviewCache::clear() {
+  mIndex.clear();
+  mEntries.clear();
+  mUsed = 0;
+}
+
+PreviewCache::Key PreviewCache::key(
+  Edit::Format format,
+  std::string_view payload
+) {
+  return {format, std::hash<std::string_view>{}(payload)};
+}
+
+size_t PreviewCache::cost(const Entry &entry) {
+  return entry.payload.capacity() + entry.preview.text.capacity()
+    + EntryOverhead;
+}
+
+void PreviewCache::erase(Entries::iterator it) {
+  mUsed -= cost(*it);
+  mIndex.erase(it->key);
+  mEntries.erase(it);
+}
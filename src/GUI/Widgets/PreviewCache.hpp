@@ -0,0 +1,69 @@
+#pragma once
+
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "Edit.hpp"
+
+namespace Rapatas::Transmitron::GUI::Widgets {
+
+// Formatted payloads by their contents and the format they were formatted
+// as, least recently used first out once their size goes over a budget.
+// Going back to a message shows it without formatting it again.
+class PreviewCache
+{
+public:
+
+  struct Preview {
+    std::string text;
+    // What the payload was formatted as, which also picks the lexer.
+    Edit::Format format = Edit::Format::Auto;
+  };
+
+  explicit PreviewCache(size_t budget = DefaultBudget);
+
+  // The format is the one the payload is formatted as, never Auto, which
+  // depends on more than the payload. Null when missing, valid until the
+  // next change of the cache.
+  const Preview *find(Edit::Format format, std::string_view payload);
+  void insert(Edit::Format format, std::string_view payload, Preview preview);
+  void clear();
+
+private:
+
+  static constexpr size_t DefaultBudget = 32 * 1024 * 1024;
+
+  // Payloads with the same hash are told apart by the payload kept with
+  // their preview.
+  struct Key {
+    Edit::Format format = Edit::Format::Auto;
+    size_t hash = 0;
+
+    bool operator==(const Key &other) const;
+  };
+
+  struct KeyHash {
+    size_t operator()(const Key &key) const;
+  };
+
+  struct Entry {
+    Key key;
+    std::string payload;
+    Preview preview;
+  };
+  using Entries = std::list<Entry>;
+
+  size_t mBudget;
+  size_t mUsed = 0;
+  // Most recently used first.
+  Entries mEntries;
+  std::unordered_map<Key, Entries::iterator, KeyHash> mIndex;
+
+  static Key key(Edit::Format format, std::string_view payload);
+  static size_t cost(const Entry &entry);
+  void erase(Entries::iterator it);
+};
+
+} // namespace Rapatas::Transmitron::GUI::Widgets
@@ -0,0 +1,157 @@
+#include "Replay.hpp"
+
+#include <wx/sizer.h>
+#include <wx/stattext.h>
+
+using namespace Rapatas::Transmitron;
+using namespace GUI::Widgets;
+
+constexpr int MaxWindow = 65535;
+constexpr double SpeedIncrement = 0.1;
+
+Replay::Replay(
+  wxWindow *parent,
+  const std::vector<Recording::Subscription> &subscriptions,
+  int optionsHeight
+) :
+  wxDialog(
+    parent,
+    wxID_ANY,
+    "Replay recording",
+    wxDefaultPosition,
+    wxDefaultSize,
+    wxDEFAULT_DIALOG_STYLE | wxRESIZE_BORDER
+  ),
+  mSubscriptions(subscriptions) //
+{
+  const wxString timings[] = {
+    "Original timing",
+    "Scaled timing",
+    "As fast as possible",
+  };
+  mTiming = new wxChoice(
+    this,
+    wxID_ANY,
+    wxDefaultPosition,
+    wxSize(-1, optionsHeight),
+    std::size(timings),
+    timings // NOLINT
+  );
+  mTiming->SetSelection(0);
+  mTiming->Bind(wxEVT_CHOICE, &Replay::onTimingSelected, this);
+
+  mSpeed = new wxSpinCtrlDouble(
+    this,
+    wxID_ANY,
+    "",
+    wxDefaultPosition,
+    wxSize(-1, optionsHeight),
+    wxSP_ARROW_KEYS,
+    Recording::Replay::MinSpeed,
+    Recording::Replay::MaxSpeed,
+    1.0,
+    SpeedIncrement
+  );
+  mSpeed->SetDigits(1);
+  mSpeed->SetToolTip("Multiplier of the recorded speed");
+  mSpeed->Disable();
+
+  mWindow = new wxSpinCtrl(
+    this,
+    wxID_ANY,
+    "",
+    wxDefaultPosition,
+    wxSize(-1, optionsHeight),
+    wxSP_ARROW_KEYS,
+    1,
+    MaxWindow,
+    static_cast<int>(Recording::Replay::DefaultWindow)
+  );
+  mWindow->SetToolTip("Most messages waiting for the broker at once");
+
+  mRemapFrom = new wxTextCtrl(this, wxID_ANY);
+  mRemapFrom->SetHint("Topic prefix, e.g. production/");
+  mRemapTo = new wxTextCtrl(this, wxID_ANY);
+  mRemapTo->SetHint("Replacement, e.g. staging/");
+
+  mFilter = new wxCheckListBox(this, wxID_ANY);
+  for (const auto &subscription : mSubscriptions) {
+    const auto index = mFilter->Append(
+      wxString::FromUTF8(subscription.filter)
+    );
+    mFilter->Check(static_cast<unsigned>(index));
+  }
+  mFilter->Bind(wxEVT_CHECKLISTBOX, &Replay::onFilterToggled, this);
+
+  auto *grid = new wxFlexGridSizer(2);
+  grid->AddGrowableCol(1, 1);
+  const auto addRow = [this, grid](const wxString &label, wxWindow *control) {
+    auto *text = new wxStaticText(this, wxID_ANY, label);
+    grid->Add(text, 0, wxALIGN_CENTER_VERTICAL);
+    grid->Add(control, 1, wxEXPAND);
+  };
+  addRow("Timing", mTiming);
+  addRow("Speed", mSpeed);
+  addRow("In flight", mWindow);
+  addRow("Remap from", mRemapFrom);
+  addRow("Remap to", mRemapTo);
+
+  auto *vsizer = new wxBoxSizer(wxOrientation::wxVERTICAL);
+  vsizer->Add(grid, 0, wxEXPAND);
+  vsizer->Add(new wxStaticText(this, wxID_ANY, "Subscriptions"), 0, wxEXPAND);
+  vsizer->Add(mFilter, 1, wxEXPAND);
+  vsizer->Add(CreateStdDialogButtonSizer(wxOK | wxCANCEL), 0, wxEXPAND);
+  SetSizerAndFit(vsizer);
+}
+
+Recording::Replay::Options Replay::getOptions() const {
+  Recording::Replay::Options result;
+
+  switch (mTiming->GetSelection()) {
+    case 1: {
+      result.timing = Recording::Replay::Timing::Scaled;
+    } break;
+    case 2: {
+      result.timing = Recording::Replay::Timing::MaxSpeed;
+    } break;
+    default: {
+      result.timing = Recording::Replay::Timing::Original;
+    }
+  }
+  result.speed = mSpeed->GetValue();
+  result.window = static_cast<size_t>(mWindow->GetValue());
+
+  const auto fromUtf8 = mRemapFrom->GetValue().ToUTF8();
+  const auto toUtf8 = mRemapTo->GetValue().ToUTF8();
+  std::string from(fromUtf8.data(), fromUtf8.length());
+  std::string to(toUtf8.data(), toUtf8.length());
+  if (!from.empty()) { result.remaps.push_back({from, to}); }
+
+  // Only restrict when something was left out, so that messages of
+  // subscriptions missing from the list still play.
+  bool all = true;
+  for (size_t i = 0; i != mSubscriptions.size(); ++i) {
+    if (mFilter->IsChecked(static_cast<unsigned>(i))) {
+      result.subscriptions.insert(mSubscriptions[i].id);
+    } else {
+      all = false;
+    }
+  }
+  if (all) { result.subscriptions.clear(); }
+
+  return result;
+}
+
+void Replay::onTimingSelected(wxCommandEvent & /* event */) {
+  mSpeed->Enable(mTiming->GetSelection() == 1);
+}
+
+void Replay::onFilterToggled(wxCommandEvent & /* event */) {
+  bool any = mSubscriptions.empty();
+  for (size_t i = 0; i != mSubscriptions.size() && !any; ++i) {
+    any = mFilter->IsChecked(static_cast<unsigned>(i));
+  }
+
+  auto *ok = FindWindow(wxID_OK);
+  if (ok != nullptr) { ok->Enable(any); }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+
+#include <wx/checklst.h>
+#include <wx/choice.h>
+#include <wx/dialog.h>
+#include <wx/spinctrl.h>
+#include <wx/textctrl.h>
+
+#include "Recording/Record.hpp"
+#include "Recording/Replay.hpp"
+
+namespace Rapatas::Transmitron::GUI::Widgets {
+
+// Asks how a recording should be replayed to the connected broker.
+class Replay : public wxDialog
+{
+public:
+
+  explicit Replay(
+    wxWindow *parent,
+    const std::vector<Recording::Subscription> &subscriptions,
+    int optionsHeight
+  );
+
+  [[nodiscard]] Recording::Replay::Options getOptions() const;
+
+private:
+
+  std::vector<Recording::Subscription> mSubscriptions;
+  wxChoice *mTiming = nullptr;
+  wxSpinCtrlDouble *mSpeed = nullptr;
+  wxSpinCtrl *mWindow = nullptr;
+  wxTextCtrl *mRemapFrom = nullptr;
+  wxTextCtrl *mRemapTo = nullptr;
+  wxCheckListBox *mFilter = nullptr;
+
+  void onTimingSelected(wxCommandEvent &event);
+  void onFilterToggled(wxCommandEvent &event);
+};
+
+} // namespace Rapatas::Transmitron::GUI::Widgets
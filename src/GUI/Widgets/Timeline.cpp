@@ -0,0 +1,145 @@
+#include "Timeline.hpp"
+
+#include <algorithm>
+
+#include <wx/dcbuffer.h>
+
+#include "Common/Log.hpp"
+#include "GUI/Events/Timeline.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace GUI::Widgets;
+using namespace GUI;
+
+constexpr int RefreshIntervalMs = 500;
+constexpr int MinWidth = 24;
+
+Timeline::Timeline(
+  wxWindow *parent,
+  wxWindowID id,
+  const wxObjectDataPtr<Models::History> &historyModel,
+  bool darkMode
+) :
+  wxPanel(parent, id),
+  mHistoryModel(historyModel),
+  mDarkMode(darkMode),
+  mTimer(this) //
+{
+  mLogger = Common::Log::create("Widgets::Timeline");
+
+  SetBackgroundStyle(wxBG_STYLE_PAINT);
+  SetMinSize(wxSize(MinWidth, -1));
+  SetToolTip("Message rate over time, click to jump");
+
+  Bind(wxEVT_PAINT, &Timeline::onPaint, this);
+  Bind(wxEVT_LEFT_DOWN, &Timeline::onMouse, this);
+  Bind(wxEVT_MOTION, &Timeline::onMouse, this);
+  Bind(wxEVT_TIMER, &Timeline::onTimer, this);
+
+  mTimer.Start(RefreshIntervalMs);
+}
+
+void Timeline::setMarker(Timestamp timestamp) {
+  mMarker = timestamp;
+  Refresh();
+}
+
+void Timeline::onTimer(wxTimerEvent & /* event */) {
+  if (!IsShown()) { return; }
+
+  // Repaint only when the history actually changed since the last paint.
+  const auto total = mHistoryModel->getTotal();
+  const auto range = mHistoryModel->getTimeRange();
+  const auto window = mHistoryModel->getTimeWindow();
+  if (total == mTotal && range == mRange && window == mWindow) { return; }
+
+  mTotal = total;
+  mRange = range;
+  mWindow = window;
+  Refresh();
+}
+
+void Timeline::onPaint(wxPaintEvent & /* event */) {
+  wxAutoBufferedPaintDC dc(this);
+
+  const auto size = GetClientSize();
+  const auto background = mDarkMode ? wxColour(40, 40, 40)
+                                    : wxColour(245, 245, 245);
+  const auto bar = mDarkMode ? wxColour(90, 140, 200)
+                             : wxColour(70, 120, 190);
+  const auto shade = mDarkMode ? wxColour(20, 20, 20)
+                               : wxColour(210, 210, 210);
+  const auto marker = wxColour(220, 80, 60);
+
+  dc.SetBackground(wxBrush(background));
+  dc.Clear();
+
+  if (size.GetHeight() <= 0 || mHistoryModel->getTotal() == 0) { return; }
+
+  const auto buckets = static_cast<size_t>(size.GetHeight());
+  const auto density = mHistoryModel->getDensity(buckets);
+  const auto peak = *std::max_element(std::begin(density), std::end(density));
+  if (peak == 0) { return; }
+
+  dc.SetPen(wxPen(bar));
+  for (size_t i = 0; i != density.size(); ++i) {
+    if (density[i] == 0) { continue; }
+    const auto ratio = static_cast<double>(density[i])
+      / static_cast<double>(peak);
+    const auto width = std::max(
+      1,
+      static_cast<int>(ratio * static_cast<double>(size.GetWidth()))
+    );
+    const auto y = static_cast<int>(i);
+    dc.DrawLine(0, y, width, y);
+  }
+
+  // Dim the parts of the capture outside of the time window.
+  const auto [from, to] = mHistoryModel->getTimeWindow();
+  const auto [first, last] = mHistoryModel->getTimeRange();
+  dc.SetPen(*wxTRANSPARENT_PEN);
+  dc.SetBrush(wxBrush(shade, wxBRUSHSTYLE_SOLID));
+  if (from > first) {
+    const auto bottom = toPixel(from, size.GetHeight());
+    dc.DrawRectangle(0, 0, size.GetWidth(), bottom);
+  }
+  if (to < last) {
+    const auto top = toPixel(to, size.GetHeight());
+    dc.DrawRectangle(0, top, size.GetWidth(), size.GetHeight() - top);
+  }
+
+  if (mMarker >= first && mMarker <= last) {
+    const auto y = toPixel(mMarker, size.GetHeight());
+    dc.SetPen(wxPen(marker));
+    dc.DrawLine(0, y, size.GetWidth(), y);
+  }
+}
+
+void Timeline::onMouse(wxMouseEvent &event) {
+  event.Skip();
+  if (!event.LeftIsDown() || mHistoryModel->getTotal() == 0) { return; }
+
+  const auto height = GetClientSize().GetHeight();
+  const auto y = std::clamp(event.GetY(), 0, std::max(0, height - 1));
+
+  auto *selected = new Events::Timeline(Events::TIMELINE_SELECTED);
+  selected->setTimestamp(fromPixel(y, height));
+  wxQueueEvent(this, selected);
+}
+
+int Timeline::toPixel(Timestamp timestamp, int height) const {
+  const auto [first, last] = mHistoryModel->getTimeRange();
+  const auto span = (last - first).count();
+  if (span <= 0) { return 0; }
+  const auto offset = (timestamp - first).count();
+  const auto ratio = static_cast<double>(offset) / static_cast<double>(span);
+  return static_cast<int>(ratio * static_cast<double>(height));
+}
+
+Timeline::Timestamp Timeline::fromPixel(int pixel, int height) const {
+  const auto [first, last] = mHistoryModel->getTimeRange();
+  if (height <= 0) { return first; }
+  const auto ratio = static_cast<double>(pixel) / static_cast<double>(height);
+  const auto span = static_cast<double>((last - first).count());
+  return first + Timestamp::duration(static_cast<int64_t>(ratio * span));
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <chrono>
+
+#include <spdlog/spdlog.h>
+#include <wx/panel.h>
+#include <wx/timer.h>
+
+#include "GUI/Models/History.hpp"
+
+namespace Rapatas::Transmitron::GUI::Widgets {
+
+class Timeline : public wxPanel
+{
+public:
+
+  using Timestamp = std::chrono::system_clock::time_point;
+
+  explicit Timeline(
+    wxWindow *parent,
+    wxWindowID id,
+    const wxObjectDataPtr<Models::History> &historyModel,
+    bool darkMode
+  );
+
+  void setMarker(Timestamp timestamp);
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  wxObjectDataPtr<Models::History> mHistoryModel;
+  bool mDarkMode;
+  wxTimer mTimer;
+  size_t mTotal = 0;
+  std::pair<Timestamp, Timestamp> mRange;
+  std::pair<Timestamp, Timestamp> mWindow;
+  Timestamp mMarker;
+
+  void onPaint(wxPaintEvent &event);
+  void onMouse(wxMouseEvent &event);
+  void onTimer(wxTimerEvent &event);
+
+  [[nodiscard]] int toPixel(Timestamp timestamp, int height) const;
+  [[nodiscard]] Timestamp fromPixel(int pixel, int height) const;
+};
+
+} // namespace Rapatas::Transmitron::GUI::Widgets
@@ -260,6 +260,7 @@ wxDragResult TopicCtrl::NotAllowedDropTarget::OnData(
 
 void TopicCtrl::popupShow() {
   if (mKnownTopicsModel == nullptr) { return; }
+  mKnownTopicsModel->refresh();
   if (mKnownTopicsModel->GetCount() == 0) { return; }
 
   if (mAutoComplete != nullptr) { mAutoComplete->Destroy(); }
@@ -119,21 +119,30 @@ void Client::unsubscribe(size_t id) {
   }
 }
 
-void Client::publish(const Message &message) {
+bool Client::publish(const Message &message) {
   if (!connected()) {
     mLogger->warn("Could not publish: not connected");
-    return;
+    return false;
   }
 
-  mClient->publish(
-    message.topic,
-    message.payload.data(),
-    message.payload.size(),
-    static_cast<int>(message.qos),
-    message.retained,
-    nullptr,
-    *this
-  );
+  ++mInFlight;
+  try {
+    mClient->publish(
+      message.topic,
+      message.payload.data(),
+      message.payload.size(),
+      static_cast<int>(message.qos),
+      message.retained,
+      nullptr,
+      *this
+    );
+  } catch (const mqtt::exception &exc) {
+    // The link can drop after the check above, or the buffer fill up.
+    settlePublish();
+    mLogger->warn("Could not publish: {}", exc.what());
+    return false;
+  }
+  return true;
 }
 
 // Actions }
@@ -167,6 +176,8 @@ const BrokerOptions &Client::brokerOptions() const { return mBrokerOptions; }
 
 bool Client::connected() const { return mClient && mClient->is_connected(); }
 
+size_t Client::inFlight() const { return mInFlight; }
+
 // Getters }
 
 // Public }
@@ -221,7 +232,9 @@ void Client::onSuccessDisconnect(const mqtt::token & /* tok */) {
   for (const auto &[id, observer] : mObservers) { observer->onDisconnected(); }
 }
 
-void Client::onSuccessPublish(const mqtt::token & /* tok */) {}
+void Client::onSuccessPublish(const mqtt::token & /* tok */) {
+  settlePublish();
+}
 
 void Client::onSuccessSubscribe(const mqtt::token &tok) {
   const auto it = std::find_if(
@@ -283,6 +296,7 @@ void Client::onFailureDisconnect(const mqtt::token &tok) {
 }
 
 void Client::onFailurePublish(const mqtt::token &tok) {
+  settlePublish();
   const auto code = tok.get_return_code();
   mLogger->warn("Publishing attempt failed: {}", codeToStr(code));
 }
@@ -333,6 +347,8 @@ void Client::connected(const std::string & /* cause */) {
 
 void Client::connection_lost(const std::string &cause) {
   mLogger->info("Connection lost: {}", cause);
+  // Unacknowledged publishes are never completed after this.
+  mInFlight = 0;
   for (const auto &[id, observer] : mObservers) {
     observer->onConnectionLost();
   }
@@ -342,6 +358,9 @@ void Client::connection_lost(const std::string &cause) {
 
 void Client::message_arrived(mqtt::const_message_ptr msg) {
   mLogger->info("Message received: {}", msg->get_topic());
+  for (const auto &[id, observer] : mObservers) {
+    observer->onMessageArrived(msg->get_topic());
+  }
   for (const auto &sub : mSubscriptions) {
     if (Client::match(sub.second->getFilter(), msg->get_topic())) {
       sub.second->onMessage(msg);
@@ -418,6 +437,14 @@ void Client::cleanSubscriptions() {
   }
 }
 
+// A publish is done, or failed. The count may have been reset meanwhile by a
+// lost connection, and checking it apart from the decrement could wrap it.
+void Client::settlePublish() {
+  auto inFlight = mInFlight.load();
+  while (inFlight != 0
+         && !mInFlight.compare_exchange_weak(inFlight, inFlight - 1)) {}
+}
+
 // Static {
 
 bool Client::match(const std::string &filter, const std::string &topic) {
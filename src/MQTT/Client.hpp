@@ -1,5 +1,6 @@
 #pragma once
 
+#include <atomic>
 #include <map>
 #include <memory>
 
@@ -35,6 +36,8 @@ public:
     virtual void onDisconnected() = 0;
     virtual void onConnectionFailure() = 0;
     virtual void onConnectionLost() = 0;
+    // On the thread of the MQTT client, for every message that arrives.
+    virtual void onMessageArrived(const std::string & /* topic */) {}
   };
 
   explicit Client();
@@ -45,7 +48,8 @@ public:
   void connect();
   void disconnect();
   void cancel();
-  void publish(const Message &message);
+  // False when the message could not be handed to the client.
+  bool publish(const Message &message);
   std::shared_ptr<Subscription> subscribe(const std::string &topic);
   void unsubscribe(size_t id);
 
@@ -56,6 +60,13 @@ public:
   const BrokerOptions &brokerOptions() const;
   bool connected() const;
 
+  // Publishes that were handed to the broker connection and are not yet
+  // acknowledged. Safe to call from any thread.
+  size_t inFlight() const;
+
+  // Whether the topic matches the MQTT topic filter.
+  static bool match(const std::string &filter, const std::string &topic);
+
 private:
 
   std::shared_ptr<spdlog::logger> mLogger;
@@ -65,6 +76,7 @@ private:
   bool mCanceled = false;
   mqtt::connect_options mConnectOptions;
   size_t mRetries = 0;
+  std::atomic<size_t> mInFlight = 0;
   std::map<SubscriptionId, std::shared_ptr<Subscription>> mSubscriptions;
   std::map<size_t, MQTT::Client::Observer *> mObservers;
   std::shared_ptr<mqtt::async_client> mClient;
@@ -93,9 +105,9 @@ private:
   void reconnect();
   void doSubscribe(size_t id);
   void cleanSubscriptions();
+  void settlePublish();
 
   static const std::map<int, std::string> &codeDescriptions();
-  static bool match(const std::string &filter, const std::string &topic);
   static std::string codeToStr(int code);
 };
 
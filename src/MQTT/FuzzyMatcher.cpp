@@ -0,0 +1,195 @@
+#include "FuzzyMatcher.hpp"
+
+#include <algorithm>
+
+using namespace Rapatas::Transmitron;
+using namespace MQTT;
+
+// The scores of fzf.
+constexpr int ScoreMatch = 16;
+constexpr int ScoreGapStart = -3;
+constexpr int ScoreGapExtension = -1;
+constexpr int BonusBoundary = ScoreMatch / 2;
+constexpr int BonusNonWord = ScoreMatch / 2;
+constexpr int BonusCamel = BonusBoundary + ScoreGapExtension;
+constexpr int BonusConsecutive = -(ScoreGapStart + ScoreGapExtension);
+constexpr int FirstCharMultiplier = 2;
+// The start of a level beats the start of a word.
+constexpr int BonusLevel = BonusBoundary + 1;
+
+namespace {
+
+enum class Kind : uint8_t {
+  Level,
+  NonWord,
+  Lower,
+  Upper,
+  Digit,
+};
+
+Kind kind(char c) {
+  if (c == '/') { return Kind::Level; }
+  if (c >= 'a' && c <= 'z') { return Kind::Lower; }
+  if (c >= 'A' && c <= 'Z') { return Kind::Upper; }
+  if (c >= '0' && c <= '9') { return Kind::Digit; }
+  // Bytes of multibyte UTF-8 sequences, mostly letters.
+  if ((static_cast<uint8_t>(c) & 0x80U) != 0) { return Kind::Lower; }
+  return Kind::NonWord;
+}
+
+char fold(char c) {
+  constexpr char Offset = 'a' - 'A';
+  return c >= 'A' && c <= 'Z' ? static_cast<char>(c + Offset) : c;
+}
+
+char unfold(char c) {
+  constexpr char Offset = 'a' - 'A';
+  return c >= 'a' && c <= 'z' ? static_cast<char>(c - Offset) : c;
+}
+
+int bonus(Kind previous, Kind current) {
+  if (current == Kind::Level || current == Kind::NonWord) {
+    return BonusNonWord;
+  }
+  if (previous == Kind::Level) { return BonusLevel; }
+  if (previous == Kind::NonWord) { return BonusBoundary; }
+  if (previous == Kind::Lower && current == Kind::Upper) { return BonusCamel; }
+  if (previous != Kind::Digit && current == Kind::Digit) { return BonusCamel; }
+  return 0;
+}
+
+} // namespace
+
+FuzzyMatcher::FuzzyMatcher(std::string_view pattern) {
+  size_t begin = 0;
+  while (begin < pattern.size()) {
+    auto end = pattern.find(' ', begin);
+    if (end == std::string_view::npos) { end = pattern.size(); }
+    if (end != begin) {
+      Fragment fragment;
+      fragment.text.assign(pattern.substr(begin, end - begin));
+      fragment.other = fragment.text;
+      const bool caseSensitive = std::any_of(
+        std::begin(fragment.text),
+        std::end(fragment.text),
+        [](char c) { return kind(c) == Kind::Upper; }
+      );
+      if (!caseSensitive) {
+        for (auto &c : fragment.other) { c = unfold(c); }
+      }
+      mMask |= mask(fragment.text);
+      mFragments.push_back(std::move(fragment));
+    }
+    begin = end + 1;
+  }
+}
+
+uint64_t FuzzyMatcher::mask(std::string_view text) {
+  constexpr unsigned Letters = 26;
+  constexpr unsigned Digits = 10;
+  constexpr unsigned Others = 64 - Letters - Digits;
+
+  uint64_t result = 0;
+  for (const char c : text) {
+    const char folded = fold(c);
+    unsigned bit = 0;
+    if (folded >= 'a' && folded <= 'z') {
+      bit = static_cast<unsigned>(folded - 'a');
+    } else if (folded >= '0' && folded <= '9') {
+      bit = Letters + static_cast<unsigned>(folded - '0');
+    } else {
+      bit = Letters + Digits + static_cast<uint8_t>(folded) % Others;
+    }
+    result |= uint64_t{1} << bit;
+  }
+  return result;
+}
+
+bool FuzzyMatcher::empty() const { return mFragments.empty(); }
+
+uint64_t FuzzyMatcher::mask() const { return mMask; }
+
+bool FuzzyMatcher::match(std::string_view topic, int &score) const {
+  score = 0;
+  for (const auto &fragment : mFragments) {
+    int fragmentScore = 0;
+    if (!match(topic, fragment, fragmentScore)) { return false; }
+    score += fragmentScore;
+  }
+  return true;
+}
+
+// Finds where the fragment first ends in the topic, then the latest start
+// from which it still does, as fzf does. That is the tightest match ending
+// there, in a pass and a bit over the topic.
+bool FuzzyMatcher::match(
+  std::string_view topic,
+  const Fragment &fragment,
+  int &score
+) {
+  const auto size = fragment.text.size();
+
+  size_t next = 0;
+  size_t end = 0;
+  for (size_t i = 0; i != topic.size(); ++i) {
+    if (!fragment.matches(topic[i], next)) { continue; }
+    if (++next == size) {
+      end = i + 1;
+      break;
+    }
+  }
+  if (next != size) { return false; }
+
+  size_t begin = end;
+  while (next != 0) {
+    --begin;
+    if (fragment.matches(topic[begin], next - 1)) { --next; }
+  }
+
+  score = FuzzyMatcher::score(topic, fragment, begin, end);
+  return true;
+}
+
+int FuzzyMatcher::score(
+  std::string_view topic,
+  const Fragment &fragment,
+  size_t begin,
+  size_t end
+) {
+  const auto size = fragment.text.size();
+  int result = 0;
+  bool gap = false;
+  int consecutive = 0;
+  int firstBonus = 0;
+  size_t next = 0;
+  auto previous = begin == 0 ? Kind::Level : kind(topic[begin - 1]);
+
+  for (size_t i = begin; i != end; ++i) {
+    const auto current = kind(topic[i]);
+
+    if (next != size && fragment.matches(topic[i], next)) {
+      result += ScoreMatch;
+      auto matchBonus = bonus(previous, current);
+      if (consecutive == 0) {
+        firstBonus = matchBonus;
+      } else {
+        // A run keeps the bonus of a boundary it started at.
+        if (matchBonus >= BonusBoundary && matchBonus > firstBonus) {
+          firstBonus = matchBonus;
+        }
+        matchBonus = std::max({matchBonus, firstBonus, BonusConsecutive});
+      }
+      result += next == 0 ? matchBonus * FirstCharMultiplier : matchBonus;
+      gap = false;
+      ++consecutive;
+      ++next;
+    } else {
+      result += gap ? ScoreGapExtension : ScoreGapStart;
+      gap = true;
+      consecutive = 0;
+      firstBonus = 0;
+    }
+    previous = current;
+  }
+  return result;
+}
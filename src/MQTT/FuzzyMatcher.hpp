@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Rapatas::Transmitron::MQTT {
+
+// Matches topics against fragments typed for them, like `b3 pmp pres` for
+// `building3/pump/pressure`, scored the way fzf does. Each fragment has to
+// appear in the topic in order, not necessarily next to each other, and
+// scores higher the more of it is consecutive or starts a level or a word.
+// Fragments are matched regardless of case unless they have upper case.
+class FuzzyMatcher
+{
+public:
+
+  explicit FuzzyMatcher(std::string_view pattern);
+
+  // The characters in the text, folded to lower case and a bit each. A
+  // topic can only match when its mask has every bit of the pattern's.
+  [[nodiscard]] static uint64_t mask(std::string_view text);
+
+  // True when there is nothing to match.
+  [[nodiscard]] bool empty() const;
+  [[nodiscard]] uint64_t mask() const;
+  // False when a fragment is not in the topic.
+  bool match(std::string_view topic, int &score) const;
+
+private:
+
+  struct Fragment {
+    std::string text;
+    // The text in upper case, unless it matches by case. Comparing with both
+    // is quicker than folding every character of every topic.
+    std::string other;
+
+    [[nodiscard]] bool matches(char c, size_t index) const {
+      return c == text[index] || c == other[index];
+    }
+  };
+
+  std::vector<Fragment> mFragments;
+  uint64_t mMask = 0;
+
+  static bool match(
+    std::string_view topic,
+    const Fragment &fragment,
+    int &score
+  );
+  static int score(
+    std::string_view topic,
+    const Fragment &fragment,
+    size_t begin,
+    size_t end
+  );
+};
+
+} // namespace Rapatas::Transmitron::MQTT
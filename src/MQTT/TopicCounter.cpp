@@ -0,0 +1,31 @@
+#include "TopicCounter.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace MQTT;
+
+// Distinct topics per batch, past which new ones are dropped until the next
+// take.
+constexpr size_t BatchLimit = 65536;
+
+void TopicCounter::add(const std::string &topic) {
+  std::lock_guard lock(mMutex);
+  const auto it = mCounts.find(topic);
+  if (it != std::end(mCounts)) {
+    ++it->second;
+    return;
+  }
+  if (mCounts.size() == BatchLimit) {
+    ++mDropped;
+    return;
+  }
+  mCounts.emplace(topic, 1);
+}
+
+TopicCounter::Counts TopicCounter::take(size_t &dropped) {
+  Counts counts;
+  std::lock_guard lock(mMutex);
+  std::swap(counts, mCounts);
+  dropped = mDropped;
+  mDropped = 0;
+  return counts;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace Rapatas::Transmitron::MQTT {
+
+// Counts the topics of messages as they arrive, on whichever thread they
+// arrive, for another thread to take in batches. Every topic is stored once
+// per batch, however many messages it has.
+class TopicCounter
+{
+public:
+
+  using Counts = std::unordered_map<std::string, uint32_t>;
+
+  void add(const std::string &topic);
+  // What was counted since the last take. Topics that did not fit in it are
+  // left out and counted in `dropped`.
+  Counts take(size_t &dropped);
+
+private:
+
+  std::mutex mMutex;
+  Counts mCounts;
+  size_t mDropped = 0;
+};
+
+} // namespace Rapatas::Transmitron::MQTT
@@ -0,0 +1,257 @@
+#include "TopicTrie.hpp"
+
+#include <algorithm>
+#include <queue>
+
+using namespace Rapatas::Transmitron;
+using namespace MQTT;
+
+constexpr uint32_t Root = 0;
+constexpr uint32_t NoNode = std::numeric_limits<uint32_t>::max();
+
+namespace {
+
+std::vector<std::string_view> split(std::string_view topic) {
+  std::vector<std::string_view> levels;
+  size_t begin = 0;
+  while (true) {
+    const auto end = topic.find('/', begin);
+    levels.push_back(topic.substr(begin, end - begin));
+    if (end == std::string_view::npos) { break; }
+    begin = end + 1;
+  }
+  return levels;
+}
+
+bool startsWith(std::string_view text, std::string_view prefix) {
+  return text.substr(0, prefix.size()) == prefix;
+}
+
+} // namespace
+
+TopicTrie::TopicTrie() { clear(); }
+
+bool TopicTrie::insert(std::string_view topic, Id id) {
+  NodeId node = Root;
+  for (const auto level : split(topic)) {
+    const auto it = lowerBound(node, level);
+    if (it != std::cend(mNodes[node].children) && mNodes[*it].level == level) {
+      node = *it;
+      continue;
+    }
+
+    const auto position = it - std::cbegin(mNodes[node].children);
+    NodeId created = 0;
+    if (mFree.empty()) {
+      created = static_cast<NodeId>(mNodes.size());
+      mNodes.emplace_back();
+    } else {
+      created = mFree.back();
+      mFree.pop_back();
+    }
+    mNodes[created].level.assign(level);
+    mNodes[created].rank = Lowest;
+    mNodes[created].best = Lowest;
+
+    auto &children = mNodes[node].children;
+    children.insert(std::begin(children) + position, created);
+    node = created;
+  }
+
+  if (mNodes[node].id != None) { return false; }
+  mNodes[node].id = id;
+  ++mSize;
+  return true;
+}
+
+TopicTrie::Id TopicTrie::erase(std::string_view topic) {
+  std::vector<NodeId> path{Root};
+  for (const auto level : split(topic)) {
+    const auto next = child(path.back(), level);
+    if (next == NoNode) { return None; }
+    path.push_back(next);
+  }
+
+  const auto id = mNodes[path.back()].id;
+  if (id == None) { return None; }
+  mNodes[path.back()].id = None;
+  mNodes[path.back()].rank = Lowest;
+  --mSize;
+
+  // Nodes with no topic at or below them go.
+  while (path.size() > 1) {
+    const auto node = path.back();
+    if (mNodes[node].id != None || !mNodes[node].children.empty()) { break; }
+    path.pop_back();
+
+    auto &children = mNodes[path.back()].children;
+    const auto it = lowerBound(path.back(), mNodes[node].level);
+    children.erase(std::begin(children) + (it - std::cbegin(children)));
+    mNodes[node].level.clear();
+    mFree.push_back(node);
+  }
+  return id;
+}
+
+void TopicTrie::clear() {
+  mNodes.assign(1, {});
+  mFree.clear();
+  mSize = 0;
+}
+
+void TopicTrie::setRank(std::string_view topic, double rank) {
+  std::vector<NodeId> path{Root};
+  for (const auto level : split(topic)) {
+    const auto next = child(path.back(), level);
+    if (next == NoNode) { return; }
+    path.push_back(next);
+  }
+  if (mNodes[path.back()].id == None) { return; }
+
+  mNodes[path.back()].rank = rank;
+  for (const auto node : path) {
+    mNodes[node].best = std::max(mNodes[node].best, rank);
+  }
+}
+
+TopicTrie::Id TopicTrie::find(std::string_view topic) const {
+  NodeId node = Root;
+  for (const auto level : split(topic)) {
+    node = child(node, level);
+    if (node == NoNode) { return None; }
+  }
+  return mNodes[node].id;
+}
+
+size_t TopicTrie::size() const { return mSize; }
+
+void TopicTrie::complete(std::string_view pattern, const Visitor &visitor)
+  const {
+  std::vector<NodeId> matched;
+  match(Root, split(pattern), 0, matched);
+
+  // Subtrees are queued by the best rank in them and topics by their own,
+  // so a topic only comes out once nothing left can rank higher. Ties go to
+  // the latest queued, which visits topics that rank the same depth first in
+  // order. Children without ranks, often most of them, are only queued one
+  // at a time as they come out.
+  enum class Kind : uint8_t {
+    Subtree,
+    Topic,
+    // The children of the node from `next` on that have no rank.
+    Unranked,
+  };
+  struct Item {
+    double rank;
+    size_t order;
+    NodeId node;
+    Kind kind;
+    size_t next;
+  };
+  const auto lower = [](const Item &lhs, const Item &rhs) {
+    if (lhs.rank != rhs.rank) { return lhs.rank < rhs.rank; }
+    return lhs.order < rhs.order;
+  };
+  std::priority_queue<Item, std::vector<Item>, decltype(lower)> queue(lower);
+  size_t order = 0;
+
+  for (auto it = std::crbegin(matched); it != std::crend(matched); ++it) {
+    queue.push({mNodes[*it].best, order++, *it, Kind::Subtree, 0});
+  }
+
+  while (!queue.empty()) {
+    const auto item = queue.top();
+    queue.pop();
+    const auto &node = mNodes[item.node];
+    const auto &children = node.children;
+
+    switch (item.kind) {
+      case Kind::Topic: {
+        if (!visitor(node.id)) { return; }
+      } break;
+      case Kind::Unranked: {
+        const auto ranked = [this](NodeId child) {
+          return mNodes[child].best != Lowest;
+        };
+        auto next = item.next;
+        while (next != children.size() && ranked(children[next])) { ++next; }
+        if (next == children.size()) { break; }
+        queue.push({Lowest, order++, item.node, Kind::Unranked, next + 1});
+        queue.push({Lowest, order++, children[next], Kind::Subtree, 0});
+      } break;
+      case Kind::Subtree: {
+        for (size_t i = children.size(); i != 0; --i) {
+          const auto child = children[i - 1];
+          const auto best = mNodes[child].best;
+          if (best != Lowest) {
+            queue.push({best, order++, child, Kind::Subtree, 0});
+          }
+        }
+        queue.push({Lowest, order++, item.node, Kind::Unranked, 0});
+        if (node.id != None) {
+          queue.push({node.rank, order++, item.node, Kind::Topic, 0});
+        }
+      } break;
+    }
+  }
+}
+
+std::vector<TopicTrie::NodeId>::const_iterator TopicTrie::lowerBound(
+  NodeId node,
+  std::string_view level
+) const {
+  const auto &children = mNodes[node].children;
+  return std::lower_bound(
+    std::cbegin(children),
+    std::cend(children),
+    level,
+    [this](NodeId child, std::string_view value) {
+      return mNodes[child].level < value;
+    }
+  );
+}
+
+TopicTrie::NodeId TopicTrie::child(NodeId node, std::string_view level)
+  const {
+  const auto it = lowerBound(node, level);
+  if (it == std::cend(mNodes[node].children)) { return NoNode; }
+  if (mNodes[*it].level != level) { return NoNode; }
+  return *it;
+}
+
+// Collects the nodes whose topics, and those below, match the levels from
+// index on.
+void TopicTrie::match(
+  NodeId node,
+  const std::vector<std::string_view> &levels,
+  size_t index,
+  std::vector<NodeId> &matched
+) const {
+  const auto level = levels[index];
+  if (level == "#") {
+    matched.push_back(node);
+    return;
+  }
+
+  const bool last = index + 1 == levels.size();
+  const auto &children = mNodes[node].children;
+  auto begin = std::cbegin(children);
+  auto end = std::cend(children);
+  if (level != "+") {
+    begin = lowerBound(node, level);
+    end = begin;
+    const auto within = [&](NodeId next) {
+      const auto &name = mNodes[next].level;
+      return last ? startsWith(name, level) : name == level;
+    };
+    while (end != std::cend(children) && within(*end)) { ++end; }
+  }
+
+  for (auto it = begin; it != end; ++it) {
+    if (last) {
+      matched.push_back(*it);
+    } else {
+      match(*it, levels, index + 1, matched);
+    }
+  }
+}
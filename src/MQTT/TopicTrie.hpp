@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Rapatas::Transmitron::MQTT {
+
+// Topics mapped to ids, stored one level per node with the children of each
+// node sorted by level. Looking a topic up takes a binary search per level.
+// Topics also have a rank, and every node the highest rank below it, so that
+// the best topics under any node come out without looking at the rest.
+class TopicTrie
+{
+public:
+
+  using Id = uint32_t;
+  static constexpr Id None = std::numeric_limits<Id>::max();
+  static constexpr double Lowest = -std::numeric_limits<double>::infinity();
+  // Return false to stop visiting.
+  using Visitor = std::function<bool(Id id)>;
+
+  TopicTrie();
+
+  // False when the topic was there already, with whatever id it has.
+  bool insert(std::string_view topic, Id id);
+  // The id the topic had, or None.
+  Id erase(std::string_view topic);
+  void clear();
+
+  // Topics start at the Lowest rank. Lowering a rank leaves the nodes above
+  // with a higher one than they need, which only costs some time.
+  void setRank(std::string_view topic, double rank);
+
+  [[nodiscard]] Id find(std::string_view topic) const;
+  [[nodiscard]] size_t size() const;
+
+  // The ids of the topics that start with the levels of `pattern`, from the
+  // highest rank down, and topics that rank the same in an order that only
+  // depends on the trie. A `+` level matches any level, `#` matches
+  // everything below and the last level matches as a prefix, so
+  // `plant/+/te` finds `plant/a/temp/raw`.
+  void complete(std::string_view pattern, const Visitor &visitor) const;
+
+private:
+
+  using NodeId = uint32_t;
+
+  struct Node {
+    std::string level;
+    std::vector<NodeId> children;
+    Id id = None;
+    double rank = Lowest;
+    // At least the rank of every topic at or below the node.
+    double best = Lowest;
+  };
+
+  // The root has no level of its own. Nodes that are left without topics are
+  // reused by the next insert.
+  std::vector<Node> mNodes;
+  std::vector<NodeId> mFree;
+  size_t mSize = 0;
+
+  [[nodiscard]] std::vector<NodeId>::const_iterator lowerBound(
+    NodeId node,
+    std::string_view level
+  ) const;
+  [[nodiscard]] NodeId child(NodeId node, std::string_view level) const;
+  void match(
+    NodeId node,
+    const std::vector<std::string_view> &levels,
+    size_t index,
+    std::vector<NodeId> &matched
+  ) const;
+};
+
+} // namespace Rapatas::Transmitron::MQTT
@@ -0,0 +1,262 @@
+#include "Cbor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <optional>
+
+using namespace Rapatas::Transmitron;
+using namespace Payload;
+
+namespace {
+
+constexpr uint8_t MajorShift = 5;
+constexpr uint8_t InfoMask = 0x1F;
+constexpr uint8_t Direct = 24;
+constexpr uint8_t Reserved = 28;
+constexpr uint8_t Indefinite = 31;
+constexpr uint8_t Break = 0xFF;
+
+enum Major : uint8_t {
+  Unsigned,
+  Negative,
+  Bytes,
+  Text,
+  Array,
+  Map,
+  Tag,
+  Simple,
+};
+
+// NOLINTBEGIN(readability-magic-numbers)
+enum SimpleValue : uint8_t {
+  False = 20,
+  True = 21,
+  Null = 22,
+  Undefined = 23,
+  Half = 25,
+  Single = 26,
+  Double = 27,
+};
+
+// RFC 8949, appendix D.
+double halfToDouble(uint16_t half) {
+  const auto exponent = static_cast<int>((half >> 10U) & 0x1FU);
+  const auto mantissa = static_cast<double>(half & 0x3FFU);
+  double value = 0;
+  if (exponent == 0) {
+    value = std::ldexp(mantissa, -24);
+  } else if (exponent != 31) {
+    value = std::ldexp(mantissa + 1024, exponent - 25);
+  } else {
+    value = mantissa == 0 ? INFINITY : NAN;
+  }
+  return (half & 0x8000U) != 0 ? -value : value;
+}
+// NOLINTEND(readability-magic-numbers)
+
+class Decoding : public Decoder
+{
+public:
+
+  using Decoder::Decoder;
+
+  bool run() { return item(0) && finish(); }
+
+private:
+
+  bool argument(uint8_t info, uint64_t &value) {
+    if (info < Direct) {
+      value = info;
+      return true;
+    }
+    if (info >= Reserved) { return fail("Reserved additional information"); }
+    return bigEndian(size_t{1} << (info - Direct), value);
+  }
+
+  bool item(size_t depth) {
+    if (!enter(depth)) { return false; }
+
+    uint8_t initial = 0;
+    if (!byte(initial)) { return false; }
+    const auto major = static_cast<Major>(initial >> MajorShift);
+    const auto info = static_cast<uint8_t>(initial & InfoMask);
+
+    if (info == Indefinite) {
+      switch (major) {
+        case Bytes:
+        case Text: return string(major);
+        case Array: return array(depth);
+        case Map: return map(depth);
+        default: return fail("Invalid indefinite length");
+      }
+    }
+
+    uint64_t value = 0;
+    if (!argument(info, value)) { return false; }
+
+    switch (major) {
+      case Unsigned: {
+        mOutput->number(value);
+      } break;
+      case Negative: {
+        constexpr auto Max = std::numeric_limits<int64_t>::max();
+        if (value <= static_cast<uint64_t>(Max)) {
+          mOutput->number(-1 - static_cast<int64_t>(value));
+        } else {
+          mOutput->number(-1.0 - static_cast<double>(value));
+        }
+      } break;
+      case Bytes: {
+        std::string_view bytes;
+        if (!take(value, bytes)) { return false; }
+        binary(bytes);
+      } break;
+      case Text: {
+        std::string_view text;
+        if (!take(value, text)) { return false; }
+        mOutput->string(text);
+      } break;
+      case Array: return array(depth, value);
+      case Map: return map(depth, value);
+      // Tags only give meaning to the item that follows, which is shown.
+      case Tag: return item(depth + 1);
+      case Simple: return simple(info, value);
+    }
+    return true;
+  }
+
+  [[nodiscard]] bool atBreak() const {
+    return mPos != mData.size() && static_cast<uint8_t>(mData[mPos]) == Break;
+  }
+
+  // Without a count, the container runs up to a break.
+  bool array(size_t depth, std::optional<uint64_t> count = std::nullopt) {
+    mOutput->beginArray();
+    for (uint64_t i = 0; count.has_value() ? i != *count : !atBreak(); ++i) {
+      if (!item(depth + 1)) { return false; }
+    }
+    if (!count.has_value()) { ++mPos; }
+    mOutput->end();
+    return true;
+  }
+
+  bool map(size_t depth, std::optional<uint64_t> count = std::nullopt) {
+    mOutput->beginObject();
+    for (uint64_t i = 0; count.has_value() ? i != *count : !atBreak(); ++i) {
+      if (!key(depth + 1) || !item(depth + 1)) { return false; }
+    }
+    if (!count.has_value()) { ++mPos; }
+    mOutput->end();
+    return true;
+  }
+
+  // JSON keys are strings, other keys are written as their compact JSON.
+  bool key(size_t depth) {
+    if (mPos == mData.size()) { return fail("Unexpected end"); }
+
+    const auto initial = static_cast<uint8_t>(mData[mPos]);
+    const auto info = static_cast<uint8_t>(initial & InfoMask);
+    if (initial >> MajorShift == Text) {
+      ++mPos;
+      if (info == Indefinite) {
+        std::string joined;
+        if (!chunks(Text, joined)) { return false; }
+        mOutput->key(joined);
+        return true;
+      }
+      uint64_t length = 0;
+      std::string_view text;
+      if (!argument(info, length) || !take(length, text)) { return false; }
+      mOutput->key(text);
+      return true;
+    }
+
+    std::string text;
+    JsonPrinter compact(text, false);
+    auto *output = mOutput;
+    mOutput = &compact;
+    const bool decoded = item(depth);
+    mOutput = output;
+    if (!decoded) { return false; }
+    mOutput->key(text);
+    return true;
+  }
+
+  bool string(Major major) {
+    std::string joined;
+    if (!chunks(major, joined)) { return false; }
+    if (major == Bytes) {
+      binary(joined);
+    } else {
+      mOutput->string(joined);
+    }
+    return true;
+  }
+
+  // Indefinite strings are definite chunks of the same type up to a break.
+  bool chunks(Major major, std::string &joined) {
+    while (true) {
+      uint8_t initial = 0;
+      if (!byte(initial)) { return false; }
+      if (initial == Break) { break; }
+
+      const auto info = static_cast<uint8_t>(initial & InfoMask);
+      if (initial >> MajorShift != major || info == Indefinite) {
+        return fail("Invalid chunk");
+      }
+      uint64_t length = 0;
+      std::string_view chunk;
+      if (!argument(info, length) || !take(length, chunk)) { return false; }
+      if (joined.size() + chunk.size() > mLimits.maxOutput) {
+        return fail("Decoded output too large");
+      }
+      joined.append(chunk);
+    }
+    return true;
+  }
+
+  bool simple(uint8_t info, uint64_t value) {
+    switch (info) {
+      case False: mOutput->boolean(false); break;
+      case True: mOutput->boolean(true); break;
+      case Null:
+      case Undefined: mOutput->null(); break;
+      case Half: {
+        mOutput->number(halfToDouble(static_cast<uint16_t>(value)));
+      } break;
+      case Single: {
+        const auto bits = static_cast<uint32_t>(value);
+        float single = 0;
+        std::memcpy(&single, &bits, sizeof(single));
+        mOutput->number(static_cast<double>(single));
+      } break;
+      case Double: {
+        double number = 0;
+        std::memcpy(&number, &value, sizeof(number));
+        mOutput->number(number);
+      } break;
+      default: {
+        mOutput->string(fmt::format("simple({})", value));
+      }
+    }
+    return true;
+  }
+};
+
+} // namespace
+
+bool Cbor::toJson(
+  std::string_view data,
+  std::string &result,
+  std::string &error,
+  const std::function<bool()> &cancelled,
+  const Limits &limits
+) {
+  result.clear();
+  result.reserve(std::min(data.size() * 3, limits.maxOutput));
+  Decoding decoding(data, result, cancelled, limits);
+  if (decoding.run()) { return true; }
+  error = decoding.error();
+  return false;
+}
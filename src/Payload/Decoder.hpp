@@ -0,0 +1,123 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+#include "Payload/JsonPrinter.hpp"
+
+namespace Rapatas::Transmitron::Payload {
+
+// Bounds of a decoding, so that a hostile payload cannot stall the preview.
+struct Limits {
+  size_t maxDepth = 128;
+  size_t maxOutput = 64 * 1024 * 1024;
+};
+
+// Common part of the streaming decoders from binary encodings to JSON.
+class Decoder
+{
+public:
+
+  Decoder(
+    std::string_view data,
+    std::string &result,
+    const std::function<bool()> &cancelled,
+    const Limits &limits
+  ) :
+    mData(data),
+    mResult(result),
+    mCancelled(cancelled),
+    mLimits(limits),
+    mPrinter(result),
+    mOutput(&mPrinter) //
+  {}
+
+  [[nodiscard]] const std::string &error() const { return mError; }
+
+protected:
+
+  static constexpr size_t CheckInterval = 64 * 1024;
+
+  std::string_view mData;
+  size_t mPos = 0;
+  std::string &mResult;
+  const std::function<bool()> &mCancelled;
+  // Where mCancelled is next polled.
+  size_t mCheck = 0;
+  const Limits &mLimits;
+  JsonPrinter mPrinter;
+  // Switched to a compact printer while a map key is decoded.
+  JsonPrinter *mOutput;
+  std::string mError;
+
+  bool fail(std::string_view message) {
+    if (mError.empty()) {
+      mError = fmt::format("{} at offset {}", message, mPos);
+    }
+    return false;
+  }
+
+  bool enter(size_t depth) {
+    if (mPos >= mCheck) {
+      mCheck = mPos + CheckInterval;
+      if (mCancelled && mCancelled()) { return fail("Cancelled"); }
+    }
+    if (depth == mLimits.maxDepth) { return fail("Nested too deep"); }
+    if (mResult.size() > mLimits.maxOutput) {
+      return fail("Decoded output too large");
+    }
+    return true;
+  }
+
+  bool finish() {
+    if (mPos != mData.size()) { return fail("Trailing data"); }
+    return true;
+  }
+
+  bool byte(uint8_t &value) {
+    if (mPos == mData.size()) { return fail("Unexpected end"); }
+    value = static_cast<uint8_t>(mData[mPos++]);
+    return true;
+  }
+
+  bool bigEndian(size_t bytes, uint64_t &value) {
+    if (mData.size() - mPos < bytes) { return fail("Unexpected end"); }
+    value = 0;
+    for (size_t i = 0; i != bytes; ++i) {
+      value = (value << std::numeric_limits<uint8_t>::digits)
+        | static_cast<uint8_t>(mData[mPos++]);
+    }
+    return true;
+  }
+
+  bool take(uint64_t count, std::string_view &value) {
+    if (mData.size() - mPos < count) { return fail("Unexpected end"); }
+    value = mData.substr(mPos, static_cast<size_t>(count));
+    mPos += static_cast<size_t>(count);
+    return true;
+  }
+
+  // Byte strings have no JSON type, they are shown in CBOR diagnostic
+  // notation.
+  void binary(std::string_view bytes) {
+    constexpr std::string_view Digits = "0123456789abcdef";
+    constexpr unsigned Nibble = 4;
+    constexpr uint8_t NibbleMask = 0xF;
+    std::string text = "h'";
+    text.reserve(bytes.size() * 2 + 3);
+    for (const auto c : bytes) {
+      const auto value = static_cast<uint8_t>(c);
+      text += Digits[value >> Nibble];
+      text += Digits[value & NibbleMask];
+    }
+    text += '\'';
+    mOutput->string(text);
+  }
+};
+
+} // namespace Rapatas::Transmitron::Payload
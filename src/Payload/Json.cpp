@@ -0,0 +1,429 @@
+#include "Json.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+#include <fmt/format.h>
+
+#include "Payload/JsonPrinter.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Payload;
+
+namespace {
+
+constexpr std::string_view Bom = "\xEF\xBB\xBF";
+constexpr std::string_view Int64Magnitude = "9223372036854775808";
+constexpr std::string_view Uint64Max = "18446744073709551615";
+constexpr size_t CheckInterval = 64 * 1024;
+
+// NOLINTBEGIN(readability-magic-numbers)
+int hexValue(char c) {
+  if (c >= '0' && c <= '9') { return c - '0'; }
+  if (c >= 'a' && c <= 'f') { return c - 'a' + 10; }
+  if (c >= 'A' && c <= 'F') { return c - 'A' + 10; }
+  return -1;
+}
+
+void appendUtf8(std::string &out, uint32_t point) {
+  if (point < 0x80) {
+    out += static_cast<char>(point);
+  } else if (point < 0x800) {
+    out += static_cast<char>(0xC0U | (point >> 6U));
+    out += static_cast<char>(0x80U | (point & 0x3FU));
+  } else if (point < 0x10000) {
+    out += static_cast<char>(0xE0U | (point >> 12U));
+    out += static_cast<char>(0x80U | ((point >> 6U) & 0x3FU));
+    out += static_cast<char>(0x80U | (point & 0x3FU));
+  } else {
+    out += static_cast<char>(0xF0U | (point >> 18U));
+    out += static_cast<char>(0x80U | ((point >> 12U) & 0x3FU));
+    out += static_cast<char>(0x80U | ((point >> 6U) & 0x3FU));
+    out += static_cast<char>(0x80U | (point & 0x3FU));
+  }
+}
+// NOLINTEND(readability-magic-numbers)
+
+bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Whether an integer without sign fits the range nlohmann keeps exact.
+bool fits(std::string_view digits, std::string_view maximum) {
+  if (digits.size() != maximum.size()) {
+    return digits.size() < maximum.size();
+  }
+  return digits <= maximum;
+}
+
+class Reindent
+{
+public:
+
+  Reindent(
+    std::string_view text,
+    std::string &result,
+    const std::function<bool()> &cancelled
+  ) :
+    mText(text),
+    mPrinter(result),
+    mCancelled(cancelled) //
+  {}
+
+  [[nodiscard]] const std::string &error() const { return mError; }
+
+  bool run() {
+    if (mText.substr(0, Bom.size()) == Bom) { mPos = Bom.size(); }
+
+    bool expectValue = true;
+    while (true) {
+      if (mPos >= mCheck) {
+        mCheck = mPos + CheckInterval;
+        if (mCancelled && mCancelled()) { return fail("Cancelled"); }
+      }
+
+      if (expectValue) {
+        if (!value(expectValue)) { return false; }
+        continue;
+      }
+
+      space();
+      if (mObjects.empty()) {
+        if (mPos != mText.size()) { return fail("Trailing data"); }
+        return true;
+      }
+
+      const bool object = mObjects.back();
+      if (peek() == ',') {
+        ++mPos;
+        if (object && !member()) { return false; }
+        expectValue = true;
+      } else if (peek() == (object ? '}' : ']')) {
+        ++mPos;
+        mObjects.pop_back();
+        mPrinter.end();
+      } else {
+        return fail(object ? "Expected ',' or '}'" : "Expected ',' or ']'");
+      }
+    }
+  }
+
+private:
+
+  std::string_view mText;
+  size_t mPos = 0;
+  size_t mCheck = 0;
+  JsonPrinter mPrinter;
+  const std::function<bool()> &mCancelled;
+  // Whether each open container is an object, the only state kept.
+  std::vector<bool> mObjects;
+  std::string mScratch;
+  std::string mError;
+
+  bool fail(std::string_view message) {
+    mError = fmt::format("{} at offset {}", message, mPos);
+    return false;
+  }
+
+  [[nodiscard]] char peek() const {
+    return mPos == mText.size() ? '\0' : mText[mPos];
+  }
+
+  void space() {
+    while (mPos != mText.size() && isSpace(mText[mPos])) { ++mPos; }
+  }
+
+  // Containers are opened here and left to the main loop, so that nesting
+  // does not recurse.
+  bool value(bool &expectValue) {
+    space();
+    expectValue = false;
+    switch (peek()) {
+      case '{': {
+        ++mPos;
+        mPrinter.beginObject();
+        space();
+        if (peek() == '}') {
+          ++mPos;
+          mPrinter.end();
+          return true;
+        }
+        mObjects.push_back(true);
+        expectValue = true;
+        return member();
+      }
+      case '[': {
+        ++mPos;
+        mPrinter.beginArray();
+        space();
+        if (peek() == ']') {
+          ++mPos;
+          mPrinter.end();
+          return true;
+        }
+        mObjects.push_back(false);
+        expectValue = true;
+        return true;
+      }
+      case '"': return string(false);
+      case 't': return literal("true");
+      case 'f': return literal("false");
+      case 'n': return literal("null");
+      default: {
+        if (peek() == '-' || isDigit(peek())) { return number(); }
+        if (mPos == mText.size()) { return fail("Unexpected end"); }
+        return fail("Unexpected character");
+      }
+    }
+  }
+
+  bool member() {
+    space();
+    if (peek() != '"') { return fail("Expected a key"); }
+    if (!string(true)) { return false; }
+    space();
+    if (peek() != ':') { return fail("Expected ':'"); }
+    ++mPos;
+    return true;
+  }
+
+  bool literal(std::string_view word) {
+    if (mText.substr(mPos, word.size()) != word) {
+      return fail("Invalid literal");
+    }
+    mPos += word.size();
+    mPrinter.verbatim(word);
+    return true;
+  }
+
+  bool number() {
+    const auto begin = mPos;
+    const bool negative = peek() == '-';
+    if (negative) { ++mPos; }
+
+    const auto digitsBegin = mPos;
+    if (peek() == '0') {
+      ++mPos;
+    } else if (isDigit(peek())) {
+      while (isDigit(peek())) { ++mPos; }
+    } else {
+      return fail("Invalid number");
+    }
+    const auto digits = mText.substr(digitsBegin, mPos - digitsBegin);
+
+    bool integer = true;
+    if (peek() == '.') {
+      ++mPos;
+      if (!isDigit(peek())) { return fail("Invalid number"); }
+      while (isDigit(peek())) { ++mPos; }
+      integer = false;
+    }
+    if (peek() == 'e' || peek() == 'E') {
+      ++mPos;
+      if (peek() == '+' || peek() == '-') { ++mPos; }
+      if (!isDigit(peek())) { return fail("Invalid number"); }
+      while (isDigit(peek())) { ++mPos; }
+      integer = false;
+    }
+    const auto token = mText.substr(begin, mPos - begin);
+
+    // Integers are written back as they are, unless they do not fit and
+    // nlohmann would have turned them into floating point.
+    if (integer && fits(digits, negative ? Int64Magnitude : Uint64Max)) {
+      mPrinter.verbatim(token == "-0" ? "0" : token);
+      return true;
+    }
+
+    mScratch.assign(token);
+    const double parsed = std::strtod(mScratch.c_str(), nullptr);
+    if (!std::isfinite(parsed)) {
+      mPos = begin;
+      return fail("Number out of range");
+    }
+    mPrinter.number(parsed);
+    return true;
+  }
+
+  bool string(bool key) {
+    ++mPos;
+    const auto begin = mPos;
+    if (!scan()) { return false; }
+
+    std::string_view content;
+    if (peek() == '"') {
+      content = mText.substr(begin, mPos - begin);
+    } else {
+      mScratch.assign(mText.substr(begin, mPos - begin));
+      if (!unescape()) { return false; }
+      content = mScratch;
+    }
+    ++mPos;
+
+    if (key) {
+      mPrinter.key(content);
+    } else {
+      mPrinter.string(content);
+    }
+    return true;
+  }
+
+  // Goes up to the closing quote or the first escape.
+  bool scan() {
+    constexpr uint8_t AsciiEnd = 0x80;
+    constexpr uint8_t ControlEnd = 0x20;
+    while (true) {
+      if (mPos == mText.size()) { return fail("Unterminated string"); }
+      const auto c = static_cast<uint8_t>(mText[mPos]);
+      if (c == '"' || c == '\\') { return true; }
+      if (c < ControlEnd) { return fail("Control character in string"); }
+      if (c < AsciiEnd) {
+        ++mPos;
+        continue;
+      }
+      const auto length = sequenceLength(mText, mPos);
+      if (length == 0) { return fail("Invalid UTF-8"); }
+      mPos += length;
+    }
+  }
+
+  // Decodes the rest of a string with escapes into the scratch buffer.
+  bool unescape() {
+    while (peek() == '\\') {
+      ++mPos;
+      if (peek() == 'u') {
+        uint32_t point = 0;
+        if (!codePoint(point)) { return false; }
+        appendUtf8(mScratch, point);
+      } else {
+        char decoded = 0;
+        switch (peek()) {
+          case '"': decoded = '"'; break;
+          case '\\': decoded = '\\'; break;
+          case '/': decoded = '/'; break;
+          case 'b': decoded = '\b'; break;
+          case 'f': decoded = '\f'; break;
+          case 'n': decoded = '\n'; break;
+          case 'r': decoded = '\r'; break;
+          case 't': decoded = '\t'; break;
+          default: return fail("Invalid escape");
+        }
+        mScratch += decoded;
+        ++mPos;
+      }
+
+      const auto begin = mPos;
+      if (!scan()) { return false; }
+      mScratch.append(mText.substr(begin, mPos - begin));
+    }
+    return true;
+  }
+
+  // NOLINTBEGIN(readability-magic-numbers)
+  bool codeUnit(uint32_t &unit) {
+    ++mPos;
+    if (mText.size() - mPos < 4) { return fail("Invalid unicode escape"); }
+    unit = 0;
+    for (size_t i = 0; i != 4; ++i) {
+      const int digit = hexValue(mText[mPos + i]);
+      if (digit < 0) { return fail("Invalid unicode escape"); }
+      unit = (unit << 4U) | static_cast<uint32_t>(digit);
+    }
+    mPos += 4;
+    return true;
+  }
+
+  // Surrogates have to come in pairs.
+  bool codePoint(uint32_t &point) {
+    if (!codeUnit(point)) { return false; }
+    if (point >= 0xDC00 && point <= 0xDFFF) {
+      return fail("Unpaired surrogate");
+    }
+    if (point >= 0xD800 && point <= 0xDBFF) {
+      if (mText.substr(mPos, 2) != "\\u") {
+        return fail("Unpaired surrogate");
+      }
+      ++mPos;
+      uint32_t low = 0;
+      if (!codeUnit(low)) { return false; }
+      if (low < 0xDC00 || low > 0xDFFF) { return fail("Unpaired surrogate"); }
+      point = 0x10000 + ((point - 0xD800) << 10U) + (low - 0xDC00);
+    }
+    return true;
+  }
+  // NOLINTEND(readability-magic-numbers)
+};
+
+} // namespace
+
+bool Json::pretty(
+  std::string_view text,
+  std::string &result,
+  std::string &error,
+  const std::function<bool()> &cancelled
+) {
+  result.clear();
+  result.reserve(text.size() * 2);
+  Reindent reindent(text, result, cancelled);
+  if (reindent.run()) { return true; }
+  error = reindent.error();
+  return false;
+}
+
+// NOLINTBEGIN(readability-magic-numbers)
+bool Json::unescape(std::string_view content, std::string &result) {
+  const auto unit = [content](size_t pos, uint32_t &value) {
+    if (content.size() - pos < 4) { return false; }
+    value = 0;
+    for (size_t i = 0; i != 4; ++i) {
+      const int digit = hexValue(content[pos + i]);
+      if (digit < 0) { return false; }
+      value = (value << 4U) | static_cast<uint32_t>(digit);
+    }
+    return true;
+  };
+
+  result.clear();
+  result.reserve(content.size());
+  size_t pos = 0;
+  while (pos != content.size()) {
+    const auto escape = content.find('\\', pos);
+    result.append(content.substr(pos, escape - pos));
+    if (escape == std::string_view::npos) { break; }
+    pos = escape + 1;
+    if (pos == content.size()) { return false; }
+
+    const char c = content[pos++];
+    switch (c) {
+      case '"': result += '"'; break;
+      case '\\': result += '\\'; break;
+      case '/': result += '/'; break;
+      case 'b': result += '\b'; break;
+      case 'f': result += '\f'; break;
+      case 'n': result += '\n'; break;
+      case 'r': result += '\r'; break;
+      case 't': result += '\t'; break;
+      case 'u': {
+        uint32_t point = 0;
+        if (!unit(pos, point)) { return false; }
+        pos += 4;
+        if (point >= 0xDC00 && point <= 0xDFFF) { return false; }
+        if (point >= 0xD800 && point <= 0xDBFF) {
+          uint32_t low = 0;
+          if (content.substr(pos, 2) != "\\u" || !unit(pos + 2, low)) {
+            return false;
+          }
+          if (low < 0xDC00 || low > 0xDFFF) { return false; }
+          pos += 6;
+          point = 0x10000 + ((point - 0xD800) << 10U) + (low - 0xDC00);
+        }
+        appendUtf8(result, point);
+      } break;
+      default: return false;
+    }
+  }
+  return true;
+}
+// NOLINTEND(readability-magic-numbers)
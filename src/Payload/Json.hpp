@@ -0,0 +1,24 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace Rapatas::Transmitron::Payload::Json {
+
+// Lays out a JSON document like nlohmann::json::dump(2), token by token and
+// without building it in memory. Members keep the order of the document. On
+// failure `error` tells the first syntax error and its offset. `cancelled` is
+// polled while going through large documents.
+bool pretty(
+  std::string_view text,
+  std::string &result,
+  std::string &error,
+  const std::function<bool()> &cancelled = {}
+);
+
+// Decodes the escapes in the contents of a string, given without its quotes.
+// False on an invalid escape or an unpaired surrogate.
+bool unescape(std::string_view content, std::string &result);
+
+} // namespace Rapatas::Transmitron::Payload::Json
@@ -0,0 +1,365 @@
+#include "JsonPath.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+#include <fmt/format.h>
+
+#include "Payload/Json.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Payload;
+
+namespace {
+
+constexpr std::string_view Bom = "\xEF\xBB\xBF";
+// Longer tokens are not taken as numbers.
+constexpr size_t NumberLength = 64;
+
+bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// Where a member name written after a dot ends.
+bool isNameEnd(char c) { return c == '.' || c == '['; }
+
+// Continuation bytes of a UTF-8 sequence.
+bool isContinuation(char c) {
+  constexpr uint8_t Mask = 0xC0;
+  constexpr uint8_t Continuation = 0x80;
+  return (static_cast<uint8_t>(c) & Mask) == Continuation;
+}
+
+// Cuts the text at `limit` without splitting a UTF-8 sequence.
+void truncate(std::string &text, size_t limit) {
+  if (text.size() <= limit) { return; }
+  size_t end = limit;
+  while (end != 0 && isContinuation(text[end])) { --end; }
+  text.resize(end);
+}
+
+// Walks the document without validating the parts that are skipped, only
+// enough to know where each value ends.
+class Scanner
+{
+public:
+
+  explicit Scanner(std::string_view text) :
+    mText(text) //
+  {
+    if (mText.substr(0, Bom.size()) == Bom) { mPos = Bom.size(); }
+  }
+
+  [[nodiscard]] size_t pos() const { return mPos; }
+
+  [[nodiscard]] char peek() const {
+    return mPos < mText.size() ? mText[mPos] : '\0';
+  }
+
+  void space() {
+    while (mPos < mText.size() && isSpace(mText[mPos])) { ++mPos; }
+  }
+
+  bool consume(char c) {
+    space();
+    if (peek() != c) { return false; }
+    ++mPos;
+    space();
+    return true;
+  }
+
+  // Goes past the closing quote of the string at the cursor.
+  bool string() {
+    ++mPos;
+    while (mPos < mText.size()) {
+      const auto *const begin = mText.data() + mPos;
+      const auto *const quote = static_cast<const char *>(
+        std::memchr(begin, '"', mText.size() - mPos)
+      );
+      if (quote == nullptr) { break; }
+      mPos = static_cast<size_t>(quote - mText.data()) + 1;
+
+      // The quote is escaped when an odd number of backslashes precede it.
+      size_t backslashes = 0;
+      const auto *before = quote;
+      while (before != begin && *(before - 1) == '\\') {
+        --before;
+        ++backslashes;
+      }
+      if (backslashes % 2 == 0) { return true; }
+    }
+    mPos = mText.size();
+    return false;
+  }
+
+  bool value() {
+    const char c = peek();
+    if (c == '"') { return string(); }
+    if (c == '{' || c == '[') { return container(); }
+
+    const auto begin = mPos;
+    while (mPos < mText.size()) {
+      const char next = mText[mPos];
+      if (next == ',' || next == '}' || next == ']' || isSpace(next)) {
+        break;
+      }
+      ++mPos;
+    }
+    return mPos != begin;
+  }
+
+  // Reads the key of the member at the cursor, up to its value.
+  bool key(std::string_view &result) {
+    if (peek() != '"') { return false; }
+    const auto begin = mPos + 1;
+    if (!string()) { return false; }
+    result = mText.substr(begin, mPos - 1 - begin);
+    return consume(':');
+  }
+
+private:
+
+  std::string_view mText;
+  size_t mPos = 0;
+
+  bool container() {
+    size_t depth = 0;
+    while (mPos < mText.size()) {
+      switch (mText[mPos]) {
+        case '"': {
+          if (!string()) { return false; }
+          continue;
+        }
+        case '{':
+        case '[': {
+          ++depth;
+        } break;
+        case '}':
+        case ']': {
+          --depth;
+          if (depth == 0) {
+            ++mPos;
+            return true;
+          }
+        } break;
+        default: {
+        }
+      }
+      ++mPos;
+    }
+    return false;
+  }
+};
+
+bool keyMatches(std::string_view key, const std::string &name) {
+  if (key.find('\\') == std::string_view::npos) { return key == name; }
+  std::string decoded;
+  return Json::unescape(key, decoded) && decoded == name;
+}
+
+} // namespace
+
+bool JsonPath::parse(std::string_view expression, std::string &error) {
+  mExpression.assign(expression);
+  mSegments.clear();
+
+  const auto fail = [&error](std::string_view message, size_t offset) {
+    error = fmt::format("{} at offset {}", message, offset);
+    return false;
+  };
+
+  size_t pos = 0;
+  if (!expression.empty() && expression.front() == '$') { ++pos; }
+
+  while (pos != expression.size()) {
+    const char c = expression[pos];
+    Segment segment;
+
+    if (c == '[') {
+      ++pos;
+      const char quote = pos < expression.size() ? expression[pos] : '\0';
+      if (quote == '\'' || quote == '"') {
+        ++pos;
+        while (pos < expression.size() && expression[pos] != quote) {
+          if (expression[pos] == '\\' && pos + 1 < expression.size()) {
+            ++pos;
+          }
+          segment.name += expression[pos];
+          ++pos;
+        }
+        if (pos == expression.size()) {
+          return fail("Unterminated name", pos);
+        }
+        ++pos;
+      } else {
+        const auto begin = pos;
+        while (pos < expression.size() && isDigit(expression[pos])) {
+          constexpr size_t Base = 10;
+          const auto digit = static_cast<size_t>(expression[pos] - '0');
+          segment.index = segment.index * Base + digit;
+          ++pos;
+        }
+        if (pos == begin) { return fail("Expected an index or a name", pos); }
+        segment.member = false;
+      }
+      if (pos == expression.size() || expression[pos] != ']') {
+        return fail("Expected ']'", pos);
+      }
+      ++pos;
+    } else {
+      // The leading dot may be left out when the path starts with a name.
+      if (c == '.') {
+        ++pos;
+      } else if (pos != 0) {
+        return fail("Expected '.' or '['", pos);
+      }
+      const auto begin = pos;
+      while (pos < expression.size() && !isNameEnd(expression[pos])) {
+        ++pos;
+      }
+      if (pos == begin) { return fail("Empty name", pos); }
+      segment.name.assign(expression.substr(begin, pos - begin));
+    }
+
+    mSegments.push_back(std::move(segment));
+  }
+
+  return true;
+}
+
+bool JsonPath::parseList(
+  std::string_view text,
+  std::vector<JsonPath> &paths,
+  std::string &error
+) {
+  paths.clear();
+  char quote = '\0';
+  size_t begin = 0;
+  for (size_t i = 0; i <= text.size(); ++i) {
+    const char c = i == text.size() ? ',' : text[i];
+    if (quote != '\0') {
+      if (c == quote) { quote = '\0'; }
+      continue;
+    }
+    if (c == '\'' || c == '"') {
+      quote = c;
+      continue;
+    }
+    if (c != ',') { continue; }
+
+    const auto expression = text.substr(begin, i - begin);
+    const auto first = expression.find_first_not_of(' ');
+    const auto last = expression.find_last_not_of(' ');
+    if (first != std::string_view::npos) {
+      const auto trimmed = expression.substr(first, last + 1 - first);
+      JsonPath path;
+      std::string reason;
+      if (!path.parse(trimmed, reason)) {
+        error = fmt::format("{} in '{}'", reason, trimmed);
+        return false;
+      }
+      paths.push_back(std::move(path));
+    }
+    begin = i + 1;
+  }
+  return true;
+}
+
+bool JsonPath::find(std::string_view document, std::string_view &token) const {
+  Scanner scanner(document);
+  scanner.space();
+
+  for (const auto &segment : mSegments) {
+    if (segment.member) {
+      if (!scanner.consume('{')) { return false; }
+      while (true) {
+        std::string_view key;
+        if (!scanner.key(key)) { return false; }
+        if (keyMatches(key, segment.name)) { break; }
+        if (!scanner.value() || !scanner.consume(',')) { return false; }
+      }
+    } else {
+      if (!scanner.consume('[')) { return false; }
+      if (scanner.peek() == ']') { return false; }
+      for (size_t i = 0; i != segment.index; ++i) {
+        if (!scanner.value() || !scanner.consume(',')) { return false; }
+      }
+    }
+  }
+
+  const auto begin = scanner.pos();
+  if (!scanner.value()) { return false; }
+  token = document.substr(begin, scanner.pos() - begin);
+  return true;
+}
+
+bool JsonPath::number(std::string_view document, double &value) const {
+  std::string_view token;
+  if (!find(document, token)) { return false; }
+
+  if (token == "true" || token == "false") {
+    value = token == "true" ? 1 : 0;
+    return true;
+  }
+  if (token.size() >= 2 && token.front() == '"') {
+    token = token.substr(1, token.size() - 2);
+  }
+  if (token.empty() || token.size() >= NumberLength) { return false; }
+
+  std::array<char, NumberLength> buffer{};
+  std::memcpy(buffer.data(), token.data(), token.size());
+  char *end = nullptr;
+  value = std::strtod(buffer.data(), &end);
+  return end == buffer.data() + token.size() && std::isfinite(value);
+}
+
+void JsonPath::text(
+  std::string_view token,
+  size_t limit,
+  std::string &result
+) {
+  result.clear();
+  if (token.empty()) { return; }
+
+  if (token.front() == '"') {
+    const auto content = token.substr(1, token.size() - 2);
+    if (!Json::unescape(content, result)) { result.assign(content); }
+  } else if (token.front() == '{' || token.front() == '[') {
+    bool quoted = false;
+    bool escaped = false;
+    for (const char c : token) {
+      if (result.size() > limit) { break; }
+      if (quoted) {
+        if (escaped) {
+          escaped = false;
+        } else if (c == '\\') {
+          escaped = true;
+        } else if (c == '"') {
+          quoted = false;
+        }
+      } else if (c == '"') {
+        quoted = true;
+      } else if (isSpace(c)) {
+        continue;
+      }
+      result += c;
+    }
+  } else {
+    result.assign(token.substr(0, limit + 1));
+  }
+
+  truncate(result, limit);
+}
+
+const std::string &JsonPath::expression() const { return mExpression; }
+
+std::string JsonPath::label() const {
+  if (mSegments.empty()) { return "$"; }
+  const auto &last = mSegments.back();
+  if (last.member) { return last.name; }
+  return fmt::format("[{}]", last.index);
+}
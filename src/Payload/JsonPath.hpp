@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Rapatas::Transmitron::Payload {
+
+// A path to one value of a JSON document, like `$.sensor.temp`,
+// `$.readings[0]` or `$['key with spaces']`. Values are found by skipping
+// over the parts of the document that are not on the path, without parsing
+// them.
+class JsonPath
+{
+public:
+
+  // On failure `error` tells what is wrong and at which offset.
+  bool parse(std::string_view expression, std::string &error);
+  // Paths separated by commas, except for commas in quoted names.
+  static bool parseList(
+    std::string_view text,
+    std::vector<JsonPath> &paths,
+    std::string &error
+  );
+
+  // The value as written in the document, strings with their quotes. False
+  // when the document has no value at the path or is malformed on the way.
+  bool find(std::string_view document, std::string_view &token) const;
+  // The number at the path. Booleans count as 0 and 1, and strings holding a
+  // number as that number.
+  bool number(std::string_view document, double &value) const;
+
+  // Strings are unescaped, objects and arrays lose their whitespace and
+  // everything stops at `limit` bytes.
+  static void text(std::string_view token, size_t limit, std::string &result);
+
+  [[nodiscard]] const std::string &expression() const;
+  // The last member name or index, to tell the value apart.
+  [[nodiscard]] std::string label() const;
+
+private:
+
+  struct Segment {
+    std::string name;
+    size_t index = 0;
+    bool member = true;
+  };
+
+  std::string mExpression;
+  std::vector<Segment> mSegments;
+};
+
+} // namespace Rapatas::Transmitron::Payload
@@ -0,0 +1,184 @@
+#include "JsonPrinter.hpp"
+
+#include <iterator>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+using namespace Rapatas::Transmitron;
+using namespace Payload;
+
+namespace {
+
+constexpr size_t IndentWidth = 2;
+constexpr std::string_view Replacement = "\\ufffd";
+constexpr std::string_view HexDigits = "0123456789abcdef";
+
+} // namespace
+
+size_t Payload::sequenceLength(std::string_view text, size_t pos) {
+  // NOLINTBEGIN(readability-magic-numbers)
+  const auto lead = static_cast<uint8_t>(text[pos]);
+  size_t length = 0;
+  uint32_t minimum = 0;
+  if ((lead & 0xE0U) == 0xC0U) {
+    length = 2;
+    minimum = 0x80;
+  } else if ((lead & 0xF0U) == 0xE0U) {
+    length = 3;
+    minimum = 0x800;
+  } else if ((lead & 0xF8U) == 0xF0U) {
+    length = 4;
+    minimum = 0x10000;
+  } else {
+    return 0;
+  }
+  if (text.size() - pos < length) { return 0; }
+
+  uint32_t point = lead & (0x7FU >> length);
+  for (size_t i = 1; i != length; ++i) {
+    const auto next = static_cast<uint8_t>(text[pos + i]);
+    if ((next & 0xC0U) != 0x80U) { return 0; }
+    point = (point << 6U) | (next & 0x3FU);
+  }
+  if (point < minimum || point > 0x10FFFF) { return 0; }
+  if (point >= 0xD800 && point <= 0xDFFF) { return 0; }
+  // NOLINTEND(readability-magic-numbers)
+  return length;
+}
+
+JsonPrinter::JsonPrinter(std::string &out, bool pretty) :
+  mOut(out),
+  mPretty(pretty) //
+{}
+
+void JsonPrinter::beginObject() {
+  separate();
+  mOut += '{';
+  mFrames.push_back({true, 0});
+}
+
+void JsonPrinter::beginArray() {
+  separate();
+  mOut += '[';
+  mFrames.push_back({false, 0});
+}
+
+void JsonPrinter::end() {
+  if (mFrames.empty()) { return; }
+  const auto frame = mFrames.back();
+  mFrames.pop_back();
+  if (frame.count != 0) { newline(mFrames.size()); }
+  mOut += frame.object ? '}' : ']';
+}
+
+void JsonPrinter::key(std::string_view text) {
+  separate();
+  quoted(text);
+  mOut += mPretty ? ": " : ":";
+  mAfterKey = true;
+}
+
+void JsonPrinter::string(std::string_view text) {
+  separate();
+  quoted(text);
+}
+
+void JsonPrinter::boolean(bool value) {
+  separate();
+  mOut += value ? "true" : "false";
+}
+
+void JsonPrinter::null() {
+  separate();
+  mOut += "null";
+}
+
+void JsonPrinter::number(int64_t value) {
+  separate();
+  fmt::format_to(std::back_inserter(mOut), "{}", value);
+}
+
+void JsonPrinter::number(uint64_t value) {
+  separate();
+  fmt::format_to(std::back_inserter(mOut), "{}", value);
+}
+
+void JsonPrinter::number(double value) {
+  // The shortest form that reads back is not unique, the one of nlohmann is
+  // used so that both ways of formatting agree.
+  separate();
+  mOut += nlohmann::json(value).dump();
+}
+
+void JsonPrinter::verbatim(std::string_view token) {
+  separate();
+  mOut.append(token);
+}
+
+void JsonPrinter::separate() {
+  if (mAfterKey) {
+    mAfterKey = false;
+    return;
+  }
+  if (mFrames.empty()) { return; }
+  if (mFrames.back().count++ != 0) { mOut += ','; }
+  newline(mFrames.size());
+}
+
+void JsonPrinter::newline(size_t depth) {
+  if (!mPretty) { return; }
+  mOut += '\n';
+  mOut.append(depth * IndentWidth, ' ');
+}
+
+void JsonPrinter::quoted(std::string_view text) {
+  constexpr uint8_t AsciiEnd = 0x80;
+  constexpr uint8_t ControlEnd = 0x20;
+  constexpr unsigned Nibble = 4;
+  constexpr uint8_t NibbleMask = 0xF;
+
+  mOut += '"';
+  size_t pos = 0;
+  while (pos != text.size()) {
+    // Most of a string needs no escaping, it is copied in one go.
+    const auto begin = pos;
+    while (pos != text.size()) {
+      const auto c = static_cast<uint8_t>(text[pos]);
+      if (c < ControlEnd || c >= AsciiEnd || c == '"' || c == '\\') { break; }
+      ++pos;
+    }
+    mOut.append(text.substr(begin, pos - begin));
+    if (pos == text.size()) { break; }
+
+    const auto c = static_cast<uint8_t>(text[pos]);
+    if (c >= AsciiEnd) {
+      const auto length = sequenceLength(text, pos);
+      if (length == 0) {
+        mOut += Replacement;
+        ++pos;
+      } else {
+        mOut.append(text.substr(pos, length));
+        pos += length;
+      }
+      continue;
+    }
+
+    switch (c) {
+      case '"': mOut += "\\\""; break;
+      case '\\': mOut += "\\\\"; break;
+      case '\b': mOut += "\\b"; break;
+      case '\f': mOut += "\\f"; break;
+      case '\n': mOut += "\\n"; break;
+      case '\r': mOut += "\\r"; break;
+      case '\t': mOut += "\\t"; break;
+      default: {
+        mOut += "\\u00";
+        mOut += HexDigits[c >> Nibble];
+        mOut += HexDigits[c & NibbleMask];
+      }
+    }
+    ++pos;
+  }
+  mOut += '"';
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Rapatas::Transmitron::Payload {
+
+// Writes JSON one value at a time, laid out like nlohmann::json::dump(2) or
+// compact. Strings are escaped and invalid UTF-8 is replaced.
+class JsonPrinter
+{
+public:
+
+  explicit JsonPrinter(std::string &out, bool pretty = true);
+
+  void beginObject();
+  void beginArray();
+  void end();
+
+  void key(std::string_view text);
+  void string(std::string_view text);
+  void boolean(bool value);
+  void null();
+  void number(int64_t value);
+  void number(uint64_t value);
+  void number(double value);
+
+  // Writes a scalar that is already valid JSON, as it is.
+  void verbatim(std::string_view token);
+
+private:
+
+  struct Frame {
+    bool object = false;
+    size_t count = 0;
+  };
+
+  std::string &mOut;
+  bool mPretty;
+  std::vector<Frame> mFrames;
+  bool mAfterKey = false;
+
+  void separate();
+  void newline(size_t depth);
+  void quoted(std::string_view text);
+};
+
+// Length of the UTF-8 sequence at `pos`, zero when it is not valid.
+size_t sequenceLength(std::string_view text, size_t pos);
+
+} // namespace Rapatas::Transmitron::Payload
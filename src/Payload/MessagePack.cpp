@@ -0,0 +1,244 @@
+#include "MessagePack.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace Rapatas::Transmitron;
+using namespace Payload;
+
+namespace {
+
+constexpr uint8_t PositiveFixIntEnd = 0x7F;
+constexpr uint8_t FixMapEnd = 0x8F;
+constexpr uint8_t FixArrayEnd = 0x9F;
+constexpr uint8_t FixStrBegin = 0xA0;
+constexpr uint8_t FixStrEnd = 0xBF;
+constexpr uint8_t Str8 = 0xD9;
+constexpr uint8_t Str32 = 0xDB;
+constexpr uint8_t NegativeFixIntBegin = 0xE0;
+constexpr uint8_t FixMask = 0x0F;
+constexpr uint8_t FixStrMask = 0x1F;
+
+class Decoding : public Decoder
+{
+public:
+
+  using Decoder::Decoder;
+
+  bool run() { return item(0) && finish(); }
+
+private:
+
+  bool item(size_t depth) {
+    if (!enter(depth)) { return false; }
+
+    uint8_t type = 0;
+    if (!byte(type)) { return false; }
+
+    if (type <= PositiveFixIntEnd) {
+      mOutput->number(static_cast<uint64_t>(type));
+      return true;
+    }
+    if (type >= NegativeFixIntBegin) {
+      mOutput->number(static_cast<int64_t>(static_cast<int8_t>(type)));
+      return true;
+    }
+    if (type <= FixMapEnd) { return map(type & FixMask, depth); }
+    if (type <= FixArrayEnd) { return array(type & FixMask, depth); }
+    if (type <= FixStrEnd) { return string(type & FixStrMask); }
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    switch (type) {
+      case 0xC0: mOutput->null(); return true;
+      case 0xC2: mOutput->boolean(false); return true;
+      case 0xC3: mOutput->boolean(true); return true;
+      case 0xC4: return bin(1);
+      case 0xC5: return bin(2);
+      case 0xC6: return bin(4);
+      case 0xC7: return ext(1);
+      case 0xC8: return ext(2);
+      case 0xC9: return ext(4);
+      case 0xCA: return float32();
+      case 0xCB: return float64();
+      case 0xCC: return unsignedInt(1);
+      case 0xCD: return unsignedInt(2);
+      case 0xCE: return unsignedInt(4);
+      case 0xCF: return unsignedInt(8);
+      case 0xD0: return signedInt(1);
+      case 0xD1: return signedInt(2);
+      case 0xD2: return signedInt(4);
+      case 0xD3: return signedInt(8);
+      case 0xD4: return fixExt(1);
+      case 0xD5: return fixExt(2);
+      case 0xD6: return fixExt(4);
+      case 0xD7: return fixExt(8);
+      case 0xD8: return fixExt(16);
+      case 0xD9: return sizedString(1);
+      case 0xDA: return sizedString(2);
+      case 0xDB: return sizedString(4);
+      case 0xDC: return sizedArray(2, depth);
+      case 0xDD: return sizedArray(4, depth);
+      case 0xDE: return sizedMap(2, depth);
+      case 0xDF: return sizedMap(4, depth);
+      default: return fail("Invalid type 0xC1");
+    }
+    // NOLINTEND(readability-magic-numbers)
+  }
+
+  bool array(uint64_t count, size_t depth) {
+    mOutput->beginArray();
+    // Every item takes at least a byte, a bogus count fails at the end.
+    for (uint64_t i = 0; i != count; ++i) {
+      if (!item(depth + 1)) { return false; }
+    }
+    mOutput->end();
+    return true;
+  }
+
+  bool map(uint64_t count, size_t depth) {
+    mOutput->beginObject();
+    for (uint64_t i = 0; i != count; ++i) {
+      if (!key(depth + 1) || !item(depth + 1)) { return false; }
+    }
+    mOutput->end();
+    return true;
+  }
+
+  // JSON keys are strings, other keys are written as their compact JSON.
+  bool key(size_t depth) {
+    if (mPos == mData.size()) { return fail("Unexpected end"); }
+
+    const auto type = static_cast<uint8_t>(mData[mPos]);
+    uint64_t length = 0;
+    if (type >= FixStrBegin && type <= FixStrEnd) {
+      ++mPos;
+      length = type & FixStrMask;
+    } else if (type >= Str8 && type <= Str32) {
+      ++mPos;
+      if (!bigEndian(size_t{1} << (type - Str8), length)) { return false; }
+    } else {
+      std::string text;
+      JsonPrinter compact(text, false);
+      auto *output = mOutput;
+      mOutput = &compact;
+      const bool decoded = item(depth);
+      mOutput = output;
+      if (!decoded) { return false; }
+      mOutput->key(text);
+      return true;
+    }
+
+    std::string_view text;
+    if (!take(length, text)) { return false; }
+    mOutput->key(text);
+    return true;
+  }
+
+  bool sizedArray(size_t lengthBytes, size_t depth) {
+    uint64_t count = 0;
+    return bigEndian(lengthBytes, count) && array(count, depth);
+  }
+
+  bool sizedMap(size_t lengthBytes, size_t depth) {
+    uint64_t count = 0;
+    return bigEndian(lengthBytes, count) && map(count, depth);
+  }
+
+  bool string(uint64_t length) {
+    std::string_view text;
+    if (!take(length, text)) { return false; }
+    mOutput->string(text);
+    return true;
+  }
+
+  bool sizedString(size_t lengthBytes) {
+    uint64_t length = 0;
+    return bigEndian(lengthBytes, length) && string(length);
+  }
+
+  bool bin(size_t lengthBytes) {
+    uint64_t length = 0;
+    std::string_view bytes;
+    if (!bigEndian(lengthBytes, length) || !take(length, bytes)) {
+      return false;
+    }
+    binary(bytes);
+    return true;
+  }
+
+  bool ext(size_t lengthBytes) {
+    uint64_t length = 0;
+    return bigEndian(lengthBytes, length) && extension(length);
+  }
+
+  bool fixExt(uint64_t length) { return extension(length); }
+
+  // Extensions are application defined, they are shown as their type and
+  // raw bytes.
+  bool extension(uint64_t length) {
+    uint8_t type = 0;
+    std::string_view bytes;
+    if (!byte(type) || !take(length, bytes)) { return false; }
+    mOutput->beginObject();
+    mOutput->key("ext");
+    mOutput->number(static_cast<int64_t>(static_cast<int8_t>(type)));
+    mOutput->key("data");
+    binary(bytes);
+    mOutput->end();
+    return true;
+  }
+
+  bool unsignedInt(size_t bytes) {
+    uint64_t value = 0;
+    if (!bigEndian(bytes, value)) { return false; }
+    mOutput->number(value);
+    return true;
+  }
+
+  bool signedInt(size_t bytes) {
+    uint64_t value = 0;
+    if (!bigEndian(bytes, value)) { return false; }
+    // Sign extension of the narrower types.
+    const auto unused = (sizeof(uint64_t) - bytes)
+      * std::numeric_limits<uint8_t>::digits;
+    const auto shifted = static_cast<int64_t>(value << unused);
+    mOutput->number(shifted >> unused);
+    return true;
+  }
+
+  bool float32() {
+    uint64_t bits = 0;
+    if (!bigEndian(sizeof(float), bits)) { return false; }
+    const auto narrow = static_cast<uint32_t>(bits);
+    float value = 0;
+    std::memcpy(&value, &narrow, sizeof(value));
+    mOutput->number(static_cast<double>(value));
+    return true;
+  }
+
+  bool float64() {
+    uint64_t bits = 0;
+    if (!bigEndian(sizeof(double), bits)) { return false; }
+    double value = 0;
+    std::memcpy(&value, &bits, sizeof(value));
+    mOutput->number(value);
+    return true;
+  }
+};
+
+} // namespace
+
+bool MessagePack::toJson(
+  std::string_view data,
+  std::string &result,
+  std::string &error,
+  const std::function<bool()> &cancelled,
+  const Limits &limits
+) {
+  result.clear();
+  result.reserve(std::min(data.size() * 3, limits.maxOutput));
+  Decoding decoding(data, result, cancelled, limits);
+  if (decoding.run()) { return true; }
+  error = decoding.error();
+  return false;
+}
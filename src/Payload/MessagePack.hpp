@@ -0,0 +1,22 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "Payload/Decoder.hpp"
+
+namespace Rapatas::Transmitron::Payload::MessagePack {
+
+// Decodes a MessagePack payload straight into pretty printed JSON. On failure
+// `error` tells what was wrong and where. `cancelled` is polled while going
+// through large payloads.
+bool toJson(
+  std::string_view data,
+  std::string &result,
+  std::string &error,
+  const std::function<bool()> &cancelled = {},
+  const Limits &limits = {}
+);
+
+} // namespace Rapatas::Transmitron::Payload::MessagePack
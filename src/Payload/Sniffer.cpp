@@ -0,0 +1,667 @@
+#include "Sniffer.hpp"
+
+#include <cstring>
+#include <limits>
+
+using namespace Rapatas::Transmitron;
+using namespace Payload;
+
+namespace {
+
+constexpr size_t SniffLimit = 64 * 1024;
+// Checking a kind detected earlier looks at less than detecting it.
+constexpr size_t PlausibleLimit = 4 * 1024;
+constexpr size_t MaxDepth = 64;
+constexpr std::string_view ByteOrderMark = "\xEF\xBB\xBF";
+constexpr std::string_view GzipMagic = "\x1F\x8B\x08";
+constexpr uint8_t AsciiEnd = 0x80;
+constexpr uint8_t ControlEnd = 0x20;
+constexpr uint8_t Delete = 0x7F;
+
+enum class Result : uint8_t {
+  Ok,
+  // Ran out of data before the structure was complete.
+  End,
+  Error,
+};
+
+bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+bool isAlpha(char c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+std::string_view trimmed(std::string_view data) {
+  if (data.substr(0, ByteOrderMark.size()) == ByteOrderMark) {
+    data.remove_prefix(ByteOrderMark.size());
+  }
+  size_t pos = 0;
+  while (pos != data.size() && isSpace(data[pos])) { ++pos; }
+  return data.substr(pos);
+}
+
+bool isMessagePackContainer(uint8_t first) {
+  constexpr uint8_t FixMapBegin = 0x80;
+  constexpr uint8_t FixArrayEnd = 0x9F;
+  constexpr uint8_t Array16 = 0xDC;
+  constexpr uint8_t Map32 = 0xDF;
+  return (first >= FixMapBegin && first <= FixArrayEnd)
+    || (first >= Array16 && first <= Map32);
+}
+
+bool isCborContainer(std::string_view data) {
+  constexpr uint8_t ArrayBegin = 0x80;
+  constexpr uint8_t MapEnd = 0xBF;
+  constexpr std::string_view SelfDescribe = "\xD9\xD9\xF7";
+  const auto first = static_cast<uint8_t>(data.front());
+  return (first >= ArrayBegin && first <= MapEnd)
+    || data.substr(0, SelfDescribe.size()) == SelfDescribe;
+}
+
+// Walks the structure of a prefix of the payload without decoding it.
+// `truncated` tells whether the payload goes on past the prefix.
+class Scanner
+{
+public:
+
+  Scanner(std::string_view data, bool truncated) :
+    mData(data),
+    mTruncated(truncated) //
+  {}
+
+  // Whether the prefix holds nothing that rules out the format.
+  [[nodiscard]] bool accepts(Result result) const {
+    return result == Result::Ok || (result == Result::End && mTruncated);
+  }
+
+protected:
+
+  std::string_view mData;
+  bool mTruncated;
+  size_t mPos = 0;
+
+  [[nodiscard]] bool atEnd() const { return mPos == mData.size(); }
+
+  Result skip(uint64_t count) {
+    if (mData.size() - mPos < count) {
+      mPos = mData.size();
+      return Result::End;
+    }
+    mPos += static_cast<size_t>(count);
+    return Result::Ok;
+  }
+
+  bool byte(uint8_t &value) {
+    if (atEnd()) { return false; }
+    value = static_cast<uint8_t>(mData[mPos++]);
+    return true;
+  }
+
+  Result bigEndian(size_t bytes, uint64_t &value) {
+    value = 0;
+    for (size_t i = 0; i != bytes; ++i) {
+      uint8_t next = 0;
+      if (!byte(next)) { return Result::End; }
+      value = (value << std::numeric_limits<uint8_t>::digits) | next;
+    }
+    return Result::Ok;
+  }
+};
+
+class JsonScanner : public Scanner
+{
+public:
+
+  using Scanner::Scanner;
+
+  Result document() {
+    const auto result = value(0);
+    if (result != Result::Ok) { return result; }
+    skipSpace();
+    return atEnd() ? Result::Ok : Result::Error;
+  }
+
+private:
+
+  void skipSpace() {
+    while (!atEnd() && isSpace(mData[mPos])) { ++mPos; }
+  }
+
+  Result value(size_t depth) {
+    // Deeper than this is not worth checking, it is accepted like the end
+    // of a prefix.
+    if (depth == MaxDepth) {
+      mTruncated = true;
+      mPos = mData.size();
+      return Result::End;
+    }
+
+    skipSpace();
+    if (atEnd()) { return Result::End; }
+    switch (mData[mPos]) {
+      case '{': return container(depth, '}', true);
+      case '[': return container(depth, ']', false);
+      case '"': return string();
+      case 't': return literal("true");
+      case 'f': return literal("false");
+      case 'n': return literal("null");
+      default: return number();
+    }
+  }
+
+  Result container(size_t depth, char close, bool object) {
+    ++mPos;
+    skipSpace();
+    if (atEnd()) { return Result::End; }
+    if (mData[mPos] == close) {
+      ++mPos;
+      return Result::Ok;
+    }
+
+    while (true) {
+      if (object) {
+        skipSpace();
+        if (atEnd()) { return Result::End; }
+        if (mData[mPos] != '"') { return Result::Error; }
+        const auto key = string();
+        if (key != Result::Ok) { return key; }
+        skipSpace();
+        if (atEnd()) { return Result::End; }
+        if (mData[mPos++] != ':') { return Result::Error; }
+      }
+
+      const auto result = value(depth + 1);
+      if (result != Result::Ok) { return result; }
+
+      skipSpace();
+      if (atEnd()) { return Result::End; }
+      const char next = mData[mPos++];
+      if (next == close) { return Result::Ok; }
+      if (next != ',') { return Result::Error; }
+    }
+  }
+
+  Result string() {
+    ++mPos;
+    while (!atEnd()) {
+      const auto c = static_cast<uint8_t>(mData[mPos++]);
+      if (c == '"') { return Result::Ok; }
+      if (c < ControlEnd) { return Result::Error; }
+      if (c == '\\') {
+        if (atEnd()) { return Result::End; }
+        ++mPos;
+      }
+    }
+    return Result::End;
+  }
+
+  Result literal(std::string_view word) {
+    const auto available = mData.substr(mPos, word.size());
+    if (word.substr(0, available.size()) != available) { return Result::Error; }
+    mPos += available.size();
+    return available.size() == word.size() ? Result::Ok : Result::End;
+  }
+
+  // A sign, an integer without leading zeros, then optionally a fraction
+  // and an exponent, each with at least a digit.
+  Result number() {
+    if (mData[mPos] == '-') { ++mPos; }
+    if (atEnd()) { return Result::End; }
+    if (mData[mPos] == '0') {
+      ++mPos;
+    } else if (digits() == 0) {
+      return Result::Error;
+    }
+
+    if (!atEnd() && mData[mPos] == '.') {
+      ++mPos;
+      if (digits() == 0) { return atEnd() ? Result::End : Result::Error; }
+    }
+
+    if (!atEnd() && (mData[mPos] == 'e' || mData[mPos] == 'E')) {
+      ++mPos;
+      if (!atEnd() && (mData[mPos] == '+' || mData[mPos] == '-')) { ++mPos; }
+      if (digits() == 0) { return atEnd() ? Result::End : Result::Error; }
+    }
+
+    if (atEnd() && mTruncated) { return Result::End; }
+    return Result::Ok;
+  }
+
+  size_t digits() {
+    const auto begin = mPos;
+    while (!atEnd() && isDigit(mData[mPos])) { ++mPos; }
+    return mPos - begin;
+  }
+};
+
+class MessagePackScanner : public Scanner
+{
+public:
+
+  using Scanner::Scanner;
+
+  Result document() {
+    const auto result = item(0);
+    if (result != Result::Ok) { return result; }
+    return atEnd() ? Result::Ok : Result::Error;
+  }
+
+private:
+
+  Result item(size_t depth) {
+    if (depth == MaxDepth) { return Result::Error; }
+
+    uint8_t type = 0;
+    if (!byte(type)) { return Result::End; }
+
+    constexpr uint8_t PositiveFixIntEnd = 0x7F;
+    constexpr uint8_t FixMapEnd = 0x8F;
+    constexpr uint8_t FixArrayEnd = 0x9F;
+    constexpr uint8_t FixStrEnd = 0xBF;
+    constexpr uint8_t NegativeFixIntBegin = 0xE0;
+    constexpr uint8_t FixMask = 0x0F;
+    constexpr uint8_t FixStrMask = 0x1F;
+
+    if (type <= PositiveFixIntEnd || type >= NegativeFixIntBegin) {
+      return Result::Ok;
+    }
+    if (type <= FixMapEnd) { return items(2ULL * (type & FixMask), depth); }
+    if (type <= FixArrayEnd) { return items(type & FixMask, depth); }
+    if (type <= FixStrEnd) { return skip(type & FixStrMask); }
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    switch (type) {
+      case 0xC0:
+      case 0xC2:
+      case 0xC3: return Result::Ok;
+      case 0xC4:
+      case 0xD9: return sized(1, 0);
+      case 0xC5:
+      case 0xDA: return sized(2, 0);
+      case 0xC6:
+      case 0xDB: return sized(4, 0);
+      case 0xC7: return sized(1, 1);
+      case 0xC8: return sized(2, 1);
+      case 0xC9: return sized(4, 1);
+      case 0xCC:
+      case 0xD0: return skip(1);
+      case 0xCD:
+      case 0xD1: return skip(2);
+      case 0xCA:
+      case 0xCE:
+      case 0xD2: return skip(4);
+      case 0xCB:
+      case 0xCF:
+      case 0xD3: return skip(8);
+      case 0xD4: return skip(2);
+      case 0xD5: return skip(3);
+      case 0xD6: return skip(5);
+      case 0xD7: return skip(9);
+      case 0xD8: return skip(17);
+      case 0xDC: return counted(2, 1, depth);
+      case 0xDD: return counted(4, 1, depth);
+      case 0xDE: return counted(2, 2, depth);
+      case 0xDF: return counted(4, 2, depth);
+      default: return Result::Error;
+    }
+    // NOLINTEND(readability-magic-numbers)
+  }
+
+  Result sized(size_t lengthBytes, size_t extra) {
+    uint64_t length = 0;
+    const auto result = bigEndian(lengthBytes, length);
+    if (result != Result::Ok) { return result; }
+    return skip(length + extra);
+  }
+
+  Result counted(size_t lengthBytes, uint64_t perEntry, size_t depth) {
+    uint64_t count = 0;
+    const auto result = bigEndian(lengthBytes, count);
+    if (result != Result::Ok) { return result; }
+    return items(count * perEntry, depth);
+  }
+
+  Result items(uint64_t count, size_t depth) {
+    // Every item takes at least a byte, so this stops at the end of data.
+    for (uint64_t i = 0; i != count; ++i) {
+      const auto result = item(depth + 1);
+      if (result != Result::Ok) { return result; }
+    }
+    return Result::Ok;
+  }
+};
+
+class CborScanner : public Scanner
+{
+public:
+
+  using Scanner::Scanner;
+
+  Result document() {
+    const auto result = item(0);
+    if (result != Result::Ok) { return result; }
+    return atEnd() ? Result::Ok : Result::Error;
+  }
+
+private:
+
+  static constexpr uint8_t MajorShift = 5;
+  static constexpr uint8_t InfoMask = 0x1F;
+  static constexpr uint8_t Indefinite = 31;
+  static constexpr uint8_t Break = 0xFF;
+
+  enum Major : uint8_t {
+    Unsigned,
+    Negative,
+    Bytes,
+    Text,
+    Array,
+    Map,
+    Tag,
+    Simple,
+  };
+
+  Result argument(uint8_t info, uint64_t &value) {
+    constexpr uint8_t Direct = 24;
+    constexpr uint8_t Reserved = 28;
+    if (info < Direct) {
+      value = info;
+      return Result::Ok;
+    }
+    if (info >= Reserved) { return Result::Error; }
+    return bigEndian(size_t{1} << (info - Direct), value);
+  }
+
+  Result item(size_t depth) {
+    if (depth == MaxDepth) { return Result::Error; }
+
+    uint8_t initial = 0;
+    if (!byte(initial)) { return Result::End; }
+    const auto major = static_cast<Major>(initial >> MajorShift);
+    const auto info = static_cast<uint8_t>(initial & InfoMask);
+
+    if (info == Indefinite) {
+      switch (major) {
+        case Bytes:
+        case Text: return chunks(major);
+        case Array:
+        case Map: return untilBreak(depth);
+        default: return Result::Error;
+      }
+    }
+
+    uint64_t value = 0;
+    const auto result = argument(info, value);
+    if (result != Result::Ok) { return result; }
+
+    switch (major) {
+      case Bytes:
+      case Text: return skip(value);
+      case Array: return items(value, 1, depth);
+      case Map: return items(value, 2, depth);
+      case Tag: return item(depth + 1);
+      default: return Result::Ok;
+    }
+  }
+
+  Result items(uint64_t count, size_t perEntry, size_t depth) {
+    for (uint64_t i = 0; i != count; ++i) {
+      for (size_t j = 0; j != perEntry; ++j) {
+        const auto result = item(depth + 1);
+        if (result != Result::Ok) { return result; }
+      }
+    }
+    return Result::Ok;
+  }
+
+  Result untilBreak(size_t depth) {
+    while (!atEnd()) {
+      if (static_cast<uint8_t>(mData[mPos]) == Break) {
+        ++mPos;
+        return Result::Ok;
+      }
+      const auto result = item(depth + 1);
+      if (result != Result::Ok) { return result; }
+    }
+    return Result::End;
+  }
+
+  Result chunks(Major major) {
+    while (true) {
+      uint8_t initial = 0;
+      if (!byte(initial)) { return Result::End; }
+      if (initial == Break) { return Result::Ok; }
+      const auto info = static_cast<uint8_t>(initial & InfoMask);
+      if (initial >> MajorShift != major || info == Indefinite) {
+        return Result::Error;
+      }
+      uint64_t length = 0;
+      auto result = argument(info, length);
+      if (result == Result::Ok) { result = skip(length); }
+      if (result != Result::Ok) { return result; }
+    }
+  }
+};
+
+class ProtobufScanner : public Scanner
+{
+public:
+
+  using Scanner::Scanner;
+
+  Result document() {
+    constexpr uint64_t FieldShift = 3;
+    constexpr uint64_t WireMask = 0x7;
+    constexpr uint64_t MaxField = (1ULL << 29U) - 1;
+
+    size_t fields = 0;
+    while (!atEnd()) {
+      uint64_t key = 0;
+      auto result = varint(key);
+      if (result != Result::Ok) { return result; }
+
+      const auto field = key >> FieldShift;
+      if (field == 0 || field > MaxField) { return Result::Error; }
+
+      uint64_t value = 0;
+      switch (key & WireMask) {
+        case 0: result = varint(value); break;
+        case 1: result = skip(sizeof(uint64_t)); break;
+        case 2: {
+          result = varint(value);
+          if (result == Result::Ok) { result = skip(value); }
+        } break;
+        case 5: result = skip(sizeof(uint32_t)); break;
+        default: return Result::Error;
+      }
+      if (result != Result::Ok) { return result; }
+      ++fields;
+    }
+    return fields == 0 ? Result::Error : Result::Ok;
+  }
+
+private:
+
+  Result varint(uint64_t &value) {
+    constexpr size_t MaxBytes = 10;
+    constexpr uint8_t More = 0x80;
+    constexpr uint8_t Bits = 0x7F;
+    constexpr size_t BitsPerByte = 7;
+
+    value = 0;
+    for (size_t i = 0; i != MaxBytes; ++i) {
+      uint8_t next = 0;
+      if (!byte(next)) { return Result::End; }
+      value |= static_cast<uint64_t>(next & Bits) << (i * BitsPerByte);
+      if ((next & More) == 0) { return Result::Ok; }
+    }
+    return Result::Error;
+  }
+};
+
+bool isGzip(std::string_view data) {
+  return data.substr(0, GzipMagic.size()) == GzipMagic;
+}
+
+bool looksXml(std::string_view data, bool truncated) {
+  if (data.size() < 2 || data[0] != '<') { return false; }
+
+  const char first = data[1];
+  if (first == '?') { return data.substr(0, 5) == "<?xml"; }
+  if (first == '!') {
+    return data.substr(0, 4) == "<!--" || data.substr(0, 9) == "<!DOCTYPE";
+  }
+  if (!isAlpha(first) && first != '_' && first != ':') { return false; }
+
+  size_t pos = 2;
+  while (pos != data.size()) {
+    const char c = data[pos];
+    if (!isAlpha(c) && !isDigit(c) && c != '_' && c != ':' && c != '-'
+        && c != '.') {
+      break;
+    }
+    ++pos;
+  }
+  if (pos == data.size()) { return truncated; }
+  const char next = data[pos];
+  return next == '>' || next == '/' || isSpace(next);
+}
+
+} // namespace
+
+bool Payload::isText(std::string_view data, bool truncated) {
+  constexpr uint64_t Ones = 0x0101010101010101ULL;
+  constexpr uint64_t HighBits = 0x8080808080808080ULL;
+  constexpr uint64_t Controls = Ones * ControlEnd;
+
+  const auto *bytes = reinterpret_cast<const uint8_t *>(data.data());
+  const size_t size = data.size();
+  size_t i = 0;
+
+  while (i != size) {
+    // Eight bytes at a time while they are printable ASCII.
+    while (size - i >= sizeof(uint64_t)) {
+      uint64_t word = 0;
+      std::memcpy(&word, bytes + i, sizeof(word));
+      const bool control = ((word - Controls) & ~word & HighBits) != 0;
+      if ((word & HighBits) != 0 || control) { break; }
+      i += sizeof(word);
+    }
+    if (i == size) { break; }
+
+    const uint8_t lead = bytes[i];
+    if (lead < AsciiEnd) {
+      if (lead < ControlEnd && !isSpace(static_cast<char>(lead))) {
+        return false;
+      }
+      ++i;
+      continue;
+    }
+
+    // NOLINTBEGIN(readability-magic-numbers)
+    size_t length = 0;
+    uint32_t minimum = 0;
+    if ((lead & 0xE0U) == 0xC0U) {
+      length = 2;
+      minimum = 0x80;
+    } else if ((lead & 0xF0U) == 0xE0U) {
+      length = 3;
+      minimum = 0x800;
+    } else if ((lead & 0xF8U) == 0xF0U) {
+      length = 4;
+      minimum = 0x10000;
+    } else {
+      return false;
+    }
+    if (size - i < length) { return truncated; }
+
+    uint32_t point = lead & (0x7FU >> length);
+    for (size_t k = 1; k != length; ++k) {
+      const uint8_t next = bytes[i + k];
+      if ((next & 0xC0U) != 0x80U) { return false; }
+      point = (point << 6U) | (next & 0x3FU);
+    }
+    if (point < minimum || point > 0x10FFFF) { return false; }
+    if (point >= 0xD800 && point <= 0xDFFF) { return false; }
+    // NOLINTEND(readability-magic-numbers)
+
+    i += length;
+  }
+  return true;
+}
+
+Kind Payload::sniff(std::string_view payload) {
+  if (payload.empty()) { return Kind::Text; }
+
+  const auto prefix = payload.substr(0, SniffLimit);
+  const bool truncated = prefix.size() != payload.size();
+
+  if (isGzip(prefix)) { return Kind::Gzip; }
+
+  if (isText(prefix, truncated)) {
+    const auto text = trimmed(prefix);
+    if (text.empty()) { return Kind::Text; }
+    if (text.front() == '<') {
+      return looksXml(text, truncated) ? Kind::Xml : Kind::Text;
+    }
+    JsonScanner json(text, truncated);
+    return json.accepts(json.document()) ? Kind::Json : Kind::Text;
+  }
+
+  if (isMessagePackContainer(static_cast<uint8_t>(prefix.front()))) {
+    MessagePackScanner messagePack(prefix, truncated);
+    if (messagePack.accepts(messagePack.document())) {
+      return Kind::MessagePack;
+    }
+  }
+
+  if (isCborContainer(prefix)) {
+    CborScanner cbor(prefix, truncated);
+    if (cbor.accepts(cbor.document())) { return Kind::Cbor; }
+  }
+
+  ProtobufScanner protobuf(prefix, truncated);
+  if (protobuf.accepts(protobuf.document())) { return Kind::Protobuf; }
+
+  return Kind::Binary;
+}
+
+bool Payload::plausible(std::string_view payload, Kind kind) {
+  if (payload.empty()) { return kind == Kind::Text; }
+
+  const auto prefix = payload.substr(0, PlausibleLimit);
+  const bool truncated = prefix.size() != payload.size();
+  const auto first = static_cast<uint8_t>(payload.front());
+  const auto text = trimmed(prefix);
+  const char c = text.empty() ? ' ' : text.front();
+  const bool printable = first >= AsciiEnd
+    || (first >= ControlEnd && first != Delete)
+    || isSpace(static_cast<char>(first));
+
+  switch (kind) {
+    case Kind::Json: {
+      if (!isText(prefix, truncated)) { return false; }
+      JsonScanner json(text, truncated);
+      return json.accepts(json.document());
+    }
+    case Kind::Xml: return c == '<';
+    case Kind::MessagePack: return isMessagePackContainer(first);
+    case Kind::Cbor: return isCborContainer(payload);
+    case Kind::Gzip: return isGzip(payload);
+    case Kind::Protobuf: {
+      constexpr uint8_t WireMask = 0x7;
+      const auto wire = first & WireMask;
+      return first > WireMask && (wire <= 2 || wire == 5);
+    }
+    case Kind::Text: {
+      return c != '{' && c != '[' && c != '<' && isText(prefix, truncated);
+    }
+    case Kind::Binary:
+    default: return !printable || first >= AsciiEnd;
+  }
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+namespace Rapatas::Transmitron::Payload {
+
+enum class Kind : uint8_t {
+  Text,
+  Json,
+  Xml,
+  MessagePack,
+  Cbor,
+  Gzip,
+  Protobuf,
+  Binary,
+};
+
+// Detects the encoding of a payload. Only a bounded prefix is looked at, so
+// the cost does not depend on the size of the payload.
+Kind sniff(std::string_view payload);
+
+// Whether the first bytes of a payload agree with a kind detected earlier,
+// to reuse it without sniffing again. Text and JSON are checked the way sniff
+// checks them, on a shorter prefix.
+bool plausible(std::string_view payload, Kind kind);
+
+// Whether data is UTF-8 without control characters other than whitespace.
+// With `truncated`, a sequence cut by the end of data is accepted.
+bool isText(std::string_view data, bool truncated = false);
+
+} // namespace Rapatas::Transmitron::Payload
@@ -0,0 +1,483 @@
+#include "Xml.hpp"
+
+#include <algorithm>
+#include <array>
+#include <vector>
+
+#include <fmt/format.h>
+
+using namespace Rapatas::Transmitron;
+using namespace Payload;
+
+namespace {
+
+constexpr std::string_view Bom = "\xEF\xBB\xBF";
+constexpr std::string_view Indent = "    ";
+constexpr size_t CheckInterval = 64 * 1024;
+
+// What is done to a value before it is written, as tinyxml2 parses and then
+// prints it.
+enum class Content : uint8_t {
+  Plain, // Newlines normalized.
+  Text, // Entities decoded, & < > escaped.
+  Attribute, // Entities decoded, " & ' < > escaped.
+};
+
+struct Entity {
+  char value;
+  std::string_view name;
+};
+
+constexpr std::array<Entity, 5> Entities{{
+  {'"', "quot"},
+  {'&', "amp"},
+  {'\'', "apos"},
+  {'<', "lt"},
+  {'>', "gt"},
+}};
+
+using Table = std::array<bool, 256>;
+
+constexpr Table specials(Content content) {
+  Table table{};
+  table['\r'] = true;
+  table['\n'] = true;
+  if (content == Content::Plain) { return table; }
+  table['&'] = true;
+  table['<'] = true;
+  table['>'] = true;
+  if (content == Content::Text) { return table; }
+  table['"'] = true;
+  table['\''] = true;
+  return table;
+}
+
+constexpr Table PlainSpecials = specials(Content::Plain);
+constexpr Table TextSpecials = specials(Content::Text);
+constexpr Table AttributeSpecials = specials(Content::Attribute);
+
+bool isSpace(char c) {
+  return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+bool isNameStart(char c) {
+  const auto value = static_cast<uint8_t>(c);
+  constexpr uint8_t AsciiEnd = 0x80;
+  return value >= AsciiEnd || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z')
+    || c == ':' || c == '_';
+}
+
+bool isName(char c) {
+  return isNameStart(c) || (c >= '0' && c <= '9') || c == '.' || c == '-';
+}
+
+int digitValue(char c, bool hex) {
+  constexpr int Decimal = 10;
+  if (c >= '0' && c <= '9') { return c - '0'; }
+  if (!hex) { return -1; }
+  if (c >= 'a' && c <= 'f') { return c - 'a' + Decimal; }
+  if (c >= 'A' && c <= 'F') { return c - 'A' + Decimal; }
+  return -1;
+}
+
+class Reindent
+{
+public:
+
+  Reindent(
+    std::string_view text,
+    std::string &result,
+    const std::function<bool()> &cancelled
+  ) :
+    mText(text),
+    mOut(result),
+    mCancelled(cancelled) //
+  {}
+
+  [[nodiscard]] const std::string &error() const { return mError; }
+
+  bool run() {
+    space();
+    if (mText.substr(mPos, Bom.size()) == Bom) {
+      mOut += Bom;
+      mPos += Bom.size();
+    }
+    if (mPos == mText.size()) { return fail("Empty document"); }
+
+    while (true) {
+      if (mPos >= mCheck) {
+        mCheck = mPos + CheckInterval;
+        if (mCancelled && mCancelled()) { return fail("Cancelled"); }
+      }
+
+      // Text that is only whitespace is dropped, other text is kept whole.
+      const auto start = mPos;
+      space();
+      if (mPos == mText.size()) { break; }
+
+      bool parsed = false;
+      if (startsWith("<?")) {
+        parsed = declaration();
+      } else if (startsWith("<!--")) {
+        parsed = special("<!--", "-->");
+      } else if (startsWith("<![CDATA[")) {
+        parsed = cdata();
+      } else if (startsWith("<!")) {
+        parsed = special("<!", ">");
+      } else if (startsWith("<")) {
+        parsed = element();
+      } else {
+        mPos = start;
+        parsed = text();
+      }
+      if (!parsed) { return false; }
+    }
+
+    if (!mElements.empty()) { return fail("Unclosed element"); }
+    return true;
+  }
+
+private:
+
+  std::string_view mText;
+  size_t mPos = 0;
+  size_t mCheck = 0;
+  std::string &mOut;
+  const std::function<bool()> &mCancelled;
+  std::string mError;
+
+  // Names of the open elements, the only state kept besides the printer.
+  std::vector<std::string_view> mElements;
+  std::vector<std::string_view> mAttributes;
+  // Anything other than declarations was seen at the top level.
+  bool mProlog = true;
+
+  // State of tinyxml2::XMLPrinter.
+  int mTextDepth = -1;
+  bool mFirstElement = true;
+  bool mElementJustOpened = false;
+
+  bool fail(std::string_view message) {
+    mError = fmt::format("{} at offset {}", message, mPos);
+    return false;
+  }
+
+  [[nodiscard]] bool startsWith(std::string_view prefix) const {
+    return mText.substr(mPos, prefix.size()) == prefix;
+  }
+
+  [[nodiscard]] char peek() const {
+    return mPos == mText.size() ? '\0' : mText[mPos];
+  }
+
+  void space() {
+    while (mPos != mText.size() && isSpace(mText[mPos])) { ++mPos; }
+  }
+
+  // Content up to `terminator`, which is skipped.
+  bool until(std::string_view terminator, std::string_view &content) {
+    const auto end = mText.find(terminator, mPos);
+    if (end == std::string_view::npos) {
+      return fail(fmt::format("Missing '{}'", terminator));
+    }
+    content = mText.substr(mPos, end - mPos);
+    mPos = end + terminator.size();
+    return true;
+  }
+
+  std::string_view name() {
+    const auto begin = mPos;
+    if (!isNameStart(peek())) { return {}; }
+    while (isName(peek())) { ++mPos; }
+    return mText.substr(begin, mPos - begin);
+  }
+
+  bool declaration() {
+    if (!mElements.empty() || !mProlog) {
+      return fail("Declaration after content");
+    }
+    return special("<?", "?>");
+  }
+
+  bool special(std::string_view open, std::string_view close) {
+    if (open != "<?") { mProlog = false; }
+    mPos += open.size();
+    std::string_view content;
+    if (!until(close, content)) { return false; }
+
+    seal();
+    if (mTextDepth < 0 && !mFirstElement) { newline(mElements.size()); }
+    mFirstElement = false;
+    mOut += open;
+    write(content, Content::Plain);
+    mOut += close;
+    return true;
+  }
+
+  bool cdata() {
+    mProlog = false;
+    mPos += std::string_view("<![CDATA[").size();
+    std::string_view content;
+    if (!until("]]>", content)) { return false; }
+
+    pushText();
+    mOut += "<![CDATA[";
+    write(content, Content::Plain);
+    mOut += "]]>";
+    return true;
+  }
+
+  bool text() {
+    mProlog = false;
+    const auto end = mText.find('<', mPos);
+    if (end == std::string_view::npos) { return fail("Text outside of tags"); }
+    const auto content = mText.substr(mPos, end - mPos);
+    mPos = end;
+
+    pushText();
+    write(content, Content::Text);
+    return true;
+  }
+
+  bool element() {
+    mProlog = false;
+    const auto begin = mPos;
+    ++mPos;
+    space();
+    const bool closing = peek() == '/';
+    if (closing) { ++mPos; }
+
+    const auto tag = name();
+    if (tag.empty()) { return fail("Invalid element name"); }
+    if (!closing) { openElement(tag); }
+
+    mAttributes.clear();
+    while (true) {
+      space();
+      if (mPos == mText.size()) { return fail("Unterminated element"); }
+      if (isNameStart(peek())) {
+        if (!attribute(!closing)) { return false; }
+      } else if (peek() == '>') {
+        ++mPos;
+        break;
+      } else if (!closing && startsWith("/>")) {
+        mPos += 2;
+        closeElement(tag);
+        return true;
+      } else {
+        return fail("Invalid element");
+      }
+    }
+
+    if (!closing) {
+      mElements.push_back(tag);
+      return true;
+    }
+    if (mElements.empty() || mElements.back() != tag) {
+      mPos = begin;
+      return fail("Mismatched closing tag");
+    }
+    mElements.pop_back();
+    closeElement(tag);
+    return true;
+  }
+
+  bool attribute(bool print) {
+    const auto begin = mPos;
+    const auto key = name();
+    space();
+    if (peek() != '=') { return fail("Expected '='"); }
+    ++mPos;
+    space();
+    const char quote = peek();
+    if (quote != '"' && quote != '\'') { return fail("Expected a quote"); }
+    ++mPos;
+    std::string_view value;
+    if (!until(std::string_view(&quote, 1), value)) { return false; }
+
+    const auto it = std::find(
+      std::begin(mAttributes),
+      std::end(mAttributes),
+      key
+    );
+    if (it != std::end(mAttributes)) {
+      mPos = begin;
+      return fail("Duplicate attribute");
+    }
+    mAttributes.push_back(key);
+
+    if (print) {
+      mOut += ' ';
+      mOut += key;
+      mOut += "=\"";
+      write(value, Content::Attribute);
+      mOut += '"';
+    }
+    return true;
+  }
+
+  void newline(size_t depth) {
+    mOut += '\n';
+    for (size_t i = 0; i != depth; ++i) { mOut += Indent; }
+  }
+
+  void seal() {
+    if (!mElementJustOpened) { return; }
+    mElementJustOpened = false;
+    mOut += '>';
+  }
+
+  void openElement(std::string_view tag) {
+    seal();
+    if (mTextDepth < 0 && !mFirstElement) { newline(mElements.size()); }
+    mOut += '<';
+    mOut += tag;
+    mElementJustOpened = true;
+    mFirstElement = false;
+  }
+
+  // Called after the element left mElements.
+  void closeElement(std::string_view tag) {
+    const auto depth = static_cast<int>(mElements.size());
+    if (mElementJustOpened) {
+      mOut += "/>";
+    } else {
+      if (mTextDepth < 0) { newline(mElements.size()); }
+      mOut += "</";
+      mOut += tag;
+      mOut += '>';
+    }
+    if (mTextDepth == depth) { mTextDepth = -1; }
+    if (depth == 0) { mOut += '\n'; }
+    mElementJustOpened = false;
+  }
+
+  // Text keeps the parent and its descendants from being indented.
+  void pushText() {
+    mTextDepth = static_cast<int>(mElements.size()) - 1;
+    seal();
+  }
+
+  void write(std::string_view raw, Content content) {
+    const auto &table = content == Content::Plain ? PlainSpecials
+      : content == Content::Text                  ? TextSpecials
+                                                  : AttributeSpecials;
+    size_t pos = 0;
+    while (true) {
+      const auto begin = pos;
+      while (pos != raw.size() && !table.at(static_cast<uint8_t>(raw[pos]))) {
+        ++pos;
+      }
+      mOut.append(raw.substr(begin, pos - begin));
+      if (pos == raw.size()) { return; }
+
+      const char c = raw[pos];
+      if (c == '\r' || c == '\n') {
+        // CR LF, LF CR and lone ones all become LF.
+        const char pair = c == '\r' ? '\n' : '\r';
+        mOut += '\n';
+        const bool paired = pos + 1 != raw.size() && raw[pos + 1] == pair;
+        pos += paired ? 2 : 1;
+      } else if (c == '&') {
+        pos = entity(raw, pos, content);
+      } else {
+        escape(c, content);
+        ++pos;
+      }
+    }
+  }
+
+  void escape(char c, Content content) {
+    const bool escaped = content == Content::Attribute
+      || c == '&' || c == '<' || c == '>';
+    const auto it = std::find_if(
+      std::begin(Entities),
+      std::end(Entities),
+      [c](const Entity &entity) { return entity.value == c; }
+    );
+    if (!escaped || it == std::end(Entities)) {
+      mOut += c;
+      return;
+    }
+    mOut += '&';
+    mOut += it->name;
+    mOut += ';';
+  }
+
+  // Decodes the reference at `pos` and writes it escaped again, returns
+  // where the content continues. Unknown references are kept as text.
+  size_t entity(std::string_view raw, size_t pos, Content content) {
+    const auto rest = raw.substr(pos + 1);
+    if (rest.substr(0, 1) == "#") { return character(raw, pos, content); }
+
+    for (const auto &known : Entities) {
+      if (rest.size() > known.name.size()
+          && rest.substr(0, known.name.size()) == known.name
+          && rest[known.name.size()] == ';') {
+        escape(known.value, content);
+        return pos + known.name.size() + 2;
+      }
+    }
+    escape('&', content);
+    return pos + 1;
+  }
+
+  // NOLINTBEGIN(readability-magic-numbers)
+  size_t character(std::string_view raw, size_t pos, Content content) {
+    const bool hex = raw.substr(pos + 2, 1) == "x";
+    const auto begin = pos + (hex ? 3 : 2);
+    const auto end = raw.find(';', begin);
+    if (begin >= raw.size() || end == std::string_view::npos) {
+      escape('&', content);
+      return pos + 1;
+    }
+
+    uint64_t point = 0;
+    for (size_t i = begin; i != end; ++i) {
+      const int digit = digitValue(raw[i], hex);
+      if (digit < 0) {
+        escape('&', content);
+        return pos + 1;
+      }
+      point = std::min<uint64_t>(
+        point * (hex ? 16 : 10) + static_cast<uint64_t>(digit),
+        0x200000
+      );
+    }
+
+    // Same as tinyxml2, what UTF-8 cannot encode is left out.
+    if (point < 0x80) {
+      escape(static_cast<char>(point), content);
+    } else if (point < 0x800) {
+      mOut += static_cast<char>(0xC0U | (point >> 6U));
+      mOut += static_cast<char>(0x80U | (point & 0x3FU));
+    } else if (point < 0x10000) {
+      mOut += static_cast<char>(0xE0U | (point >> 12U));
+      mOut += static_cast<char>(0x80U | ((point >> 6U) & 0x3FU));
+      mOut += static_cast<char>(0x80U | (point & 0x3FU));
+    } else if (point < 0x200000) {
+      mOut += static_cast<char>(0xF0U | (point >> 18U));
+      mOut += static_cast<char>(0x80U | ((point >> 12U) & 0x3FU));
+      mOut += static_cast<char>(0x80U | ((point >> 6U) & 0x3FU));
+      mOut += static_cast<char>(0x80U | (point & 0x3FU));
+    }
+    return end + 1;
+  }
+  // NOLINTEND(readability-magic-numbers)
+};
+
+} // namespace
+
+bool Xml::pretty(
+  std::string_view text,
+  std::string &result,
+  std::string &error,
+  const std::function<bool()> &cancelled
+) {
+  result.clear();
+  result.reserve(text.size() * 2);
+  Reindent reindent(text, result, cancelled);
+  if (reindent.run()) { return true; }
+  error = reindent.error();
+  return false;
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+namespace Rapatas::Transmitron::Payload::Xml {
+
+// Lays out an XML document like tinyxml2::XMLPrinter, token by token and
+// without building it in memory. On failure `error` tells the first syntax
+// error and its offset. `cancelled` is polled while going through large
+// documents.
+bool pretty(
+  std::string_view text,
+  std::string &result,
+  std::string &error,
+  const std::function<bool()> &cancelled = {}
+);
+
+} // namespace Rapatas::Transmitron::Payload::Xml
@@ -0,0 +1,174 @@
+#include "Binary.hpp"
+
+#include <zlib.h>
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace std::chrono;
+
+bool Binary::readFrame(
+  std::string_view header,
+  std::string_view trailer,
+  size_t size,
+  uint64_t &footerOffset,
+  uint32_t &footerSize
+) {
+  if (size < HeaderSize + TrailerSize) { return false; }
+  if (header.size() < HeaderSize || trailer.size() < TrailerSize) {
+    return false;
+  }
+
+  Cursor headerCursor(header.substr(Magic.size()));
+  uint16_t version = 0;
+  headerCursor.get(version);
+  if (version != Version) { return false; }
+
+  Cursor trailerCursor(trailer);
+  trailerCursor.get(footerOffset);
+  trailerCursor.get(footerSize);
+  const auto magic = trailer.substr(TrailerSize - Magic.size());
+  if (magic != std::string_view(Magic.data(), Magic.size())) { return false; }
+
+  // Compared against what is left of the file, as crafted values could
+  // wrap around when added.
+  const auto end = size - TrailerSize;
+  return footerOffset >= HeaderSize && footerOffset <= end
+    && footerSize == end - footerOffset;
+}
+
+bool Binary::readIndex(
+  std::string_view footer,
+  uint64_t footerOffset,
+  Index &index
+) {
+  Cursor cursor(footer);
+
+  uint32_t subscriptions = 0;
+  cursor.get(subscriptions);
+  for (uint32_t i = 0; i != subscriptions && !cursor.failed(); ++i) {
+    uint64_t id = 0;
+    uint8_t qos = 0;
+    std::string_view filter;
+    cursor.get(id);
+    cursor.get(qos);
+    cursor.get(filter);
+    if (qos > static_cast<uint8_t>(MQTT::QoS::ExactlyOnce)) { return false; }
+    index.subscriptions.push_back({
+      static_cast<MQTT::Subscription::Id>(id),
+      std::string(filter),
+      static_cast<MQTT::QoS>(qos),
+    });
+  }
+
+  uint32_t topics = 0;
+  cursor.get(topics);
+  for (uint32_t i = 0; i != topics && !cursor.failed(); ++i) {
+    std::string_view topic;
+    cursor.get(topic);
+    index.topics.emplace_back(topic);
+  }
+
+  uint32_t blocks = 0;
+  cursor.get(blocks);
+  for (uint32_t i = 0; i != blocks && !cursor.failed(); ++i) {
+    BlockInfo block;
+    cursor.get(block.offset);
+    cursor.get(block.compressed);
+    cursor.get(block.raw);
+    cursor.get(block.records);
+    cursor.get(block.first);
+    cursor.get(block.last);
+    // Bounded before anything is allocated for the block.
+    if (block.offset < HeaderSize || block.offset > footerOffset) {
+      return false;
+    }
+    const auto left = footerOffset - block.offset;
+    if (BlockHeaderSize + block.compressed > left) { return false; }
+    if (block.raw > MaxBlockRaw) { return false; }
+    uint32_t count = 0;
+    cursor.get(count);
+    for (uint32_t j = 0; j != count && !cursor.failed(); ++j) {
+      uint32_t topicId = 0;
+      cursor.get(topicId);
+      // Readers index their topics with these, unchecked.
+      if (topicId >= index.topics.size()) { return false; }
+      block.topics.push_back(topicId);
+    }
+    index.blocks.push_back(std::move(block));
+  }
+
+  return !cursor.failed();
+}
+
+bool Binary::inflate(
+  std::string_view data,
+  const BlockInfo &block,
+  std::string &raw
+) {
+  Cursor cursor(data);
+  uint32_t compressed = 0;
+  uint32_t size = 0;
+  uint32_t crc = 0;
+  cursor.get(compressed);
+  cursor.get(size);
+  cursor.get(crc);
+  if (cursor.failed() || compressed != block.compressed || size != block.raw) {
+    return false;
+  }
+
+  std::string_view body;
+  if (!cursor.take(compressed, body)) { return false; }
+
+  raw.resize(size);
+  auto length = static_cast<uLongf>(size);
+  const auto result = uncompress(
+    reinterpret_cast<Bytef *>(raw.data()), // NOLINT
+    &length,
+    reinterpret_cast<const Bytef *>(body.data()), // NOLINT
+    static_cast<uLong>(compressed)
+  );
+  const auto actual = crc32(
+    0,
+    reinterpret_cast<const Bytef *>(raw.data()), // NOLINT
+    static_cast<uInt>(length)
+  );
+  return result == Z_OK && length == size && actual == crc;
+}
+
+bool Binary::readRecord(
+  std::string_view &remaining,
+  const std::vector<std::string> &topics,
+  Record &record,
+  uint32_t *topicId
+) {
+  Cursor cursor(remaining);
+  uint32_t length = 0;
+  std::string_view body;
+  if (!cursor.get(length) || !cursor.take(length, body)) { return false; }
+  remaining.remove_prefix(sizeof(length) + length);
+
+  Cursor fields(body);
+  int64_t timestamp = 0;
+  uint64_t subscriptionId = 0;
+  uint32_t topic = 0;
+  uint8_t qos = 0;
+  uint8_t flags = 0;
+  fields.get(timestamp);
+  fields.get(subscriptionId);
+  fields.get(topic);
+  fields.get(qos);
+  fields.get(flags);
+  if (fields.failed() || topic >= topics.size()) { return false; }
+  if (qos > static_cast<uint8_t>(MQTT::QoS::ExactlyOnce)) { return false; }
+  if (topicId != nullptr) { *topicId = topic; }
+
+  record.subscriptionId = static_cast<MQTT::Subscription::Id>(subscriptionId);
+  record.topic = topics[topic];
+  record.payload = body.substr(RecordHeaderSize);
+  record.qos = static_cast<MQTT::QoS>(qos);
+  record.retained = (flags & RetainedFlag) != 0;
+  record.timestamp = system_clock::time_point(
+    duration_cast<system_clock::duration>(nanoseconds(timestamp))
+  );
+  return true;
+}
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Recording/Record.hpp"
+
+// Layout of a .tmrc v2 recording, all integers little-endian:
+//
+//   Header   "TMRC" u16:version u16:flags
+//   Block*   u32:compressed u32:raw u32:crc32 <zlib compressed records>
+//   Footer   subscriptions, topics and the block index
+//   Trailer  u64:footerOffset u32:footerSize "TMRC"
+//
+// A record inside a block is u32:length followed by i64:timestamp (ns since
+// epoch) u64:subscription u32:topic u8:qos u8:flags and the payload, which
+// takes the rest of the length.
+namespace Rapatas::Transmitron::Recording::Binary {
+
+constexpr std::array<char, 4> Magic{'T', 'M', 'R', 'C'};
+constexpr uint16_t Version = 2;
+constexpr size_t HeaderSize = 8;
+constexpr size_t TrailerSize = 16;
+constexpr size_t BlockHeaderSize = 12;
+constexpr size_t RecordHeaderSize = 22;
+constexpr size_t BlockSize = 256 * 1024;
+// Blocks are closed once past BlockSize, so they hold at most that and one
+// record with the largest payload MQTT allows.
+constexpr size_t MaxPayload = 268435455;
+constexpr size_t MaxBlockRaw
+  = BlockSize + sizeof(uint32_t) + RecordHeaderSize + MaxPayload;
+constexpr uint8_t RetainedFlag = 0x01;
+
+struct BlockInfo {
+  uint64_t offset = 0;
+  uint32_t compressed = 0;
+  uint32_t raw = 0;
+  uint32_t records = 0;
+  int64_t first = 0;
+  int64_t last = 0;
+  std::vector<uint32_t> topics;
+};
+
+inline void put(std::string &out, uint8_t value) {
+  out.push_back(static_cast<char>(value));
+}
+
+inline void put(std::string &out, uint16_t value) {
+  for (size_t i = 0; i != sizeof(value); ++i) {
+    out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF)); // NOLINT
+  }
+}
+
+inline void put(std::string &out, uint32_t value) {
+  for (size_t i = 0; i != sizeof(value); ++i) {
+    out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF)); // NOLINT
+  }
+}
+
+inline void put(std::string &out, uint64_t value) {
+  for (size_t i = 0; i != sizeof(value); ++i) {
+    out.push_back(static_cast<char>((value >> (i * 8)) & 0xFF)); // NOLINT
+  }
+}
+
+inline void put(std::string &out, int64_t value) {
+  put(out, static_cast<uint64_t>(value));
+}
+
+inline void put(std::string &out, std::string_view value) {
+  put(out, static_cast<uint32_t>(value.size()));
+  out.append(value);
+}
+
+// Bounds checked reader over a byte range. Every getter returns false once
+// the range is exhausted and leaves the cursor failed.
+class Cursor
+{
+public:
+
+  explicit Cursor(std::string_view data) :
+    mData(data) //
+  {}
+
+  template<typename T>
+  bool get(T &value) {
+    if (mData.size() < sizeof(T)) { return fail(); }
+    uint64_t result = 0;
+    for (size_t i = 0; i != sizeof(T); ++i) {
+      const auto byte = static_cast<uint8_t>(mData[i]);
+      result |= static_cast<uint64_t>(byte) << (i * 8); // NOLINT
+    }
+    value = static_cast<T>(result);
+    mData.remove_prefix(sizeof(T));
+    return true;
+  }
+
+  bool get(std::string_view &value) {
+    uint32_t size = 0;
+    if (!get(size)) { return false; }
+    return take(size, value);
+  }
+
+  bool take(size_t size, std::string_view &value) {
+    if (mData.size() < size) { return fail(); }
+    value = mData.substr(0, size);
+    mData.remove_prefix(size);
+    return true;
+  }
+
+  [[nodiscard]] size_t remaining() const { return mData.size(); }
+  [[nodiscard]] bool failed() const { return mFailed; }
+
+private:
+
+  std::string_view mData;
+  bool mFailed = false;
+
+  bool fail() {
+    mFailed = true;
+    return false;
+  }
+};
+
+struct Index {
+  std::vector<Subscription> subscriptions;
+  std::vector<std::string> topics;
+  std::vector<BlockInfo> blocks;
+};
+
+// Checks the header and trailer of a whole file given its first and last
+// bytes, and returns where the footer is.
+bool readFrame(
+  std::string_view header,
+  std::string_view trailer,
+  size_t size,
+  uint64_t &footerOffset,
+  uint32_t &footerSize
+);
+
+// Blocks must lie between the header and the footer, at `footerOffset`.
+bool readIndex(std::string_view footer, uint64_t footerOffset, Index &index);
+
+// Verifies and decompresses a block, given its bytes starting at its header.
+bool inflate(std::string_view data, const BlockInfo &block, std::string &raw);
+
+// Decodes the next record of a decompressed block and advances past it. The
+// record points into the block and into the topics.
+bool readRecord(
+  std::string_view &remaining,
+  const std::vector<std::string> &topics,
+  Record &record,
+  uint32_t *topicId = nullptr
+);
+
+} // namespace Rapatas::Transmitron::Recording::Binary
@@ -0,0 +1,121 @@
+#include "BinaryReader.hpp"
+
+#include "Common/Log.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+
+BinaryReader::BinaryReader(const std::string &path) :
+  mInput(path, std::ios::binary) //
+{
+  mLogger = Common::Log::create("Recording::BinaryReader");
+
+  if (!mInput.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->warn("Could not open '{}': {}", path, ec.message());
+    mFailed = true;
+    return;
+  }
+
+  if (!readFooter()) {
+    mLogger->warn("Could not read index of '{}'", path);
+    mFailed = true;
+  }
+}
+
+const std::vector<Subscription> &BinaryReader::subscriptions() const {
+  return mIndex.subscriptions;
+}
+
+bool BinaryReader::next(Record &record) {
+  while (mRemaining.empty()) {
+    if (mFailed || mNextBlock == mIndex.blocks.size()) { return false; }
+    if (!readBlock()) {
+      mFailed = true;
+      return false;
+    }
+  }
+
+  if (!Binary::readRecord(mRemaining, mIndex.topics, record)) {
+    mLogger->warn("Malformed record in block {}", mNextBlock - 1);
+    mFailed = true;
+    return false;
+  }
+  return true;
+}
+
+size_t BinaryReader::position() const { return mPosition; }
+
+size_t BinaryReader::size() const { return mSize; }
+
+bool BinaryReader::failed() const { return mFailed; }
+
+const std::vector<Binary::BlockInfo> &BinaryReader::blocks() const {
+  return mIndex.blocks;
+}
+
+const std::vector<std::string> &BinaryReader::topics() const {
+  return mIndex.topics;
+}
+
+bool BinaryReader::seek(size_t block) {
+  if (block > mIndex.blocks.size()) { return false; }
+  mNextBlock = block;
+  mRemaining = {};
+  mFailed = false;
+  mInput.clear();
+  return true;
+}
+
+bool BinaryReader::readFooter() {
+  mInput.seekg(0, std::ios::end);
+  mSize = static_cast<size_t>(mInput.tellg());
+  if (mSize < Binary::HeaderSize + Binary::TrailerSize) { return false; }
+
+  std::string header(Binary::HeaderSize, '\0');
+  mInput.seekg(0);
+  mInput.read(header.data(), static_cast<std::streamsize>(header.size()));
+
+  std::string trailer(Binary::TrailerSize, '\0');
+  mInput.seekg(static_cast<std::streamoff>(mSize - Binary::TrailerSize));
+  mInput.read(trailer.data(), static_cast<std::streamsize>(trailer.size()));
+  if (!mInput.good()) { return false; }
+
+  uint64_t footerOffset = 0;
+  uint32_t footerSize = 0;
+  if (!Binary::readFrame(header, trailer, mSize, footerOffset, footerSize)) {
+    return false;
+  }
+
+  std::string footer(footerSize, '\0');
+  mInput.seekg(static_cast<std::streamoff>(footerOffset));
+  mInput.read(footer.data(), static_cast<std::streamsize>(footer.size()));
+  if (!mInput.good()) { return false; }
+
+  return Binary::readIndex(footer, footerOffset, mIndex);
+}
+
+bool BinaryReader::readBlock() {
+  const auto &block = mIndex.blocks.at(mNextBlock);
+  ++mNextBlock;
+
+  mCompressed.resize(Binary::BlockHeaderSize + block.compressed);
+  mInput.seekg(static_cast<std::streamoff>(block.offset));
+  mInput.read(
+    mCompressed.data(),
+    static_cast<std::streamsize>(mCompressed.size())
+  );
+  if (!mInput.good()) {
+    mLogger->warn("Truncated block {}", mNextBlock - 1);
+    return false;
+  }
+
+  if (!Binary::inflate(mCompressed, block, mRaw)) {
+    mLogger->warn("Corrupted block {}", mNextBlock - 1);
+    return false;
+  }
+
+  mRemaining = mRaw;
+  mPosition = block.offset + mCompressed.size();
+  return true;
+}
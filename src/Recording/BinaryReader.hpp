@@ -0,0 +1,47 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "Recording/Binary.hpp"
+#include "Recording/Reader.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+class BinaryReader : public Reader
+{
+public:
+
+  explicit BinaryReader(const std::string &path);
+
+  [[nodiscard]] const std::vector<Subscription> &subscriptions(
+  ) const override;
+  bool next(Record &record) override;
+  [[nodiscard]] size_t position() const override;
+  [[nodiscard]] size_t size() const override;
+  [[nodiscard]] bool failed() const override;
+
+  [[nodiscard]] const std::vector<Binary::BlockInfo> &blocks() const;
+  [[nodiscard]] const std::vector<std::string> &topics() const;
+  bool seek(size_t block);
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::ifstream mInput;
+  size_t mSize = 0;
+  Binary::Index mIndex;
+  size_t mNextBlock = 0;
+  size_t mPosition = 0;
+  std::string mCompressed;
+  std::string mRaw;
+  std::string_view mRemaining;
+  bool mFailed = false;
+
+  bool readFooter();
+  bool readBlock();
+};
+
+} // namespace Rapatas::Transmitron::Recording
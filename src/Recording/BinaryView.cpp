@@ -0,0 +1,203 @@
+#include "BinaryView.hpp"
+
+#include <algorithm>
+
+#include "Common/Log.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace std::chrono;
+
+constexpr size_t CachedBlocks = 8;
+
+BinaryView::BinaryView(const std::string &path) :
+  mPath(path),
+  mFile(path) //
+{
+  mLogger = Common::Log::create("Recording::BinaryView");
+
+  if (mFile.failed()) {
+    mLogger->warn("Could not map '{}'", path);
+    mFailed = true;
+    return;
+  }
+  mFile.adviseRandom();
+
+  if (!readIndex()) {
+    mLogger->warn("Could not read index of '{}'", path);
+    mFailed = true;
+  }
+}
+
+const std::vector<Subscription> &BinaryView::subscriptions() const {
+  return mIndex.subscriptions;
+}
+
+const std::vector<View::Checkpoint> &BinaryView::checkpoints() const {
+  return mCheckpoints;
+}
+
+size_t BinaryView::size() const { return mFirst.empty() ? 0 : mFirst.back(); }
+
+std::unique_ptr<View> BinaryView::clone() const {
+  // Reading the index again only takes the footer.
+  auto view = std::make_unique<BinaryView>(mPath);
+  if (view->failed()) { return nullptr; }
+  return view;
+}
+
+bool BinaryView::get(size_t index, Record &record) {
+  if (index >= size()) { return false; }
+
+  const auto it = std::upper_bound(std::begin(mFirst), std::end(mFirst), index);
+  const auto block = static_cast<size_t>(it - std::begin(mFirst)) - 1;
+  const auto *cached = load(block);
+  if (cached == nullptr) { return false; }
+
+  const auto offset = cached->offsets.at(index - mFirst[block]);
+  auto remaining = std::string_view(cached->raw).substr(offset);
+  return Binary::readRecord(remaining, mIndex.topics, record);
+}
+
+void BinaryView::scan(
+  size_t begin,
+  size_t end,
+  const TopicFilter &filter,
+  const Visitor &visitor
+) {
+  end = std::min(end, size());
+  if (begin >= end) { return; }
+
+  std::vector<bool> matches(mIndex.topics.size());
+  for (size_t i = 0; i != mIndex.topics.size(); ++i) {
+    matches[i] = filter(mIndex.topics[i]);
+  }
+
+  const auto first = std::upper_bound(
+    std::begin(mFirst),
+    std::end(mFirst),
+    begin
+  );
+  auto block = static_cast<size_t>(first - std::begin(mFirst)) - 1;
+
+  Record record;
+  uint32_t topicId = 0;
+  for (; block != mIndex.blocks.size() && mFirst[block] < end; ++block) {
+    const auto &topics = mIndex.blocks[block].topics;
+    const bool relevant = std::any_of(
+      std::begin(topics),
+      std::end(topics),
+      [&matches](uint32_t topic) { return matches.at(topic); }
+    );
+    if (!relevant) { continue; }
+
+    const auto *cached = load(block);
+    if (cached == nullptr) { return; }
+
+    const auto from = std::max(begin, mFirst[block]);
+    const auto to = std::min(end, mFirst[block + 1]);
+    for (size_t index = from; index != to; ++index) {
+      const auto offset = cached->offsets[index - mFirst[block]];
+      auto remaining = std::string_view(cached->raw).substr(offset);
+      if (!Binary::readRecord(remaining, mIndex.topics, record, &topicId)) {
+        return;
+      }
+      if (matches[topicId]) { visitor(index, record); }
+    }
+  }
+}
+
+bool BinaryView::failed() const { return mFailed; }
+
+bool BinaryView::readIndex() {
+  const auto data = mFile.data();
+  if (data.size() < Binary::HeaderSize + Binary::TrailerSize) { return false; }
+
+  uint64_t footerOffset = 0;
+  uint32_t footerSize = 0;
+  const bool framed = Binary::readFrame(
+    data.substr(0, Binary::HeaderSize),
+    data.substr(data.size() - Binary::TrailerSize),
+    data.size(),
+    footerOffset,
+    footerSize
+  );
+  if (!framed) { return false; }
+
+  const auto footer = data.substr(footerOffset, footerSize);
+  if (!Binary::readIndex(footer, footerOffset, mIndex)) { return false; }
+
+  mFirst.reserve(mIndex.blocks.size() + 1);
+  mCheckpoints.reserve(mIndex.blocks.size());
+  size_t total = 0;
+  for (const auto &block : mIndex.blocks) {
+    auto timestamp = system_clock::time_point(
+      duration_cast<system_clock::duration>(nanoseconds(block.first))
+    );
+    if (!mCheckpoints.empty()) {
+      timestamp = std::max(timestamp, mCheckpoints.back().timestamp);
+    }
+
+    mFirst.push_back(total);
+    mCheckpoints.push_back({total, timestamp});
+    total += block.records;
+  }
+  mFirst.push_back(total);
+
+  return true;
+}
+
+const BinaryView::Cached *BinaryView::load(size_t block) {
+  ++mTick;
+
+  for (auto &cached : mCache) {
+    if (cached.block == block) {
+      cached.used = mTick;
+      return &cached;
+    }
+  }
+
+  Cached *target = nullptr;
+  if (mCache.size() < CachedBlocks) {
+    target = &mCache.emplace_back();
+  } else {
+    target = &*std::min_element(
+      std::begin(mCache),
+      std::end(mCache),
+      [](const Cached &lhs, const Cached &rhs) { return lhs.used < rhs.used; }
+    );
+  }
+
+  const auto &info = mIndex.blocks.at(block);
+  const auto data = mFile.data().substr(
+    info.offset,
+    Binary::BlockHeaderSize + info.compressed
+  );
+  if (!Binary::inflate(data, info, target->raw)) {
+    mLogger->warn("Corrupted block {}", block);
+    target->used = 0;
+    target->block = mIndex.blocks.size();
+    return nullptr;
+  }
+
+  target->offsets.clear();
+  target->offsets.reserve(info.records);
+  Binary::Cursor cursor(target->raw);
+  while (cursor.remaining() != 0) {
+    const auto offset = target->raw.size() - cursor.remaining();
+    uint32_t length = 0;
+    std::string_view body;
+    if (!cursor.get(length) || !cursor.take(length, body)) { break; }
+    target->offsets.push_back(static_cast<uint32_t>(offset));
+  }
+  if (target->offsets.size() != info.records) {
+    mLogger->warn("Block {} does not match the index", block);
+    target->used = 0;
+    target->block = mIndex.blocks.size();
+    return nullptr;
+  }
+
+  target->block = block;
+  target->used = mTick;
+  return target;
+}
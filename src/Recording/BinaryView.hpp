@@ -0,0 +1,59 @@
+#pragma once
+
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "Common/MappedFile.hpp"
+#include "Recording/Binary.hpp"
+#include "Recording/View.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// Uses the block index stored in the footer. Only a few decompressed blocks
+// are kept around at any time.
+class BinaryView : public View
+{
+public:
+
+  explicit BinaryView(const std::string &path);
+
+  [[nodiscard]] const std::vector<Subscription> &subscriptions(
+  ) const override;
+  [[nodiscard]] const std::vector<Checkpoint> &checkpoints() const override;
+  [[nodiscard]] size_t size() const override;
+  [[nodiscard]] std::unique_ptr<View> clone() const override;
+  bool get(size_t index, Record &record) override;
+  void scan(
+    size_t begin,
+    size_t end,
+    const TopicFilter &filter,
+    const Visitor &visitor
+  ) override;
+
+  [[nodiscard]] bool failed() const;
+
+private:
+
+  struct Cached {
+    size_t block = 0;
+    size_t used = 0;
+    std::string raw;
+    std::vector<uint32_t> offsets;
+  };
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::string mPath;
+  Common::MappedFile mFile;
+  Binary::Index mIndex;
+  std::vector<size_t> mFirst;
+  std::vector<Checkpoint> mCheckpoints;
+  std::vector<Cached> mCache;
+  size_t mTick = 0;
+  bool mFailed = false;
+
+  bool readIndex();
+  const Cached *load(size_t block);
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,156 @@
+#include "BinaryWriter.hpp"
+
+#include <zlib.h>
+
+#include "Common/Log.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+using namespace std::chrono;
+
+BinaryWriter::BinaryWriter(std::string path) :
+  mFile(std::move(path)) //
+{
+  mLogger = Common::Log::create("Recording::BinaryWriter");
+}
+
+bool BinaryWriter::begin(const std::vector<Subscription> &subscriptions) {
+  if (!mFile.open()) { return false; }
+
+  mSubscriptions = subscriptions;
+  mRaw.reserve(Binary::BlockSize + Binary::BlockSize / 4);
+
+  std::string header(Binary::Magic.data(), Binary::Magic.size());
+  Binary::put(header, Binary::Version);
+  Binary::put(header, uint16_t{0});
+  auto &out = mFile.stream();
+  out.write(header.data(), static_cast<std::streamsize>(header.size()));
+  mOffset = header.size();
+
+  return out.good();
+}
+
+bool BinaryWriter::write(const Record &record) {
+  const auto timestamp = static_cast<int64_t>(
+    duration_cast<nanoseconds>(record.timestamp.time_since_epoch()).count()
+  );
+  const auto topicId = intern(record.topic);
+  const auto length = Binary::RecordHeaderSize + record.payload.size();
+  const uint8_t flags = record.retained ? Binary::RetainedFlag : 0;
+
+  Binary::put(mRaw, static_cast<uint32_t>(length));
+  Binary::put(mRaw, timestamp);
+  Binary::put(mRaw, static_cast<uint64_t>(record.subscriptionId));
+  Binary::put(mRaw, topicId);
+  Binary::put(mRaw, static_cast<uint8_t>(record.qos));
+  Binary::put(mRaw, flags);
+  mRaw.append(record.payload);
+
+  if (mBlock.records == 0) {
+    mBlock.first = timestamp;
+    mBlock.last = timestamp;
+  }
+  mBlock.first = std::min(mBlock.first, timestamp);
+  mBlock.last = std::max(mBlock.last, timestamp);
+  ++mBlock.records;
+  if (mBlockTopics.size() <= topicId) { mBlockTopics.resize(topicId + 1); }
+  if (!mBlockTopics[topicId]) {
+    mBlockTopics[topicId] = true;
+    mBlock.topics.push_back(topicId);
+  }
+
+  if (mRaw.size() >= Binary::BlockSize) { return flush(); }
+  return true;
+}
+
+bool BinaryWriter::end() {
+  if (!flush()) { return false; }
+
+  std::string footer;
+  Binary::put(footer, static_cast<uint32_t>(mSubscriptions.size()));
+  for (const auto &subscription : mSubscriptions) {
+    Binary::put(footer, static_cast<uint64_t>(subscription.id));
+    Binary::put(footer, static_cast<uint8_t>(subscription.qos));
+    Binary::put(footer, std::string_view(subscription.filter));
+  }
+  Binary::put(footer, static_cast<uint32_t>(mTopics.size()));
+  for (const auto &topic : mTopics) {
+    Binary::put(footer, std::string_view(topic));
+  }
+  Binary::put(footer, static_cast<uint32_t>(mBlocks.size()));
+  for (const auto &block : mBlocks) {
+    Binary::put(footer, block.offset);
+    Binary::put(footer, block.compressed);
+    Binary::put(footer, block.raw);
+    Binary::put(footer, block.records);
+    Binary::put(footer, block.first);
+    Binary::put(footer, block.last);
+    Binary::put(footer, static_cast<uint32_t>(block.topics.size()));
+    for (const auto topicId : block.topics) { Binary::put(footer, topicId); }
+  }
+
+  std::string trailer;
+  Binary::put(trailer, mOffset);
+  Binary::put(trailer, static_cast<uint32_t>(footer.size()));
+  trailer.append(Binary::Magic.data(), Binary::Magic.size());
+
+  auto &out = mFile.stream();
+  out.write(footer.data(), static_cast<std::streamsize>(footer.size()));
+  out.write(trailer.data(), static_cast<std::streamsize>(trailer.size()));
+  return mFile.commit();
+}
+
+uint32_t BinaryWriter::intern(std::string_view topic) {
+  const auto it = mTopicIds.find(topic);
+  if (it != std::end(mTopicIds)) { return it->second; }
+
+  const auto topicId = static_cast<uint32_t>(mTopics.size());
+  mTopics.emplace_back(topic);
+  mTopicIds.emplace(mTopics.back(), topicId);
+  return topicId;
+}
+
+bool BinaryWriter::flush() {
+  if (mBlock.records == 0) { return true; }
+
+  auto bound = compressBound(static_cast<uLong>(mRaw.size()));
+  mCompressed.resize(bound);
+  const auto result = compress2(
+    reinterpret_cast<Bytef *>(mCompressed.data()), // NOLINT
+    &bound,
+    reinterpret_cast<const Bytef *>(mRaw.data()), // NOLINT
+    static_cast<uLong>(mRaw.size()),
+    Z_DEFAULT_COMPRESSION
+  );
+  if (result != Z_OK) {
+    mLogger->error("Could not compress block: {}", result);
+    return false;
+  }
+
+  const auto crc = crc32(
+    0,
+    reinterpret_cast<const Bytef *>(mRaw.data()), // NOLINT
+    static_cast<uInt>(mRaw.size())
+  );
+
+  std::string header;
+  Binary::put(header, static_cast<uint32_t>(bound));
+  Binary::put(header, static_cast<uint32_t>(mRaw.size()));
+  Binary::put(header, static_cast<uint32_t>(crc));
+  auto &out = mFile.stream();
+  out.write(header.data(), static_cast<std::streamsize>(header.size()));
+  out.write(mCompressed.data(), static_cast<std::streamsize>(bound));
+
+  mBlock.offset = mOffset;
+  mBlock.compressed = static_cast<uint32_t>(bound);
+  mBlock.raw = static_cast<uint32_t>(mRaw.size());
+  mBlocks.push_back(std::move(mBlock));
+  mOffset += header.size() + bound;
+
+  mBlock = {};
+  mBlockTopics.assign(mBlockTopics.size(), false);
+  mRaw.clear();
+
+  return out.good();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <spdlog/spdlog.h>
+
+#include "Recording/Binary.hpp"
+#include "Recording/PartFile.hpp"
+#include "Recording/Writer.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+class BinaryWriter : public Writer
+{
+public:
+
+  explicit BinaryWriter(std::string path);
+
+  bool begin(const std::vector<Subscription> &subscriptions) override;
+  bool write(const Record &record) override;
+  bool end() override;
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  PartFile mFile;
+  uint64_t mOffset = 0;
+  std::vector<Subscription> mSubscriptions;
+  // A deque, so that the keys of mTopicIds stay valid as topics come.
+  std::deque<std::string> mTopics;
+  std::unordered_map<std::string_view, uint32_t> mTopicIds;
+  std::vector<Binary::BlockInfo> mBlocks;
+  Binary::BlockInfo mBlock;
+  std::vector<bool> mBlockTopics;
+  std::string mRaw;
+  std::string mCompressed;
+
+  uint32_t intern(std::string_view topic);
+  bool flush();
+};
+
+} // namespace Rapatas::Transmitron::Recording
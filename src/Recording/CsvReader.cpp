@@ -0,0 +1,209 @@
+#include "CsvReader.hpp"
+
+#include <algorithm>
+#include <limits>
+
+#include "Common/Helpers.hpp"
+#include "Common/Log.hpp"
+#include "Recording/Encoding.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+
+constexpr size_t None = std::numeric_limits<size_t>::max();
+constexpr std::string_view Utf8Bom = "\xEF\xBB\xBF";
+
+CsvReader::CsvReader(const std::string &path) :
+  mInput(path, std::ios::binary),
+  mColumns(static_cast<size_t>(Column::Max), None) //
+{
+  mLogger = Common::Log::create("Recording::CsvReader");
+
+  if (!mInput.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->warn("Could not open '{}': {}", path, ec.message());
+    mFailed = true;
+    return;
+  }
+
+  mInput.seekg(0, std::ios::end);
+  mSize = static_cast<size_t>(mInput.tellg());
+  mInput.seekg(0);
+
+  if (!readHeader()) {
+    mLogger->warn("Could not parse the header of '{}'", path);
+    mFailed = true;
+    return;
+  }
+
+  Record record;
+  while (readRow()) {
+    if (!parse(record, true)) {
+      mLogger->warn("Malformed row at offset {}", mOffset);
+      mFailed = true;
+      return;
+    }
+  }
+  if (mFailed) { return; }
+
+  mInput.clear();
+  mInput.seekg(static_cast<std::streamoff>(mDataOffset));
+  mOffset = mDataOffset;
+}
+
+const std::vector<Subscription> &CsvReader::subscriptions() const {
+  return mSubscriptions;
+}
+
+bool CsvReader::next(Record &record) {
+  if (mFailed || !readRow()) { return false; }
+
+  if (!parse(record, false)) {
+    mLogger->warn("Malformed row at offset {}", mOffset);
+    mFailed = true;
+    return false;
+  }
+  return true;
+}
+
+size_t CsvReader::position() const { return mOffset; }
+
+size_t CsvReader::size() const { return mSize; }
+
+bool CsvReader::failed() const { return mFailed; }
+
+bool CsvReader::readHeader() {
+  if (!readRow()) { return false; }
+
+  static const std::map<std::string_view, Column> Names{
+    {"time", Column::Time},
+    {"subscription", Column::Subscription},
+    {"topic", Column::Topic},
+    {"qos", Column::Qos},
+    {"retained", Column::Retained},
+    {"encoding", Column::Encoding},
+    {"payload", Column::Payload},
+  };
+
+  auto &first = mFields.front();
+  if (first.compare(0, Utf8Bom.size(), Utf8Bom) == 0) {
+    first.erase(0, Utf8Bom.size());
+  }
+
+  for (size_t i = 0; i != mFieldCount; ++i) {
+    const auto it = Names.find(mFields[i]);
+    if (it == std::end(Names)) { continue; }
+    mColumns[static_cast<size_t>(it->second)] = i;
+  }
+
+  mDataOffset = mOffset;
+  return true //
+    && mColumns[static_cast<size_t>(Column::Time)] != None
+    && mColumns[static_cast<size_t>(Column::Topic)] != None
+    && mColumns[static_cast<size_t>(Column::Payload)] != None;
+}
+
+bool CsvReader::readRow() {
+  auto *buffer = mInput.rdbuf();
+  mFieldCount = 0;
+
+  const auto nextField = [this]() -> std::string & {
+    if (mFieldCount == mFields.size()) { mFields.emplace_back(); }
+    auto &result = mFields[mFieldCount++];
+    result.clear();
+    return result;
+  };
+
+  // Blank lines between rows are skipped.
+  auto value = buffer->sbumpc();
+  while (value == '\r' || value == '\n') {
+    ++mOffset;
+    value = buffer->sbumpc();
+  }
+  if (value == std::char_traits<char>::eof()) { return false; }
+
+  auto *current = &nextField();
+  bool quoted = false;
+  while (value != std::char_traits<char>::eof()) {
+    ++mOffset;
+    const auto character = static_cast<char>(value);
+
+    if (quoted) {
+      if (character != '"') {
+        current->push_back(character);
+      } else if (buffer->sgetc() == '"') {
+        buffer->sbumpc();
+        ++mOffset;
+        current->push_back('"');
+      } else {
+        quoted = false;
+      }
+    } else if (character == '"') {
+      quoted = true;
+    } else if (character == ',') {
+      current = &nextField();
+    } else if (character == '\n') {
+      break;
+    } else if (character != '\r') {
+      current->push_back(character);
+    }
+
+    value = buffer->sbumpc();
+  }
+
+  if (quoted) {
+    mLogger->warn("Unterminated quoted field at offset {}", mOffset);
+    mFailed = true;
+    return false;
+  }
+  return true;
+}
+
+bool CsvReader::parse(Record &record, bool collect) {
+  record = {};
+
+  // Same numbering as the other recording formats.
+  const auto &qos = field(Column::Qos);
+  if (qos.size() == 1 && qos[0] >= '0' && qos[0] <= '2') {
+    record.qos = static_cast<MQTT::QoS>(qos[0] - '0');
+  } else if (!qos.empty()) {
+    return false;
+  }
+
+  const auto &filter = field(Column::Subscription);
+  if (collect) {
+    const auto it = mIds.find(filter);
+    if (it != std::end(mIds)) {
+      auto &subscription = mSubscriptions.at(it->second);
+      subscription.qos = std::max(subscription.qos, record.qos);
+      return true;
+    }
+    const auto id = static_cast<MQTT::Subscription::Id>(mIds.size());
+    mIds.emplace(filter, id);
+    mSubscriptions.push_back({id, filter, record.qos});
+    return true;
+  }
+  record.subscriptionId = mIds.at(filter);
+
+  const auto timestamp = Common::Helpers::isoStringToTime(field(Column::Time));
+  if (!timestamp.has_value()) { return false; }
+  record.timestamp = *timestamp;
+
+  const auto encoding = toEncoding(field(Column::Encoding));
+  if (!encoding.has_value()) { return false; }
+  if (!decode(field(Column::Payload), *encoding, mPayload)) { return false; }
+
+  const auto &retained = field(Column::Retained);
+  record.retained = retained == "true" || retained == "1";
+
+  record.topic = field(Column::Topic);
+  record.payload = mPayload;
+  return true;
+}
+
+const std::string &CsvReader::field(Column column) const {
+  static const std::string Empty;
+  const auto index = mColumns.at(static_cast<size_t>(column));
+  if (index >= mFieldCount) { return Empty; }
+  return mFields[index];
+}
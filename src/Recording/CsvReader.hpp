@@ -0,0 +1,63 @@
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "Recording/Reader.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// Reads CSV with a header row naming its columns, as written by CsvWriter.
+// The time, topic and payload columns are required, the rest default.
+// Subscriptions are only stored by filter, so a first pass over the file
+// collects them.
+class CsvReader : public Reader
+{
+public:
+
+  explicit CsvReader(const std::string &path);
+
+  [[nodiscard]] const std::vector<Subscription> &subscriptions(
+  ) const override;
+  bool next(Record &record) override;
+  [[nodiscard]] size_t position() const override;
+  [[nodiscard]] size_t size() const override;
+  [[nodiscard]] bool failed() const override;
+
+private:
+
+  enum class Column : uint8_t {
+    Time,
+    Subscription,
+    Topic,
+    Qos,
+    Retained,
+    Encoding,
+    Payload,
+    Max
+  };
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::ifstream mInput;
+  size_t mOffset = 0;
+  size_t mSize = 0;
+  size_t mDataOffset = 0;
+  std::vector<Subscription> mSubscriptions;
+  std::map<std::string, MQTT::Subscription::Id> mIds;
+  // Index of each column in the rows, or None when it is missing.
+  std::vector<size_t> mColumns;
+  std::vector<std::string> mFields;
+  size_t mFieldCount = 0;
+  std::string mPayload;
+  bool mFailed = false;
+
+  bool readHeader();
+  bool readRow();
+  bool parse(Record &record, bool collect);
+  [[nodiscard]] const std::string &field(Column column) const;
+};
+
+} // namespace Rapatas::Transmitron::Recording
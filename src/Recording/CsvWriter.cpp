@@ -0,0 +1,69 @@
+#include "CsvWriter.hpp"
+
+#include "Common/Helpers.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+
+namespace {
+
+void appendField(std::string &line, std::string_view field) {
+  if (field.find_first_of(",\"\r\n") == std::string_view::npos) {
+    line.append(field);
+    return;
+  }
+
+  line.push_back('"');
+  for (const auto value : field) {
+    if (value == '"') { line.push_back('"'); }
+    line.push_back(value);
+  }
+  line.push_back('"');
+}
+
+} // namespace
+
+CsvWriter::CsvWriter(std::string path, Encoding encoding) :
+  mFile(std::move(path)),
+  mEncoding(encoding) //
+{}
+
+bool CsvWriter::begin(const std::vector<Subscription> &subscriptions) {
+  if (!mFile.open()) { return false; }
+
+  for (const auto &subscription : subscriptions) {
+    mFilters[subscription.id] = subscription.filter;
+  }
+
+  mFile.stream() << "time,subscription,topic,qos,retained,encoding,payload\r\n";
+  return mFile.stream().good();
+}
+
+bool CsvWriter::write(const Record &record) {
+  encode(record.payload, mEncoding, mPayload);
+
+  mLine.clear();
+  mLine.append(Helpers::timeToIsoString(record.timestamp));
+  mLine.push_back(',');
+  const auto filter = mFilters.find(record.subscriptionId);
+  if (filter != std::end(mFilters)) { appendField(mLine, filter->second); }
+  mLine.push_back(',');
+  appendField(mLine, record.topic);
+  mLine.push_back(',');
+  mLine.append(std::to_string(static_cast<unsigned>(record.qos)));
+  mLine.push_back(',');
+  mLine.append(record.retained ? "true" : "false");
+  mLine.push_back(',');
+  mLine.append(toString(mEncoding));
+  mLine.push_back(',');
+  appendField(mLine, mPayload);
+  mLine.append("\r\n");
+
+  mFile.stream() << mLine;
+  return mFile.stream().good();
+}
+
+bool CsvWriter::end() {
+  return mFile.commit();
+}
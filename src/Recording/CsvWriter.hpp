@@ -0,0 +1,33 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "Recording/Encoding.hpp"
+#include "Recording/PartFile.hpp"
+#include "Recording/Writer.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// RFC 4180 CSV with a header row, for spreadsheets and data tools.
+// Subscriptions are stored by filter on every row.
+class CsvWriter : public Writer
+{
+public:
+
+  CsvWriter(std::string path, Encoding encoding);
+
+  bool begin(const std::vector<Subscription> &subscriptions) override;
+  bool write(const Record &record) override;
+  bool end() override;
+
+private:
+
+  PartFile mFile;
+  Encoding mEncoding;
+  std::map<MQTT::Subscription::Id, std::string> mFilters;
+  std::string mPayload;
+  std::string mLine;
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,147 @@
+#include "Encoding.hpp"
+
+#include <array>
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+
+namespace {
+
+constexpr std::string_view Base64Alphabet =
+  "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+constexpr std::string_view HexDigits = "0123456789abcdef";
+constexpr uint8_t Invalid = 0xFF;
+constexpr size_t Base64Bits = 6;
+constexpr uint32_t Base64Mask = 0x3F;
+constexpr uint32_t ByteMask = 0xFF;
+constexpr size_t ByteBits = 8;
+constexpr size_t NibbleBits = 4;
+constexpr uint8_t NibbleMask = 0x0F;
+
+constexpr std::array<uint8_t, 256> makeBase64Table() {
+  std::array<uint8_t, 256> result{};
+  for (auto &value : result) { value = Invalid; }
+  for (size_t i = 0; i != Base64Alphabet.size(); ++i) {
+    result.at(static_cast<uint8_t>(Base64Alphabet[i])) =
+      static_cast<uint8_t>(i);
+  }
+  return result;
+}
+
+constexpr auto Base64Table = makeBase64Table();
+
+uint8_t hexValue(char digit) {
+  if (digit >= '0' && digit <= '9') {
+    return static_cast<uint8_t>(digit - '0');
+  }
+  if (digit >= 'a' && digit <= 'f') {
+    return static_cast<uint8_t>(digit - 'a' + 10); // NOLINT
+  }
+  if (digit >= 'A' && digit <= 'F') {
+    return static_cast<uint8_t>(digit - 'A' + 10); // NOLINT
+  }
+  return Invalid;
+}
+
+} // namespace
+
+std::string_view Recording::toString(Encoding encoding) {
+  switch (encoding) {
+    case Encoding::Base64: return "base64";
+    case Encoding::Hex: return "hex";
+    default: return "utf8";
+  }
+}
+
+std::optional<Encoding> Recording::toEncoding(std::string_view name) {
+  if (name == "utf8" || name.empty()) { return Encoding::Utf8; }
+  if (name == "base64") { return Encoding::Base64; }
+  if (name == "hex") { return Encoding::Hex; }
+  return std::nullopt;
+}
+
+void Recording::encode(
+  std::string_view data,
+  Encoding encoding,
+  std::string &result
+) {
+  result.clear();
+
+  switch (encoding) {
+    case Encoding::Utf8: {
+      result.assign(data);
+    } break;
+
+    case Encoding::Base64: {
+      result.reserve((data.size() + 2) / 3 * 4);
+      uint32_t buffer = 0;
+      size_t bits = 0;
+      for (const auto byte : data) {
+        buffer = (buffer << ByteBits) | static_cast<uint8_t>(byte);
+        bits += ByteBits;
+        while (bits >= Base64Bits) {
+          bits -= Base64Bits;
+          result.push_back(Base64Alphabet[(buffer >> bits) & Base64Mask]);
+        }
+      }
+      if (bits != 0) {
+        const auto shift = Base64Bits - bits;
+        result.push_back(Base64Alphabet[(buffer << shift) & Base64Mask]);
+      }
+      while (result.size() % 4 != 0) { result.push_back('='); }
+    } break;
+
+    case Encoding::Hex: {
+      result.reserve(data.size() * 2);
+      for (const auto byte : data) {
+        const auto value = static_cast<uint8_t>(byte);
+        result.push_back(HexDigits[value >> NibbleBits]);
+        result.push_back(HexDigits[value & NibbleMask]);
+      }
+    } break;
+  }
+}
+
+bool Recording::decode(
+  std::string_view data,
+  Encoding encoding,
+  std::string &result
+) {
+  result.clear();
+
+  switch (encoding) {
+    case Encoding::Utf8: {
+      result.assign(data);
+    } break;
+
+    case Encoding::Base64: {
+      while (!data.empty() && data.back() == '=') { data.remove_suffix(1); }
+      result.reserve(data.size() * 3 / 4);
+      uint32_t buffer = 0;
+      size_t bits = 0;
+      for (const auto digit : data) {
+        const auto value = Base64Table.at(static_cast<uint8_t>(digit));
+        if (value == Invalid) { return false; }
+        buffer = (buffer << Base64Bits) | value;
+        bits += Base64Bits;
+        if (bits >= ByteBits) {
+          bits -= ByteBits;
+          result.push_back(static_cast<char>((buffer >> bits) & ByteMask));
+        }
+      }
+    } break;
+
+    case Encoding::Hex: {
+      if (data.size() % 2 != 0) { return false; }
+      result.reserve(data.size() / 2);
+      for (size_t i = 0; i != data.size(); i += 2) {
+        const auto high = hexValue(data[i]);
+        const auto low = hexValue(data[i + 1]);
+        if (high == Invalid || low == Invalid) { return false; }
+        result.push_back(static_cast<char>((high << NibbleBits) | low));
+      }
+    } break;
+  }
+
+  return true;
+}
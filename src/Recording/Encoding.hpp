@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace Rapatas::Transmitron::Recording {
+
+// How payloads are written to text formats. Only base64 and hex are safe
+// for binary payloads.
+enum class Encoding : uint8_t {
+  Utf8,
+  Base64,
+  Hex,
+};
+
+std::string_view toString(Encoding encoding);
+std::optional<Encoding> toEncoding(std::string_view name);
+
+void encode(std::string_view data, Encoding encoding, std::string &result);
+bool decode(std::string_view data, Encoding encoding, std::string &result);
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,353 @@
+#include "Journal.hpp"
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <sys/file.h>
+#include <unistd.h>
+#endif // _WIN32
+
+#include <zlib.h>
+
+#include "Common/Filesystem.hpp"
+#include "Common/Log.hpp"
+#include "Recording/Binary.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+using namespace std::chrono;
+
+// The worker wakes up early once this much is queued.
+constexpr size_t BatchSize = 256 * 1024;
+// Past this much queued, messages are dropped instead of queued.
+constexpr size_t MaxPending = 64 * 1024 * 1024;
+constexpr auto FlushInterval = milliseconds(200);
+constexpr auto SyncInterval = seconds(1);
+constexpr auto ReportInterval = seconds(10);
+// Fixed part of the frame bodies, after the type.
+constexpr size_t SubscriptionSize = 13;
+constexpr size_t TopicSize = 8;
+constexpr size_t MessageSize = 22;
+constexpr size_t ByteBits = 8;
+
+namespace {
+
+// Lock held for as long as the file is open, released by closing it.
+bool lockFile(std::FILE *file) {
+#ifdef _WIN32
+  auto *handle = reinterpret_cast<HANDLE>( // NOLINT
+    ::_get_osfhandle(::_fileno(file))
+  );
+  OVERLAPPED overlapped{};
+  return ::LockFileEx(
+           handle,
+           LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY,
+           0,
+           MAXDWORD,
+           MAXDWORD,
+           &overlapped
+         )
+    != 0;
+#else
+  return ::flock(::fileno(file), LOCK_EX | LOCK_NB) == 0;
+#endif // _WIN32
+}
+
+// Writing appends, and leaves any previous content to be truncated once the
+// file is locked, in case another session still holds it.
+std::FILE *openFile(const std::string &path, bool write) {
+#ifdef _WIN32
+  return ::_wfopen(fs::path(path).c_str(), write ? L"ab" : L"rb");
+#else
+  return std::fopen(path.c_str(), write ? "ab" : "rb");
+#endif // _WIN32
+}
+
+bool truncateFile(std::FILE *file) {
+#ifdef _WIN32
+  return ::_chsize_s(::_fileno(file), 0) == 0;
+#else
+  return ::ftruncate(::fileno(file), 0) == 0;
+#endif // _WIN32
+}
+
+} // namespace
+
+Journal::Journal(std::string path) :
+  mPath(std::move(path)) //
+{
+  mLogger = Common::Log::create("Recording::Journal");
+
+  mFile = openFile(mPath, true);
+  if (mFile == nullptr) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->error("Could not open '{}': {}", mPath, ec.message());
+    mFailed = true;
+    return;
+  }
+  if (!lockFile(mFile)) {
+    mLogger->error("Could not lock '{}'", mPath);
+    mFailed = true;
+    return;
+  }
+  if (!truncateFile(mFile)) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->error("Could not truncate '{}': {}", mPath, ec.message());
+    mFailed = true;
+    return;
+  }
+
+  std::string header(Magic.data(), Magic.size());
+  Binary::put(header, Version);
+  Binary::put(header, uint16_t{0});
+  if (std::fwrite(header.data(), 1, header.size(), mFile) != header.size()) {
+    mLogger->error("Could not write '{}'", mPath);
+    mFailed = true;
+    return;
+  }
+
+  mPending.reserve(BatchSize * 2);
+  mWriting.reserve(BatchSize * 2);
+  mThread = std::thread([this]() { run(); });
+  mLogger->info("Journaling to '{}'", mPath);
+}
+
+Journal::~Journal() { stop(); }
+
+bool Journal::failed() const { return mFailed; }
+
+bool Journal::held(const std::string &path) {
+  auto *file = openFile(path, false);
+  if (file == nullptr) { return false; }
+  const bool locked = !lockFile(file);
+  std::fclose(file);
+  return locked;
+}
+
+bool Journal::knows(MQTT::Subscription::Id subscriptionId) const {
+  return mSubscriptions.count(subscriptionId) != 0;
+}
+
+void Journal::subscribe(const Subscription &subscription) {
+  if (mFailed || mFile == nullptr) { return; }
+  mSubscriptions.insert(subscription.id);
+
+  const auto &filter = subscription.filter;
+  mScratch.clear();
+  frame(mScratch, Frame::Subscription, SubscriptionSize + filter.size());
+  Binary::put(mScratch, static_cast<uint64_t>(subscription.id));
+  Binary::put(mScratch, static_cast<uint8_t>(subscription.qos));
+  Binary::put(mScratch, std::string_view(filter));
+  queue(mScratch.size());
+}
+
+void Journal::append(const Record &record) {
+  if (mFailed || mFile == nullptr) { return; }
+
+  auto &out = mScratch;
+  out.clear();
+
+  const auto topic = record.topic;
+  auto it = mTopicIds.find(topic);
+  if (it == std::end(mTopicIds)) {
+    const auto topicId = static_cast<uint32_t>(mTopicIds.size());
+    frame(out, Frame::Topic, TopicSize + topic.size());
+    Binary::put(out, topicId);
+    Binary::put(out, topic);
+    it = mTopicIds.emplace(mTopics.emplace_back(topic), topicId).first;
+  }
+
+  // Topics are always kept, only the message may drop.
+  const auto required = out.size();
+
+  const auto timestamp = static_cast<int64_t>(
+    duration_cast<nanoseconds>(record.timestamp.time_since_epoch()).count()
+  );
+  frame(out, Frame::Message, MessageSize + record.payload.size());
+  Binary::put(out, timestamp);
+  Binary::put(out, static_cast<uint64_t>(record.subscriptionId));
+  Binary::put(out, it->second);
+  Binary::put(out, static_cast<uint8_t>(record.qos));
+  Binary::put(out, record.retained ? Binary::RetainedFlag : uint8_t{0});
+  out.append(record.payload);
+
+  queue(required);
+}
+
+void Journal::clear(MQTT::Subscription::Id subscriptionId) {
+  if (mFailed || mFile == nullptr) { return; }
+  mScratch.clear();
+  frame(mScratch, Frame::Clear, sizeof(uint64_t));
+  Binary::put(mScratch, static_cast<uint64_t>(subscriptionId));
+  queue(mScratch.size());
+}
+
+void Journal::clear() {
+  if (mFailed || mFile == nullptr) { return; }
+  mScratch.clear();
+  frame(mScratch, Frame::Clear, sizeof(uint64_t));
+  Binary::put(mScratch, ClearAll);
+  queue(mScratch.size());
+}
+
+void Journal::discard() {
+  stop();
+  std::error_code ec;
+  fs::remove(mPath, ec);
+}
+
+Journal::Stats Journal::stats() const {
+  return {mMessages, mBytes, mSyncs, mDropped};
+}
+
+void Journal::frame(std::string &out, Frame type, size_t size) {
+  Binary::put(out, static_cast<uint32_t>(size + 1));
+  Binary::put(out, uint32_t{0});
+  Binary::put(out, static_cast<uint8_t>(type));
+}
+
+void Journal::queue(size_t required) {
+  bool wake = false;
+  {
+    std::lock_guard lock(mMutex);
+    const auto before = mPending.size();
+    if (before + mScratch.size() <= MaxPending) {
+      mPending.append(mScratch);
+    } else {
+      mPending.append(mScratch, 0, required);
+      if (required != mScratch.size()) { ++mDropped; }
+    }
+    wake = before < BatchSize && mPending.size() >= BatchSize;
+  }
+  if (wake) { mWake.notify_one(); }
+}
+
+void Journal::run() {
+  auto lastSync = steady_clock::now();
+  auto lastReport = lastSync;
+  Stats reported;
+  bool dirty = false;
+
+  while (true) {
+    bool stopping = false;
+    {
+      std::unique_lock lock(mMutex);
+      mWake.wait_for(lock, FlushInterval, [this]() {
+        return mStopping || mPending.size() >= BatchSize;
+      });
+      std::swap(mPending, mWriting);
+      stopping = mStopping;
+    }
+
+    if (!mWriting.empty()) {
+      if (!write(mWriting)) {
+        mFailed = true;
+        return;
+      }
+      mWriting.clear();
+      dirty = true;
+    }
+
+    const auto now = steady_clock::now();
+    if (dirty && (stopping || now - lastSync >= SyncInterval)) {
+      if (!sync()) {
+        mFailed = true;
+        return;
+      }
+      lastSync = now;
+      dirty = false;
+    }
+
+    if (now - lastReport >= ReportInterval) {
+      const auto current = stats();
+      const auto elapsed = duration<double>(now - lastReport).count();
+      if (current.messages != reported.messages) {
+        mLogger->debug(
+          "{:.0f} messages/s, {:.0f} KiB/s, {} dropped",
+          static_cast<double>(current.messages - reported.messages) / elapsed,
+          static_cast<double>(current.bytes - reported.bytes) / elapsed
+            / 1024.0, // NOLINT
+          current.dropped - reported.dropped
+        );
+      }
+      reported = current;
+      lastReport = now;
+    }
+
+    if (stopping) { return; }
+  }
+}
+
+void Journal::stop() {
+  {
+    std::lock_guard lock(mMutex);
+    mStopping = true;
+  }
+  mWake.notify_one();
+  if (mThread.joinable()) { mThread.join(); }
+  if (mFile == nullptr) { return; }
+
+  std::fclose(mFile);
+  mFile = nullptr;
+
+  const auto current = stats();
+  mLogger->info(
+    "Journaled {} messages ({} bytes) in {} syncs, {} dropped",
+    current.messages,
+    current.bytes,
+    current.syncs,
+    current.dropped
+  );
+}
+
+bool Journal::write(std::string &frames) {
+  // Checksums are left to the worker to keep the caller down to a copy.
+  size_t messages = 0;
+  for (size_t offset = 0; offset + FrameHeaderSize <= frames.size();) {
+    uint32_t size = 0;
+    for (size_t i = 0; i != sizeof(size); ++i) {
+      const auto byte = static_cast<uint8_t>(frames[offset + i]);
+      size |= static_cast<uint32_t>(byte) << (i * ByteBits);
+    }
+    const auto *body = frames.data() + offset + FrameHeaderSize;
+    const auto crc = static_cast<uint32_t>(crc32(
+      0,
+      reinterpret_cast<const Bytef *>(body), // NOLINT
+      static_cast<uInt>(size)
+    ));
+    for (size_t i = 0; i != sizeof(crc); ++i) {
+      frames[offset + sizeof(size) + i] =
+        static_cast<char>((crc >> (i * ByteBits)) & 0xFF); // NOLINT
+    }
+    if (static_cast<Frame>(body[0]) == Frame::Message) { ++messages; }
+    offset += FrameHeaderSize + size;
+  }
+
+  const auto written = std::fwrite(frames.data(), 1, frames.size(), mFile);
+  if (written != frames.size() || std::fflush(mFile) != 0) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->error("Could not write '{}': {}", mPath, ec.message());
+    return false;
+  }
+
+  mMessages += messages;
+  mBytes += frames.size();
+  return true;
+}
+
+bool Journal::sync() {
+#ifdef _WIN32
+  const auto result = ::_commit(::_fileno(mFile));
+#else
+  const auto result = ::fsync(::fileno(mFile));
+#endif // _WIN32
+  if (result != 0) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->error("Could not sync '{}': {}", mPath, ec.message());
+    return false;
+  }
+  ++mSyncs;
+  return true;
+}
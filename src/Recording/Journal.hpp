@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <spdlog/spdlog.h>
+
+#include "Recording/Record.hpp"
+
+// Layout of a .tmrj session journal, all integers little-endian:
+//
+//   Header  "TMRJ" u16:version u16:flags
+//   Frame*  u32:size u32:crc32 u8:type <body of size - 1 bytes>
+//
+// Bodies by type:
+//
+//   Subscription  u64:id u8:qos u32:length filter
+//   Topic         u32:id u32:length topic, ids count up from zero
+//   Message       i64:timestamp (ns since epoch) u64:subscription u32:topic
+//                 u8:qos u8:flags and the payload, which takes the rest
+//   Clear         u64:subscription, or all subscriptions when ClearAll
+//
+// Frames are only ever appended, so after a crash the journal is valid up
+// to the first torn or corrupted frame.
+namespace Rapatas::Transmitron::Recording {
+
+class Journal
+{
+public:
+
+  static constexpr std::array<char, 4> Magic{'T', 'M', 'R', 'J'};
+  static constexpr uint16_t Version = 1;
+  static constexpr size_t HeaderSize = 8;
+  static constexpr size_t FrameHeaderSize = 8;
+  static constexpr uint64_t ClearAll = std::numeric_limits<uint64_t>::max();
+
+  enum class Frame : uint8_t {
+    Subscription = 1,
+    Topic = 2,
+    Message = 3,
+    Clear = 4,
+  };
+
+  struct Stats {
+    size_t messages = 0;
+    size_t bytes = 0;
+    size_t syncs = 0;
+    size_t dropped = 0;
+  };
+
+  // Starts a new journal at path, replacing any previous one unless another
+  // session still holds it, which fails. The file is locked until the
+  // journal is closed.
+  explicit Journal(std::string path);
+  Journal(const Journal &other) = delete;
+  Journal(Journal &&other) = delete;
+  Journal &operator=(const Journal &other) = delete;
+  Journal &operator=(Journal &&other) = delete;
+  ~Journal();
+
+  [[nodiscard]] bool failed() const;
+  // Whether the journal at path is locked by a session still writing it,
+  // in this process or another.
+  [[nodiscard]] static bool held(const std::string &path);
+
+  // These only queue frames, the file is written and synced by a worker.
+  // When the worker falls too far behind, messages are dropped instead of
+  // blocking the caller. Calls must come from a single thread, and records
+  // only after their subscription.
+  [[nodiscard]] bool knows(MQTT::Subscription::Id subscriptionId) const;
+  void subscribe(const Subscription &subscription);
+  void append(const Record &record);
+  void clear(MQTT::Subscription::Id subscriptionId);
+  void clear();
+
+  // Stops the worker and removes the journal, for sessions closed cleanly.
+  void discard();
+
+  [[nodiscard]] Stats stats() const;
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::string mPath;
+  std::FILE *mFile = nullptr;
+
+  // Only touched by the calling thread.
+  std::unordered_set<MQTT::Subscription::Id> mSubscriptions;
+  // Keyed by views into mTopics, so that looking a topic up copies nothing.
+  std::deque<std::string> mTopics;
+  std::unordered_map<std::string_view, uint32_t> mTopicIds;
+  std::string mScratch;
+
+  // Frames are serialized straight into mPending by the caller and swapped
+  // out by the worker, which fills in their checksums.
+  std::mutex mMutex;
+  std::condition_variable mWake;
+  std::string mPending;
+  std::string mWriting;
+  bool mStopping = false;
+  std::thread mThread;
+
+  std::atomic<size_t> mMessages = 0;
+  std::atomic<size_t> mBytes = 0;
+  std::atomic<size_t> mSyncs = 0;
+  std::atomic<size_t> mDropped = 0;
+  std::atomic<bool> mFailed = false;
+
+  static void frame(std::string &out, Frame type, size_t size);
+  void queue(size_t required);
+  void run();
+  void stop();
+  bool write(std::string &frames);
+  bool sync();
+};
+
+} // namespace Rapatas::Transmitron::Recording
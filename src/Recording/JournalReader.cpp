@@ -0,0 +1,250 @@
+#include "JournalReader.hpp"
+
+#include <algorithm>
+#include <array>
+
+#include <zlib.h>
+
+#include "Common/Log.hpp"
+#include "Recording/Binary.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+
+JournalReader::JournalReader(const std::string &path) :
+  mInput(path, std::ios::binary) //
+{
+  mLogger = Common::Log::create("Recording::JournalReader");
+
+  if (!mInput.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->warn("Could not open '{}': {}", path, ec.message());
+    mFailed = true;
+    return;
+  }
+
+  mInput.seekg(0, std::ios::end);
+  mEnd = static_cast<size_t>(mInput.tellg());
+  mInput.seekg(0);
+
+  std::string header(Journal::HeaderSize, '\0');
+  mInput.read(header.data(), static_cast<std::streamsize>(header.size()));
+  Binary::Cursor cursor(header);
+  std::string_view magic;
+  uint16_t version = 0;
+  if (false // NOLINT
+      || !cursor.take(Journal::Magic.size(), magic)
+      || magic != std::string_view(Journal::Magic.data(), Journal::Magic.size())
+      || !cursor.get(version)) {
+    mLogger->warn("Not a journal: '{}'", path);
+    mFailed = true;
+    return;
+  }
+  if (version != Journal::Version) {
+    mLogger->warn("Unsupported journal version {}: '{}'", version, path);
+    mFailed = true;
+    return;
+  }
+
+  mOffset = Journal::HeaderSize;
+  if (!scan()) {
+    mFailed = true;
+    return;
+  }
+
+  mInput.clear();
+  mInput.seekg(static_cast<std::streamoff>(Journal::HeaderSize));
+  mOffset = Journal::HeaderSize;
+}
+
+const std::vector<Subscription> &JournalReader::subscriptions() const {
+  return mSubscriptions;
+}
+
+bool JournalReader::next(Record &record) {
+  if (mFailed) { return false; }
+
+  Journal::Frame type{};
+  while (true) {
+    const auto offset = mOffset;
+    if (!readFrame(type, true)) { return false; }
+    if (type != Journal::Frame::Message) { continue; }
+
+    Binary::Cursor cursor(std::string_view(mBody).substr(1));
+    int64_t timestamp = 0;
+    uint64_t subscriptionId = 0;
+    uint32_t topicId = 0;
+    uint8_t qos = 0;
+    uint8_t flags = 0;
+    if (false // NOLINT
+        || !cursor.get(timestamp)
+        || !cursor.get(subscriptionId)
+        || !cursor.get(topicId)
+        || !cursor.get(qos)
+        || !cursor.get(flags)
+        || topicId >= mTopics.size()) {
+      mLogger->warn("Malformed message at offset {}", offset);
+      mFailed = true;
+      return false;
+    }
+
+    const auto id = static_cast<MQTT::Subscription::Id>(subscriptionId);
+    const auto cleared = mCleared.find(id);
+    if (false // NOLINT
+        || offset < mClearedAll
+        || (cleared != std::end(mCleared) && offset < cleared->second)) {
+      continue;
+    }
+
+    const auto payload = mBody.size() - cursor.remaining();
+    record.subscriptionId = id;
+    record.topic = mTopics[topicId];
+    record.payload = std::string_view(mBody).substr(payload);
+    record.qos = static_cast<MQTT::QoS>(qos);
+    record.retained = (flags & Binary::RetainedFlag) != 0;
+    record.timestamp = std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+        std::chrono::nanoseconds(timestamp)
+      )
+    );
+    return true;
+  }
+}
+
+size_t JournalReader::position() const { return mOffset; }
+
+size_t JournalReader::size() const { return mEnd; }
+
+bool JournalReader::failed() const { return mFailed; }
+
+bool JournalReader::scan() {
+  Journal::Frame type{};
+  while (true) {
+    const auto offset = mOffset;
+
+    // Messages make up most of the journal and are only checked when read.
+    if (!skipFrame(type)) { break; }
+    if (type == Journal::Frame::Message) { continue; }
+
+    mOffset = offset;
+    mInput.seekg(static_cast<std::streamoff>(offset));
+    if (!readFrame(type, true)) { break; }
+
+    Binary::Cursor cursor(std::string_view(mBody).substr(1));
+    switch (type) {
+      case Journal::Frame::Subscription: {
+        uint64_t id = 0;
+        uint8_t qos = 0;
+        std::string_view filter;
+        if (!cursor.get(id) || !cursor.get(qos) || !cursor.get(filter)) {
+          return false;
+        }
+        mSubscriptions.push_back({
+          static_cast<MQTT::Subscription::Id>(id),
+          std::string(filter),
+          static_cast<MQTT::QoS>(qos),
+        });
+      } break;
+      case Journal::Frame::Topic: {
+        uint32_t id = 0;
+        std::string_view topic;
+        if (!cursor.get(id) || !cursor.get(topic) || id != mTopics.size()) {
+          return false;
+        }
+        mTopics.emplace_back(topic);
+      } break;
+      case Journal::Frame::Clear: {
+        uint64_t id = 0;
+        if (!cursor.get(id)) { return false; }
+        if (id == Journal::ClearAll) {
+          mClearedAll = mOffset;
+        } else {
+          mCleared[static_cast<MQTT::Subscription::Id>(id)] = mOffset;
+        }
+      } break;
+      default: {
+        const auto value = static_cast<unsigned>(type);
+        mLogger->warn("Unknown frame {} at offset {}", value, offset);
+        return false;
+      }
+    }
+  }
+
+  mLogger->info(
+    "Journal holds {} subscriptions and {} topics up to offset {}",
+    mSubscriptions.size(),
+    mTopics.size(),
+    mEnd
+  );
+  return true;
+}
+
+bool JournalReader::readFrame(Journal::Frame &type, bool verify) {
+  if (mOffset + Journal::FrameHeaderSize > mEnd) { return false; }
+
+  std::array<char, Journal::FrameHeaderSize> header{};
+  mInput.read(header.data(), header.size());
+  Binary::Cursor cursor(std::string_view(header.data(), header.size()));
+  uint32_t size = 0;
+  uint32_t crc = 0;
+  cursor.get(size);
+  cursor.get(crc);
+
+  const auto end = mOffset + Journal::FrameHeaderSize + size;
+  if (size == 0 || end > mEnd) {
+    // Torn write of the last frame before the crash.
+    mLogger->info("Journal ends with a partial frame at offset {}", mOffset);
+    mEnd = mOffset;
+    return false;
+  }
+
+  mBody.resize(size);
+  mInput.read(mBody.data(), static_cast<std::streamsize>(size));
+  if (!mInput) {
+    mLogger->warn("Could not read frame at offset {}", mOffset);
+    mEnd = mOffset;
+    return false;
+  }
+
+  if (verify) {
+    const auto actual = crc32(
+      0,
+      reinterpret_cast<const Bytef *>(mBody.data()), // NOLINT
+      static_cast<uInt>(mBody.size())
+    );
+    if (actual != crc) {
+      mLogger->warn("Journal is corrupted at offset {}", mOffset);
+      mEnd = mOffset;
+      return false;
+    }
+  }
+
+  type = static_cast<Journal::Frame>(mBody[0]);
+  mOffset = end;
+  return true;
+}
+
+bool JournalReader::skipFrame(Journal::Frame &type) {
+  if (mOffset + Journal::FrameHeaderSize + 1 > mEnd) {
+    mEnd = std::min(mEnd, mOffset);
+    return false;
+  }
+
+  std::array<char, Journal::FrameHeaderSize + 1> header{};
+  mInput.read(header.data(), header.size());
+  Binary::Cursor cursor(std::string_view(header.data(), header.size()));
+  uint32_t size = 0;
+  cursor.get(size);
+
+  const auto end = mOffset + Journal::FrameHeaderSize + size;
+  if (!mInput || size == 0 || end > mEnd) {
+    mLogger->info("Journal ends with a partial frame at offset {}", mOffset);
+    mEnd = mOffset;
+    return false;
+  }
+
+  type = static_cast<Journal::Frame>(header.back());
+  mOffset = end;
+  mInput.seekg(static_cast<std::streamoff>(end));
+  return true;
+}
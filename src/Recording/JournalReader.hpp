@@ -0,0 +1,51 @@
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "Recording/Journal.hpp"
+#include "Recording/Reader.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// Reads a session journal as a recording. A first pass over the frame
+// headers collects subscriptions, topics and clears, so that messages
+// cleared later in the session are skipped. Reading stops quietly at the
+// first torn or corrupted frame, which is where the session crashed.
+class JournalReader : public Reader
+{
+public:
+
+  explicit JournalReader(const std::string &path);
+
+  [[nodiscard]] const std::vector<Subscription> &subscriptions(
+  ) const override;
+  bool next(Record &record) override;
+  [[nodiscard]] size_t position() const override;
+  [[nodiscard]] size_t size() const override;
+  [[nodiscard]] bool failed() const override;
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::ifstream mInput;
+  size_t mOffset = 0;
+  size_t mEnd = 0;
+  std::vector<Subscription> mSubscriptions;
+  std::vector<std::string> mTopics;
+  size_t mClearedAll = 0;
+  std::map<MQTT::Subscription::Id, size_t> mCleared;
+  std::string mBody;
+  bool mFailed = false;
+
+  bool scan();
+  // Reads the frame at mOffset into mBody and moves past it. Returns false
+  // at the end or at a damaged frame, with `verify` checking the body.
+  bool readFrame(Journal::Frame &type, bool verify);
+  bool skipFrame(Journal::Frame &type);
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,421 @@
+#include "JsonReader.hpp"
+
+#include "Common/Helpers.hpp"
+#include "Common/Log.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+
+constexpr size_t BufferSize = 1024 * 1024;
+
+// Collects the fields of a single message object without building a DOM.
+class JsonReader::Handler : public nlohmann::json_sax<nlohmann::json>
+{
+public:
+
+  Handler(Record &record, std::string &topic, std::string &payload) :
+    mRecord(record),
+    mTopic(topic),
+    mPayload(payload) //
+  {}
+
+  bool null() override { return true; }
+
+  bool boolean(bool value) override {
+    if (mDepth == 1 && mKey == "retained") { mRecord.retained = value; }
+    return true;
+  }
+
+  bool number_integer(number_integer_t value) override {
+    if (value < 0) { return true; }
+    return number_unsigned(static_cast<number_unsigned_t>(value));
+  }
+
+  bool number_unsigned(number_unsigned_t value) override {
+    if (mDepth != 1) { return true; }
+    if (mKey == "subscription") {
+      mRecord.subscriptionId = static_cast<MQTT::Subscription::Id>(value);
+      mHasSubscription = true;
+    } else if (mKey == "qos") {
+      mRecord.qos = static_cast<MQTT::QoS>(value);
+    }
+    return true;
+  }
+
+  bool number_float(
+    number_float_t /* value */,
+    const string_t & /* raw */
+  ) override {
+    return true;
+  }
+
+  bool string(string_t &value) override {
+    if (mDepth != 1) { return true; }
+    if (mKey == "topic") {
+      mTopic = std::move(value);
+    } else if (mKey == "payload") {
+      mPayload = std::move(value);
+    } else if (mKey == "timestamp") {
+      mRecord.timestamp = Common::Helpers::stringToTime(value);
+    }
+    return true;
+  }
+
+  bool binary(binary_t & /* value */) override { return true; }
+
+  bool start_object(std::size_t /* elements */) override {
+    ++mDepth;
+    return true;
+  }
+
+  bool end_object() override {
+    --mDepth;
+    return true;
+  }
+
+  bool start_array(std::size_t /* elements */) override {
+    ++mDepth;
+    return true;
+  }
+
+  bool end_array() override {
+    --mDepth;
+    return true;
+  }
+
+  bool key(string_t &value) override {
+    if (mDepth == 1) { mKey = value; }
+    return true;
+  }
+
+  bool parse_error(
+    std::size_t /* position */,
+    const std::string & /* token */,
+    const nlohmann::detail::exception & /* ex */
+  ) override {
+    return false;
+  }
+
+  [[nodiscard]] bool hasSubscription() const { return mHasSubscription; }
+
+private:
+
+  Record &mRecord;
+  std::string &mTopic;
+  std::string &mPayload;
+  std::string mKey;
+  size_t mDepth = 0;
+  bool mHasSubscription = false;
+};
+
+JsonReader::JsonReader(const std::string &path) :
+  mInput(path, std::ios::binary),
+  mBuffer(BufferSize) //
+{
+  mLogger = Common::Log::create("Recording::JsonReader");
+
+  if (!mInput.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->warn("Could not open '{}': {}", path, ec.message());
+    mFailed = true;
+    return;
+  }
+
+  mInput.seekg(0, std::ios::end);
+  mSize = static_cast<size_t>(mInput.tellg());
+  mInput.seekg(0);
+
+  if (!readHeader()) {
+    mLogger->warn("Could not parse '{}'", path);
+    mFailed = true;
+  }
+}
+
+const std::vector<Subscription> &JsonReader::subscriptions() const {
+  return mSubscriptions;
+}
+
+bool JsonReader::next(Record &record) {
+  if (mFailed || !mInMessages) { return false; }
+
+  skipWhitespace();
+  if (peek() == ']') {
+    get();
+    mInMessages = false;
+    return false;
+  }
+  if (!mFirstMessage && !expect(',')) {
+    mFailed = true;
+    return false;
+  }
+  mFirstMessage = false;
+
+  mSlice.clear();
+  skipWhitespace();
+  if (!readValue(&mSlice)) {
+    mLogger->warn("Truncated message at offset {}", position());
+    mFailed = true;
+    return false;
+  }
+
+  if (!parseMessage(mSlice, record, mTopic, mPayload)) {
+    mLogger->warn("Malformed message at offset {}", position());
+    mFailed = true;
+    return false;
+  }
+
+  return true;
+}
+
+size_t JsonReader::position() const { return mOffset + mBegin; }
+
+size_t JsonReader::size() const { return mSize; }
+
+bool JsonReader::failed() const { return mFailed; }
+
+bool JsonReader::parseMessage(
+  std::string_view slice,
+  Record &record,
+  std::string &topic,
+  std::string &payload
+) {
+  record = {};
+  topic.clear();
+  payload.clear();
+  Handler handler(record, topic, payload);
+  const bool parsed = nlohmann::json::sax_parse(slice, &handler);
+  if (!parsed || !handler.hasSubscription()) { return false; }
+
+  record.topic = topic;
+  record.payload = payload;
+  return true;
+}
+
+bool JsonReader::parseSubscriptions(
+  std::string_view slice,
+  std::vector<Subscription> &subscriptions
+) {
+  const auto data = nlohmann::json::parse(slice, nullptr, false);
+  if (data.is_discarded()) { return false; }
+
+  // Older recordings store empty lists as null.
+  if (!data.is_array() && !data.is_null()) { return false; }
+
+  for (const auto &sub : data) {
+    Subscription subscription;
+
+    const auto idIt = sub.find("id");
+    if (false // NOLINT
+        || idIt == std::end(sub) || !idIt->is_number_unsigned()) {
+      return false;
+    }
+    subscription.id = *idIt;
+
+    const auto filterIt = sub.find("filter");
+    if (true // NOLINT
+        && filterIt != std::end(sub) && filterIt->is_string()) {
+      subscription.filter = *filterIt;
+    }
+
+    const auto qosIt = sub.find("qos");
+    if (true // NOLINT
+        && qosIt != std::end(sub) && qosIt->is_number_unsigned()) {
+      subscription.qos = *qosIt;
+    }
+
+    subscriptions.push_back(std::move(subscription));
+  }
+
+  return true;
+}
+
+bool JsonReader::readHeader() {
+  bool hasSubscriptions = false;
+  size_t messagesOffset = 0;
+  bool hasMessages = false;
+
+  skipWhitespace();
+  if (!expect('{')) { return false; }
+
+  std::string key;
+  std::string slice;
+  skipWhitespace();
+  if (peek() == '}') { return false; }
+
+  while (true) {
+    key.clear();
+    skipWhitespace();
+    if (!readString(key)) { return false; }
+    skipWhitespace();
+    if (!expect(':')) { return false; }
+    skipWhitespace();
+
+    if (key == "subscriptions") {
+      slice.clear();
+      if (!readValue(&slice)) { return false; }
+      if (!parseSubscriptions(slice, mSubscriptions)) {
+        mLogger->warn("Key 'subscriptions' is malformed");
+        return false;
+      }
+      hasSubscriptions = true;
+    } else if (key == "messages") {
+      messagesOffset = position();
+      hasMessages = true;
+      if (hasSubscriptions) { break; }
+      if (!readValue(nullptr)) { return false; }
+    } else {
+      if (!readValue(nullptr)) { return false; }
+    }
+
+    skipWhitespace();
+    const auto separator = get();
+    if (separator == '}') { break; }
+    if (separator != ',') { return false; }
+  }
+
+  if (!hasSubscriptions) {
+    mLogger->warn("Could not find key 'subscriptions'");
+    return false;
+  }
+  if (!hasMessages) {
+    mLogger->warn("Could not find key 'messages'");
+    return false;
+  }
+
+  if (!seek(messagesOffset)) { return false; }
+
+  // Older recordings store empty lists as null.
+  if (peek() == 'n') { return readValue(nullptr); }
+  if (!expect('[')) {
+    mLogger->warn("Key 'messages' is not an array");
+    return false;
+  }
+
+  mInMessages = true;
+  return true;
+}
+
+bool JsonReader::fill() {
+  if (mBegin != mEnd) { return true; }
+  mOffset += mEnd;
+  mBegin = 0;
+  mEnd = 0;
+  mInput.read(mBuffer.data(), static_cast<std::streamsize>(mBuffer.size()));
+  mEnd = static_cast<size_t>(mInput.gcount());
+  return mEnd != 0;
+}
+
+int JsonReader::peek() {
+  if (!fill()) { return -1; }
+  return static_cast<unsigned char>(mBuffer[mBegin]);
+}
+
+int JsonReader::get() {
+  if (!fill()) { return -1; }
+  return static_cast<unsigned char>(mBuffer[mBegin++]);
+}
+
+bool JsonReader::expect(char expected) {
+  return get() == static_cast<unsigned char>(expected);
+}
+
+void JsonReader::skipWhitespace() {
+  while (true) {
+    const auto value = peek();
+    if (value != ' ' && value != '\n' && value != '\r' && value != '\t') {
+      return;
+    }
+    ++mBegin;
+  }
+}
+
+bool JsonReader::readString(std::string &out) {
+  if (!expect('"')) { return false; }
+  while (true) {
+    const auto value = get();
+    if (value == -1) { return false; }
+    if (value == '"') { return true; }
+    out.push_back(static_cast<char>(value));
+    if (value == '\\') {
+      const auto escaped = get();
+      if (escaped == -1) { return false; }
+      out.push_back(static_cast<char>(escaped));
+    }
+  }
+}
+
+bool JsonReader::readValue(std::string *out) {
+  size_t depth = 0;
+  bool inString = false;
+  bool escaped = false;
+
+  while (true) {
+    if (!fill()) { return false; }
+
+    // Scan whatever is buffered in one go, then copy it out at once.
+    const size_t start = mBegin;
+    bool done = false;
+    for (; mBegin != mEnd && !done; ++mBegin) {
+      const char value = mBuffer[mBegin];
+      if (inString) {
+        if (escaped) {
+          escaped = false;
+        } else if (value == '\\') {
+          escaped = true;
+        } else if (value == '"') {
+          inString = false;
+          done = depth == 0;
+        }
+        continue;
+      }
+
+      switch (value) {
+        case '"': {
+          inString = true;
+        } break;
+        case '{':
+        case '[': {
+          ++depth;
+        } break;
+        case '}':
+        case ']':
+        case ',': {
+          if (depth == 0) {
+            // End of a scalar, leave the separator for the caller.
+            if (out != nullptr) {
+              out->append(&mBuffer[start], mBegin - start);
+            }
+            return true;
+          }
+          if (value != ',') {
+            --depth;
+            done = depth == 0;
+          }
+        } break;
+        default: break;
+      }
+    }
+
+    if (out != nullptr) { out->append(&mBuffer[start], mBegin - start); }
+    if (done) { return true; }
+    if (depth == 0 && !inString && peek() == -1) {
+      // Scalar at the very end of the input.
+      return out == nullptr || !out->empty();
+    }
+  }
+}
+
+bool JsonReader::seek(size_t offset) {
+  if (offset >= mOffset && offset <= mOffset + mEnd) {
+    mBegin = offset - mOffset;
+    return true;
+  }
+
+  mInput.clear();
+  mInput.seekg(static_cast<std::streamoff>(offset));
+  if (!mInput.good()) { return false; }
+  mOffset = offset;
+  mBegin = 0;
+  mEnd = 0;
+  return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include "Recording/Reader.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// Reads one message object at a time, so memory stays flat no matter how
+// large the recording is. Older recordings store their keys sorted, with
+// "messages" before "subscriptions", in which case the messages are skipped
+// over once without being parsed to reach the subscriptions first.
+class JsonReader : public Reader
+{
+public:
+
+  explicit JsonReader(const std::string &path);
+
+  [[nodiscard]] const std::vector<Subscription> &subscriptions(
+  ) const override;
+  bool next(Record &record) override;
+  [[nodiscard]] size_t position() const override;
+  [[nodiscard]] size_t size() const override;
+  [[nodiscard]] bool failed() const override;
+
+  // Parses a single message object. The record points into topic and
+  // payload, which are reused between calls.
+  static bool parseMessage(
+    std::string_view slice,
+    Record &record,
+    std::string &topic,
+    std::string &payload
+  );
+
+  static bool parseSubscriptions(
+    std::string_view slice,
+    std::vector<Subscription> &subscriptions
+  );
+
+private:
+
+  class Handler;
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::ifstream mInput;
+  std::vector<char> mBuffer;
+  size_t mBegin = 0;
+  size_t mEnd = 0;
+  size_t mOffset = 0;
+  size_t mSize = 0;
+  std::vector<Subscription> mSubscriptions;
+  std::string mSlice;
+  std::string mTopic;
+  std::string mPayload;
+  bool mInMessages = false;
+  bool mFirstMessage = true;
+  bool mFailed = false;
+
+  bool readHeader();
+
+  bool fill();
+  int peek();
+  int get();
+  bool expect(char expected);
+  void skipWhitespace();
+  bool readString(std::string &out);
+  bool readValue(std::string *out);
+  bool seek(size_t offset);
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,286 @@
+#include "JsonView.hpp"
+
+#include "Common/Log.hpp"
+#include "Recording/JsonReader.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+
+namespace {
+
+constexpr size_t ProgressInterval = 4096;
+constexpr auto None = std::string_view::npos;
+
+size_t skipWhitespace(std::string_view data, size_t offset) {
+  while (offset < data.size()) {
+    const char value = data[offset];
+    if (value != ' ' && value != '\n' && value != '\r' && value != '\t') {
+      break;
+    }
+    ++offset;
+  }
+  return offset;
+}
+
+// Returns the offset right after the value starting at offset.
+size_t skipValue(std::string_view data, size_t offset) {
+  size_t depth = 0;
+  bool inString = false;
+  bool escaped = false;
+
+  for (; offset < data.size(); ++offset) {
+    const char value = data[offset];
+    if (inString) {
+      if (escaped) {
+        escaped = false;
+      } else if (value == '\\') {
+        escaped = true;
+      } else if (value == '"') {
+        inString = false;
+        if (depth == 0) { return offset + 1; }
+      }
+      continue;
+    }
+
+    switch (value) {
+      case '"': {
+        inString = true;
+      } break;
+      case '{':
+      case '[': {
+        ++depth;
+      } break;
+      case '}':
+      case ']':
+      case ',': {
+        if (depth == 0) { return offset; }
+        if (value != ',') {
+          --depth;
+          if (depth == 0) { return offset + 1; }
+        }
+      } break;
+      default: break;
+    }
+  }
+
+  return depth == 0 && !inString ? offset : None;
+}
+
+} // namespace
+
+JsonView::JsonView(const std::string &path, const Progress &progress) :
+  mPath(path),
+  mFile(path) //
+{
+  mLogger = Common::Log::create("Recording::JsonView");
+
+  if (mFile.failed()) {
+    mLogger->warn("Could not map '{}'", path);
+    mFailed = true;
+    return;
+  }
+
+  size_t messages = 0;
+  if (!readHeader(messages)) {
+    mLogger->warn("Could not parse '{}'", path);
+    mFailed = true;
+    return;
+  }
+
+  if (!buildIndex(messages, progress)) {
+    mFailed = true;
+    return;
+  }
+
+  mFile.adviseRandom();
+}
+
+JsonView::JsonView(const JsonView &other) :
+  View(),
+  mLogger(other.mLogger),
+  mPath(other.mPath),
+  mFile(other.mPath),
+  mSubscriptions(other.mSubscriptions),
+  mOffsets(other.mOffsets),
+  mCheckpoints(other.mCheckpoints),
+  mSize(other.mSize),
+  mFailed(other.mFailed || mFile.failed()) //
+{
+  if (!mFailed) { mFile.adviseRandom(); }
+}
+
+const std::vector<Subscription> &JsonView::subscriptions() const {
+  return mSubscriptions;
+}
+
+const std::vector<View::Checkpoint> &JsonView::checkpoints() const {
+  return mCheckpoints;
+}
+
+size_t JsonView::size() const { return mSize; }
+
+std::unique_ptr<View> JsonView::clone() const {
+  // Building the index again would take a pass over the file.
+  std::unique_ptr<JsonView> view(new JsonView(*this)); // NOLINT
+  if (view->failed()) { return nullptr; }
+  return view;
+}
+
+bool JsonView::get(size_t index, Record &record) {
+  if (index >= mSize) { return false; }
+
+  // Repeated and sequential reads continue from the previous one, anything
+  // else starts from the closest checkpoint before it.
+  if (index < mCursor || index / Stride != mCursor / Stride) {
+    mCursor = index - index % Stride;
+    mCursorOffset = mOffsets.at(index / Stride);
+  }
+  while (mCursor < index) {
+    mCursorOffset = following(mCursorOffset);
+    if (mCursorOffset == None) {
+      mCursor = mSize;
+      return false;
+    }
+    ++mCursor;
+  }
+
+  const auto data = mFile.data();
+  const auto end = skipValue(data, mCursorOffset);
+  if (end == None) { return false; }
+  const auto slice = data.substr(mCursorOffset, end - mCursorOffset);
+  if (!JsonReader::parseMessage(slice, record, mTopic, mPayload)) {
+    mLogger->warn("Malformed message {}", index);
+    return false;
+  }
+
+  return true;
+}
+
+void JsonView::scan(
+  size_t begin,
+  size_t end,
+  const TopicFilter &filter,
+  const Visitor &visitor
+) {
+  Record record;
+  for (size_t index = begin; index < end && index < mSize; ++index) {
+    if (!get(index, record)) { return; }
+    if (filter(record.topic)) { visitor(index, record); }
+  }
+}
+
+bool JsonView::failed() const { return mFailed; }
+
+bool JsonView::readHeader(size_t &messages) {
+  const auto data = mFile.data();
+  bool hasSubscriptions = false;
+  bool hasMessages = false;
+
+  size_t offset = skipWhitespace(data, 0);
+  if (offset == data.size() || data[offset] != '{') { return false; }
+  ++offset;
+
+  while (true) {
+    offset = skipWhitespace(data, offset);
+    if (offset == data.size()) { return false; }
+    if (data[offset] == '}') { break; }
+
+    const auto keyEnd = skipValue(data, offset);
+    if (keyEnd == None || data[offset] != '"') { return false; }
+    const auto key = data.substr(offset + 1, keyEnd - offset - 2);
+
+    offset = skipWhitespace(data, keyEnd);
+    if (offset == data.size() || data[offset] != ':') { return false; }
+    offset = skipWhitespace(data, offset + 1);
+
+    const auto valueEnd = skipValue(data, offset);
+    if (valueEnd == None) { return false; }
+    const auto value = data.substr(offset, valueEnd - offset);
+
+    if (key == "subscriptions") {
+      if (!JsonReader::parseSubscriptions(value, mSubscriptions)) {
+        mLogger->warn("Key 'subscriptions' is malformed");
+        return false;
+      }
+      hasSubscriptions = true;
+    } else if (key == "messages") {
+      // Older recordings store empty lists as null.
+      if (value.front() == '[') {
+        messages = offset + 1;
+      } else if (value != "null") {
+        mLogger->warn("Key 'messages' is not an array");
+        return false;
+      }
+      hasMessages = true;
+    }
+
+    offset = skipWhitespace(data, valueEnd);
+    if (offset == data.size()) { return false; }
+    if (data[offset] == ',') { ++offset; }
+  }
+
+  if (!hasSubscriptions) {
+    mLogger->warn("Could not find key 'subscriptions'");
+    return false;
+  }
+  if (!hasMessages) {
+    mLogger->warn("Could not find key 'messages'");
+    return false;
+  }
+
+  return true;
+}
+
+bool JsonView::buildIndex(size_t messages, const Progress &progress) {
+  if (messages == 0) { return true; }
+
+  const auto data = mFile.data();
+  size_t offset = skipWhitespace(data, messages);
+  if (offset < data.size() && data[offset] == ']') { return true; }
+
+  Record record;
+  while (offset < data.size()) {
+    const auto end = skipValue(data, offset);
+    if (end == None) { return false; }
+
+    if (mSize % Stride == 0) {
+      const auto slice = data.substr(offset, end - offset);
+      if (!JsonReader::parseMessage(slice, record, mTopic, mPayload)) {
+        mLogger->warn("Malformed message {}", mSize);
+        return false;
+      }
+
+      auto timestamp = record.timestamp;
+      if (!mCheckpoints.empty()) {
+        timestamp = std::max(timestamp, mCheckpoints.back().timestamp);
+      }
+      mOffsets.push_back(offset);
+      mCheckpoints.push_back({mSize, timestamp});
+    }
+    ++mSize;
+
+    if (mSize % ProgressInterval == 0 && !progress(offset, data.size())) {
+      mLogger->info("Indexing cancelled");
+      return false;
+    }
+
+    offset = skipWhitespace(data, end);
+    if (offset == data.size()) { return false; }
+    if (data[offset] == ']') { break; }
+    if (data[offset] != ',') { return false; }
+    offset = skipWhitespace(data, offset + 1);
+  }
+
+  mCursorOffset = mOffsets.empty() ? 0 : mOffsets.front();
+  mLogger->info("Indexed {} messages", mSize);
+  return true;
+}
+
+size_t JsonView::following(size_t offset) const {
+  const auto data = mFile.data();
+  const auto end = skipValue(data, offset);
+  if (end == None) { return None; }
+  const auto separator = skipWhitespace(data, end);
+  if (separator == data.size() || data[separator] != ',') { return None; }
+  return skipWhitespace(data, separator + 1);
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "Common/MappedFile.hpp"
+#include "Recording/View.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// JSON recordings have no index, so one is built on open by walking the
+// structure of the messages array. Only the offset of every Stride-th
+// message is kept, the ones in between are reached by skipping forward.
+class JsonView : public View
+{
+public:
+
+  static constexpr size_t Stride = 64;
+
+  JsonView(const std::string &path, const Progress &progress);
+
+  [[nodiscard]] const std::vector<Subscription> &subscriptions(
+  ) const override;
+  [[nodiscard]] const std::vector<Checkpoint> &checkpoints() const override;
+  [[nodiscard]] size_t size() const override;
+  [[nodiscard]] std::unique_ptr<View> clone() const override;
+  bool get(size_t index, Record &record) override;
+  void scan(
+    size_t begin,
+    size_t end,
+    const TopicFilter &filter,
+    const Visitor &visitor
+  ) override;
+
+  [[nodiscard]] bool failed() const;
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::string mPath;
+  Common::MappedFile mFile;
+  std::vector<Subscription> mSubscriptions;
+  std::vector<size_t> mOffsets;
+  std::vector<Checkpoint> mCheckpoints;
+  size_t mSize = 0;
+  size_t mCursor = 0;
+  size_t mCursorOffset = 0;
+  std::string mTopic;
+  std::string mPayload;
+  bool mFailed = false;
+
+  // Maps the file of the other view again and takes its index as is.
+  explicit JsonView(const JsonView &other);
+
+  bool readHeader(size_t &messages);
+  bool buildIndex(size_t messages, const Progress &progress);
+  [[nodiscard]] size_t following(size_t offset) const;
+};
+
+} // namespace Rapatas::Transmitron::Recording
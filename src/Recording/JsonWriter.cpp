@@ -0,0 +1,53 @@
+#include "JsonWriter.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include "Common/Helpers.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+
+JsonWriter::JsonWriter(std::string path) :
+  mFile(std::move(path)) //
+{}
+
+bool JsonWriter::begin(const std::vector<Subscription> &subscriptions) {
+  if (!mFile.open()) { return false; }
+
+  nlohmann::json subs = nlohmann::json::array();
+  for (const auto &subscription : subscriptions) {
+    subs.push_back({
+      {"id", subscription.id},
+      {"filter", subscription.filter},
+      {"qos", subscription.qos},
+    });
+  }
+
+  mFile.stream() << R"({"subscriptions":)" << subs.dump() << R"(,"messages":[)";
+  return mFile.stream().good();
+}
+
+bool JsonWriter::write(const Record &record) {
+  const nlohmann::json message{
+    {"subscription", record.subscriptionId},
+    {"topic", record.topic},
+    {"qos", record.qos},
+    {"payload", record.payload},
+    {"retained", record.retained},
+    {"timestamp", Helpers::timeToString(record.timestamp)},
+  };
+
+  if (!mFirst) { mFile.stream() << ','; }
+  mFirst = false;
+
+  // Invalid UTF-8 is replaced instead of aborting the whole recording.
+  constexpr auto Replace = nlohmann::json::error_handler_t::replace;
+  mFile.stream() << message.dump(-1, ' ', false, Replace);
+  return mFile.stream().good();
+}
+
+bool JsonWriter::end() {
+  mFile.stream() << "]}";
+  return mFile.commit();
+}
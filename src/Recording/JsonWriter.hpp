@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+#include "Recording/PartFile.hpp"
+#include "Recording/Writer.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+class JsonWriter : public Writer
+{
+public:
+
+  explicit JsonWriter(std::string path);
+
+  bool begin(const std::vector<Subscription> &subscriptions) override;
+  bool write(const Record &record) override;
+  bool end() override;
+
+private:
+
+  PartFile mFile;
+  bool mFirst = true;
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,140 @@
+#include "NdjsonReader.hpp"
+
+#include <algorithm>
+
+#include <nlohmann/json.hpp>
+
+#include "Common/Helpers.hpp"
+#include "Common/Log.hpp"
+#include "Recording/Encoding.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+
+NdjsonReader::NdjsonReader(const std::string &path) :
+  mInput(path, std::ios::binary) //
+{
+  mLogger = Common::Log::create("Recording::NdjsonReader");
+
+  if (!mInput.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->warn("Could not open '{}': {}", path, ec.message());
+    mFailed = true;
+    return;
+  }
+
+  mInput.seekg(0, std::ios::end);
+  mSize = static_cast<size_t>(mInput.tellg());
+  mInput.seekg(0);
+
+  Record record;
+  while (readLine()) {
+    if (!parse(record, true)) {
+      mLogger->warn("Malformed message at offset {}", mOffset);
+      mFailed = true;
+      return;
+    }
+  }
+
+  mInput.clear();
+  mInput.seekg(0);
+  mOffset = 0;
+}
+
+const std::vector<Subscription> &NdjsonReader::subscriptions() const {
+  return mSubscriptions;
+}
+
+bool NdjsonReader::next(Record &record) {
+  if (mFailed || !readLine()) { return false; }
+
+  if (!parse(record, false)) {
+    mLogger->warn("Malformed message at offset {}", mOffset);
+    mFailed = true;
+    return false;
+  }
+  return true;
+}
+
+size_t NdjsonReader::position() const { return mOffset; }
+
+size_t NdjsonReader::size() const { return mSize; }
+
+bool NdjsonReader::failed() const { return mFailed; }
+
+bool NdjsonReader::readLine() {
+  while (std::getline(mInput, mLine)) {
+    mOffset += mLine.size() + 1;
+    if (!mLine.empty() && mLine.back() == '\r') { mLine.pop_back(); }
+    if (!mLine.empty()) { return true; }
+  }
+  return false;
+}
+
+bool NdjsonReader::parse(Record &record, bool collect) {
+  const auto data = nlohmann::json::parse(mLine, nullptr, false);
+  if (data.is_discarded() || !data.is_object()) { return false; }
+
+  record = {};
+
+  const auto qosIt = data.find("qos");
+  if (qosIt != std::end(data) && qosIt->is_number_unsigned()) {
+    const auto qos = qosIt->get<unsigned>();
+    if (qos > static_cast<unsigned>(MQTT::QoS::ExactlyOnce)) { return false; }
+    record.qos = static_cast<MQTT::QoS>(qos);
+  }
+
+  std::string filter;
+  const auto filterIt = data.find("subscription");
+  if (filterIt != std::end(data) && filterIt->is_string()) {
+    filter = filterIt->get<std::string>();
+  }
+
+  if (collect) {
+    const auto it = mIds.find(filter);
+    if (it != std::end(mIds)) {
+      auto &subscription = mSubscriptions.at(it->second);
+      subscription.qos = std::max(subscription.qos, record.qos);
+      return true;
+    }
+    const auto id = static_cast<MQTT::Subscription::Id>(mIds.size());
+    mIds.emplace(filter, id);
+    mSubscriptions.push_back({id, filter, record.qos});
+    return true;
+  }
+  record.subscriptionId = mIds.at(filter);
+
+  const auto timeIt = data.find("time");
+  const auto topicIt = data.find("topic");
+  const auto payloadIt = data.find("payload");
+  if (false // NOLINT
+      || timeIt == std::end(data) || !timeIt->is_string()
+      || topicIt == std::end(data) || !topicIt->is_string()
+      || payloadIt == std::end(data) || !payloadIt->is_string()) {
+    return false;
+  }
+
+  const auto timestamp = Common::Helpers::isoStringToTime(*timeIt);
+  if (!timestamp.has_value()) { return false; }
+  record.timestamp = *timestamp;
+
+  auto encoding = std::optional<Encoding>(Encoding::Utf8);
+  const auto encodingIt = data.find("encoding");
+  if (encodingIt != std::end(data) && encodingIt->is_string()) {
+    encoding = toEncoding(encodingIt->get<std::string>());
+  }
+  if (!encoding.has_value()) { return false; }
+
+  const auto &payload = payloadIt->get_ref<const std::string &>();
+  if (!decode(payload, *encoding, mPayload)) { return false; }
+  mTopic = topicIt->get<std::string>();
+
+  const auto retainedIt = data.find("retained");
+  if (retainedIt != std::end(data) && retainedIt->is_boolean()) {
+    record.retained = retainedIt->get<bool>();
+  }
+
+  record.topic = mTopic;
+  record.payload = mPayload;
+  return true;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <fstream>
+#include <map>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+#include "Recording/Reader.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// Reads exports of NdjsonWriter one line at a time. Subscriptions are only
+// stored by filter, so a first pass over the file collects them.
+class NdjsonReader : public Reader
+{
+public:
+
+  explicit NdjsonReader(const std::string &path);
+
+  [[nodiscard]] const std::vector<Subscription> &subscriptions(
+  ) const override;
+  bool next(Record &record) override;
+  [[nodiscard]] size_t position() const override;
+  [[nodiscard]] size_t size() const override;
+  [[nodiscard]] bool failed() const override;
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::ifstream mInput;
+  size_t mOffset = 0;
+  size_t mSize = 0;
+  std::vector<Subscription> mSubscriptions;
+  std::map<std::string, MQTT::Subscription::Id> mIds;
+  std::string mLine;
+  std::string mTopic;
+  std::string mPayload;
+  bool mFailed = false;
+
+  bool readLine();
+  bool parse(Record &record, bool collect);
+};
+
+} // namespace Rapatas::Transmitron::Recording
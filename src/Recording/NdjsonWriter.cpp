@@ -0,0 +1,71 @@
+#include "NdjsonWriter.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include "Common/Helpers.hpp"
+#include "Payload/JsonPrinter.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+
+namespace {
+
+bool isUtf8(std::string_view data) {
+  constexpr uint8_t Ascii = 0x80;
+  for (size_t pos = 0; pos < data.size();) {
+    if (static_cast<uint8_t>(data[pos]) < Ascii) {
+      ++pos;
+      continue;
+    }
+    const auto length = Payload::sequenceLength(data, pos);
+    if (length == 0) { return false; }
+    pos += length;
+  }
+  return true;
+}
+
+} // namespace
+
+NdjsonWriter::NdjsonWriter(std::string path, Encoding encoding) :
+  mFile(std::move(path)),
+  mEncoding(encoding) //
+{}
+
+bool NdjsonWriter::begin(const std::vector<Subscription> &subscriptions) {
+  if (!mFile.open()) { return false; }
+
+  for (const auto &subscription : subscriptions) {
+    mFilters[subscription.id] = subscription.filter;
+  }
+  return true;
+}
+
+bool NdjsonWriter::write(const Record &record) {
+  // Replacing the invalid bytes would lose them.
+  const auto encoding = mEncoding == Encoding::Utf8 && !isUtf8(record.payload)
+    ? Encoding::Base64
+    : mEncoding;
+  encode(record.payload, encoding, mPayload);
+
+  const auto filter = mFilters.find(record.subscriptionId);
+  const nlohmann::ordered_json message{
+    {"time", Helpers::timeToIsoString(record.timestamp)},
+    {"subscription",
+     filter == std::end(mFilters) ? std::string() : filter->second},
+    {"topic", record.topic},
+    {"qos", record.qos},
+    {"retained", record.retained},
+    {"encoding", toString(encoding)},
+    {"payload", mPayload},
+  };
+
+  // Only topics can still have invalid UTF-8, which is replaced.
+  constexpr auto Replace = nlohmann::ordered_json::error_handler_t::replace;
+  mFile.stream() << message.dump(-1, ' ', false, Replace) << '\n';
+  return mFile.stream().good();
+}
+
+bool NdjsonWriter::end() {
+  return mFile.commit();
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <map>
+#include <string>
+
+#include "Recording/Encoding.hpp"
+#include "Recording/PartFile.hpp"
+#include "Recording/Writer.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// One JSON object per line, readable by line-oriented tools without a parser
+// for the whole file. Subscriptions are stored by filter on every line.
+// Payloads that are not UTF-8 are written as base64 when UTF-8 is asked for,
+// with the encoding on their line.
+class NdjsonWriter : public Writer
+{
+public:
+
+  NdjsonWriter(std::string path, Encoding encoding);
+
+  bool begin(const std::vector<Subscription> &subscriptions) override;
+  bool write(const Record &record) override;
+  bool end() override;
+
+private:
+
+  PartFile mFile;
+  Encoding mEncoding;
+  std::map<MQTT::Subscription::Id, std::string> mFilters;
+  std::string mPayload;
+};
+
+} // namespace Rapatas::Transmitron::Recording
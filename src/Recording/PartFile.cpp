@@ -0,0 +1,53 @@
+#include "PartFile.hpp"
+
+#include "Common/Filesystem.hpp"
+#include "Common/Log.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+
+PartFile::PartFile(std::string path) :
+  mPath(std::move(path)),
+  mPartial(mPath + ".part") //
+{
+  mLogger = Common::Log::create("Recording::PartFile");
+}
+
+PartFile::~PartFile() {
+  if (mCommitted) { return; }
+
+  mOut.close();
+  std::error_code ec;
+  fs::remove(mPartial, ec);
+}
+
+bool PartFile::open() {
+  mOut.open(mPartial, std::ios::binary | std::ios::trunc);
+  if (!mOut.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    mLogger->error("Could not open '{}': {}", mPartial, ec.message());
+    return false;
+  }
+  return true;
+}
+
+bool PartFile::commit() {
+  mOut.close();
+  if (mOut.fail()) {
+    mLogger->error("Could not write '{}'", mPartial);
+    return false;
+  }
+
+  std::error_code ec;
+  fs::rename(mPartial, mPath, ec);
+  if (ec) {
+    mLogger->error("Could not rename '{}': {}", mPartial, ec.message());
+    return false;
+  }
+
+  mCommitted = true;
+  return true;
+}
+
+std::ofstream &PartFile::stream() { return mOut; }
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+
+#include <spdlog/spdlog.h>
+
+namespace Rapatas::Transmitron::Recording {
+
+// A file written next to its path, with a ".part" suffix, and only moved
+// there once complete. Unless committed, the partial file is removed, so an
+// unfinished or cancelled write never leaves a truncated file behind.
+class PartFile
+{
+public:
+
+  explicit PartFile(std::string path);
+  PartFile(const PartFile &other) = delete;
+  PartFile(PartFile &&other) = delete;
+  PartFile &operator=(const PartFile &other) = delete;
+  PartFile &operator=(PartFile &&other) = delete;
+  ~PartFile();
+
+  // Creates the partial file, replacing any left from before.
+  bool open();
+  // Closes the partial file and moves it to the path.
+  bool commit();
+
+  [[nodiscard]] std::ofstream &stream();
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::string mPath;
+  std::string mPartial;
+  std::ofstream mOut;
+  bool mCommitted = false;
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,62 @@
+#include "Reader.hpp"
+
+#include <array>
+#include <fstream>
+
+#include "Common/Filesystem.hpp"
+#include "Common/Log.hpp"
+#include "Recording/Binary.hpp"
+#include "Recording/BinaryReader.hpp"
+#include "Recording/CsvReader.hpp"
+#include "Recording/Journal.hpp"
+#include "Recording/JournalReader.hpp"
+#include "Recording/JsonReader.hpp"
+#include "Recording/NdjsonReader.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+
+std::unique_ptr<Reader> Reader::open(const std::string &path) {
+  auto logger = Common::Log::create("Recording::Reader");
+
+  if (path.empty()) {
+    logger->error("No file provided");
+    return nullptr;
+  }
+
+  if (!fs::exists(path)) {
+    logger->warn("File does not exist: {}", path);
+    return nullptr;
+  }
+
+  std::ifstream input(path, std::ios::binary);
+  if (!input.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    logger->warn("Could not open '{}': {}", path, ec.message());
+    return nullptr;
+  }
+
+  std::array<char, Binary::Magic.size()> magic{};
+  input.read(magic.data(), magic.size());
+  input.close();
+
+  // Exports carry no magic, they are told apart by their extension.
+  const auto extension = fs::path(path).extension();
+
+  std::unique_ptr<Reader> result;
+  if (magic == Binary::Magic) {
+    result = std::make_unique<BinaryReader>(path);
+  } else if (magic == Journal::Magic) {
+    result = std::make_unique<JournalReader>(path);
+  } else if (extension == ".ndjson" || extension == ".jsonl") {
+    result = std::make_unique<NdjsonReader>(path);
+  } else if (extension == ".csv") {
+    result = std::make_unique<CsvReader>(path);
+  } else {
+    result = std::make_unique<JsonReader>(path);
+  }
+
+  if (result->failed()) { return nullptr; }
+  return result;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Recording/Record.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+class Reader
+{
+public:
+
+  Reader() = default;
+  virtual ~Reader() = default;
+  Reader(const Reader &other) = delete;
+  Reader(Reader &&other) = delete;
+  Reader &operator=(const Reader &other) = delete;
+  Reader &operator=(Reader &&other) = delete;
+
+  // Detects the format of the file and returns nullptr if it cannot be read.
+  static std::unique_ptr<Reader> open(const std::string &path);
+
+  [[nodiscard]] virtual const std::vector<Subscription> &subscriptions(
+  ) const = 0;
+
+  // Returns false at the end of the recording or on failure. The record
+  // views stay valid until the next call.
+  virtual bool next(Record &record) = 0;
+
+  [[nodiscard]] virtual size_t position() const = 0;
+  [[nodiscard]] virtual size_t size() const = 0;
+  [[nodiscard]] virtual bool failed() const = 0;
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+#include "MQTT/QualityOfService.hpp"
+#include "MQTT/Subscription.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+struct Subscription {
+  MQTT::Subscription::Id id{};
+  std::string filter;
+  MQTT::QoS qos = MQTT::QoS::AtLeastOnce;
+};
+
+// Views into storage owned by whoever produced the record. They stay valid
+// until the producer moves on to the next record.
+struct Record {
+  MQTT::Subscription::Id subscriptionId{};
+  std::string_view topic;
+  std::string_view payload;
+  MQTT::QoS qos = MQTT::QoS::AtLeastOnce;
+  bool retained = false;
+  std::chrono::system_clock::time_point timestamp;
+};
+
+} // namespace Rapatas::Transmitron::Recording
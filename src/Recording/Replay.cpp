@@ -0,0 +1,165 @@
+#include "Replay.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#include "Common/Log.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace std::chrono;
+
+// Sleep until this close to a deadline, then yield until it passes.
+constexpr auto SpinThreshold = microseconds(1000);
+constexpr auto CancelCheckInterval = milliseconds(50);
+constexpr auto WindowPollInterval = microseconds(100);
+constexpr size_t ProgressInterval = 256;
+
+Replay::Replay(std::shared_ptr<MQTT::Client> client, Options options) :
+  mClient(std::move(client)),
+  mOptions(std::move(options)) //
+{
+  mLogger = Common::Log::create("Recording::Replay");
+  mOptions.speed = std::clamp(mOptions.speed, MinSpeed, MaxSpeed);
+  mOptions.window = std::max<size_t>(mOptions.window, 1);
+  if (mOptions.timing == Timing::Original) { mOptions.speed = 1.0; }
+}
+
+bool Replay::run(
+  Reader &reader,
+  const std::atomic<bool> &cancelled,
+  const Progress &progress
+) {
+  mStats = {};
+
+  const auto start = steady_clock::now();
+  system_clock::time_point first;
+  bool started = false;
+
+  Record record;
+  MQTT::Message message;
+  while (reader.next(record)) {
+    if (cancelled) {
+      mLogger->info("Replay cancelled");
+      return false;
+    }
+
+    const auto &subscriptions = mOptions.subscriptions;
+    if (true // NOLINT
+        && !subscriptions.empty()
+        && subscriptions.count(record.subscriptionId) == 0) {
+      ++mStats.skipped;
+      continue;
+    }
+
+    if (!started) {
+      first = record.timestamp;
+      started = true;
+    }
+
+    if (mOptions.timing != Timing::MaxSpeed) {
+      const auto elapsed = duration<double>(record.timestamp - first);
+      const auto offset = duration_cast<steady_clock::duration>(
+        elapsed / mOptions.speed
+      );
+      const auto target = start + offset;
+      if (!waitUntil(target, cancelled)) { return false; }
+
+      const auto lag = duration_cast<nanoseconds>(steady_clock::now() - target);
+      mStats.maxLag = std::max(mStats.maxLag, lag);
+      mStats.totalLag += lag;
+    }
+
+    if (!waitForWindow(cancelled)) { return false; }
+
+    message.topic = remap(record.topic, mOptions.remaps);
+    message.payload = record.payload;
+    message.qos = record.qos;
+    message.retained = record.retained;
+    message.timestamp = record.timestamp;
+    if (!mClient->publish(message)) {
+      mLogger->warn(
+        "Replay stopped, could not publish after {} messages",
+        mStats.published
+      );
+      return false;
+    }
+    ++mStats.published;
+
+    if (mStats.published % ProgressInterval == 0) {
+      progress(reader.position(), reader.size());
+    }
+  }
+
+  if (reader.failed()) {
+    mLogger->warn("Replay stopped, could not read the recording");
+    return false;
+  }
+
+  const auto average = mStats.published == 0
+    ? nanoseconds(0)
+    : mStats.totalLag / static_cast<int64_t>(mStats.published);
+  mLogger->info(
+    "Replayed {} messages, skipped {}, lag average {}us max {}us",
+    mStats.published,
+    mStats.skipped,
+    duration_cast<microseconds>(average).count(),
+    duration_cast<microseconds>(mStats.maxLag).count()
+  );
+  return true;
+}
+
+const Replay::Stats &Replay::stats() const { return mStats; }
+
+std::string Replay::remap(
+  std::string_view topic,
+  const std::vector<Remap> &remaps
+) {
+  for (const auto &[from, to] : remaps) {
+    if (topic.substr(0, from.size()) == from) {
+      std::string result = to;
+      result.append(topic.substr(from.size()));
+      return result;
+    }
+  }
+  return std::string(topic);
+}
+
+bool Replay::waitUntil(
+  steady_clock::time_point target,
+  const std::atomic<bool> &cancelled
+) const {
+  while (true) {
+    const auto now = steady_clock::now();
+    if (now >= target) { return true; }
+    if (cancelled) { return false; }
+
+    const auto remaining = target - now;
+    if (remaining > SpinThreshold) {
+      const auto nap = std::min<steady_clock::duration>(
+        remaining - SpinThreshold,
+        CancelCheckInterval
+      );
+      std::this_thread::sleep_for(nap);
+    } else {
+      std::this_thread::yield();
+    }
+  }
+}
+
+bool Replay::waitForWindow(const std::atomic<bool> &cancelled) const {
+  while (mClient->inFlight() >= mOptions.window) {
+    if (cancelled) { return false; }
+    if (!mClient->connected()) {
+      mLogger->warn("Replay stopped, connection lost");
+      return false;
+    }
+    std::this_thread::sleep_for(WindowPollInterval);
+  }
+
+  if (!mClient->connected()) {
+    mLogger->warn("Replay stopped, connection lost");
+    return false;
+  }
+  return true;
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "MQTT/Client.hpp"
+#include "Recording/Reader.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// Publishes the messages of a recording to a broker as they are read from
+// disk. Each message is scheduled against the start of the replay instead
+// of the previous message, so sleep inaccuracies never add up.
+class Replay
+{
+public:
+
+  enum class Timing : uint8_t {
+    Original,
+    Scaled,
+    MaxSpeed,
+  };
+
+  static constexpr double MinSpeed = 0.1;
+  static constexpr double MaxSpeed = 100.0;
+  static constexpr size_t DefaultWindow = 64;
+
+  // Topics starting with from get that prefix replaced by to. The first
+  // matching rule wins.
+  struct Remap {
+    std::string from;
+    std::string to;
+  };
+
+  struct Options {
+    Timing timing = Timing::Original;
+    double speed = 1.0;
+    size_t window = DefaultWindow;
+    std::vector<Remap> remaps;
+    // Subscriptions of the recording to replay, all of them when empty.
+    std::set<MQTT::Subscription::Id> subscriptions;
+  };
+
+  struct Stats {
+    size_t published = 0;
+    size_t skipped = 0;
+    std::chrono::nanoseconds maxLag{};
+    std::chrono::nanoseconds totalLag{};
+  };
+
+  using Progress = std::function<void(size_t done, size_t total)>;
+
+  Replay(std::shared_ptr<MQTT::Client> client, Options options);
+
+  // Blocks until the recording is replayed, cancelled or the connection is
+  // lost. Meant to run on a worker thread.
+  bool run(
+    Reader &reader,
+    const std::atomic<bool> &cancelled,
+    const Progress &progress
+  );
+
+  [[nodiscard]] const Stats &stats() const;
+
+  static std::string remap(
+    std::string_view topic,
+    const std::vector<Remap> &remaps
+  );
+
+private:
+
+  std::shared_ptr<spdlog::logger> mLogger;
+  std::shared_ptr<MQTT::Client> mClient;
+  Options mOptions;
+  Stats mStats;
+
+  bool waitUntil(
+    std::chrono::steady_clock::time_point target,
+    const std::atomic<bool> &cancelled
+  ) const;
+  bool waitForWindow(const std::atomic<bool> &cancelled) const;
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,354 @@
+#include "Tools.hpp"
+
+#include <algorithm>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <queue>
+#include <unordered_map>
+#include <unordered_set>
+
+#include <fmt/format.h>
+
+#include "Common/Filesystem.hpp"
+#include "Common/Helpers.hpp"
+#include "Common/Log.hpp"
+#include "MQTT/Client.hpp"
+#include "Recording/Reader.hpp"
+#include "Recording/Writer.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+using std::chrono::system_clock;
+
+namespace {
+
+using Sink = std::function<bool(const Record &record)>;
+
+struct Source {
+  std::string path;
+  std::unique_ptr<Reader> reader;
+  Record record;
+  // Never goes backwards, so that a clock jump in the recording cannot end
+  // a time range early or break the merge order.
+  system_clock::time_point clamped = system_clock::time_point::min();
+  std::unordered_map<MQTT::Subscription::Id, MQTT::Subscription::Id> ids;
+};
+
+class Filter
+{
+public:
+
+  explicit Filter(const Tools::Criteria &criteria) :
+    mCriteria(criteria) //
+  {}
+
+  [[nodiscard]] bool topic(std::string_view topic) {
+    if (mCriteria.topic.empty()) { return true; }
+
+    // Matching is done once per distinct topic.
+    const auto it = mMatches.find(topic);
+    if (it != std::end(mMatches)) { return it->second; }
+
+    const auto &key = mTopics.emplace_back(topic);
+    const bool result = MQTT::Client::match(mCriteria.topic, key);
+    mMatches.emplace(key, result);
+    return result;
+  }
+
+  [[nodiscard]] bool subscription(const std::string &filter) const {
+    const auto &subscriptions = mCriteria.subscriptions;
+    if (subscriptions.empty()) { return true; }
+    return std::find(
+             std::begin(subscriptions),
+             std::end(subscriptions),
+             filter
+           )
+      != std::end(subscriptions);
+  }
+
+private:
+
+  const Tools::Criteria &mCriteria;
+  // Keyed by views into mTopics, so that looking a topic up copies nothing.
+  std::deque<std::string> mTopics;
+  std::unordered_map<std::string_view, bool> mMatches;
+};
+
+// Moves the source to its next matching message. Returns false once the
+// source is exhausted or past the end of the time range.
+bool advance(
+  Source &source,
+  Filter &filter,
+  const Tools::Criteria &criteria,
+  Tools::Stats &stats
+) {
+  while (source.reader->next(source.record)) {
+    source.clamped = std::max(source.clamped, source.record.timestamp);
+    if (source.clamped > criteria.to) { return false; }
+
+    const auto id = source.ids.find(source.record.subscriptionId);
+    if (false // NOLINT
+        || source.clamped < criteria.from
+        || id == std::end(source.ids)
+        || !filter.topic(source.record.topic)) {
+      ++stats.skipped;
+      continue;
+    }
+
+    source.record.subscriptionId = id->second;
+    return true;
+  }
+  return false;
+}
+
+bool stream(
+  const std::vector<std::string> &inputs,
+  const Tools::Criteria &criteria,
+  Tools::Stats &stats,
+  const std::function<bool(const std::vector<Subscription> &)> &begin,
+  const Sink &sink
+) {
+  auto logger = Common::Log::create("Recording::Tools");
+  stats = {};
+  Filter filter(criteria);
+
+  std::vector<Source> sources;
+  sources.reserve(inputs.size());
+  for (const auto &path : inputs) {
+    auto reader = Reader::open(path);
+    if (reader == nullptr) {
+      logger->error("Could not open '{}'", path);
+      return false;
+    }
+
+    Source source;
+    source.path = path;
+    source.reader = std::move(reader);
+
+    for (const auto &subscription : source.reader->subscriptions()) {
+      if (!filter.subscription(subscription.filter)) { continue; }
+
+      auto &merged = stats.subscriptions;
+      const auto it = std::find_if(
+        std::begin(merged),
+        std::end(merged),
+        [&subscription](const Subscription &other) {
+          return other.filter == subscription.filter
+            && other.qos == subscription.qos;
+        }
+      );
+      if (it != std::end(merged)) {
+        source.ids[subscription.id] = it->id;
+        continue;
+      }
+
+      const auto id = static_cast<MQTT::Subscription::Id>(merged.size());
+      merged.push_back({id, subscription.filter, subscription.qos});
+      source.ids[subscription.id] = id;
+    }
+
+    sources.push_back(std::move(source));
+  }
+
+  if (!begin(stats.subscriptions)) { return false; }
+
+  // K-way merge, ties keep the order of the inputs.
+  const auto later = [&sources](size_t lhs, size_t rhs) {
+    const auto &left = sources[lhs].clamped;
+    const auto &right = sources[rhs].clamped;
+    return left != right ? left > right : lhs > rhs;
+  };
+  std::priority_queue<size_t, std::vector<size_t>, decltype(later)> pending(
+    later
+  );
+  for (size_t i = 0; i != sources.size(); ++i) {
+    if (advance(sources[i], filter, criteria, stats)) { pending.push(i); }
+  }
+
+  std::deque<std::string> topicNames;
+  std::unordered_set<std::string_view> topics;
+  while (!pending.empty()) {
+    const auto current = pending.top();
+    pending.pop();
+    auto &source = sources[current];
+    const auto &record = source.record;
+
+    if (!sink(record)) { return false; }
+
+    if (stats.messages == 0) { stats.first = record.timestamp; }
+    stats.last = record.timestamp;
+    ++stats.messages;
+    ++stats.perSubscription[record.subscriptionId];
+    if (record.retained) { ++stats.retained; }
+    stats.payloadBytes += record.payload.size();
+    stats.largestPayload = std::max(
+      stats.largestPayload,
+      record.payload.size()
+    );
+    if (topics.count(record.topic) == 0) {
+      topics.emplace(topicNames.emplace_back(record.topic));
+    }
+
+    if (advance(source, filter, criteria, stats)) { pending.push(current); }
+  }
+  stats.topics = topics.size();
+
+  for (const auto &source : sources) {
+    if (source.reader->failed()) {
+      logger->error("Could not read '{}'", source.path);
+      return false;
+    }
+  }
+
+  return true;
+}
+
+std::optional<system_clock::time_point> parseTime(
+  const std::string &text,
+  const std::string &reference
+) {
+  // Times without a date refer to the day the recording starts.
+  system_clock::time_point day = system_clock::now();
+  auto reader = Reader::open(reference);
+  Record first;
+  if (reader != nullptr && reader->next(first)) { day = first.timestamp; }
+  return Helpers::localTimeFromString(text, day);
+}
+
+void print(const Tools::Stats &stats) {
+  fmt::print("Messages:        {}\n", stats.messages);
+  fmt::print("Skipped:         {}\n", stats.skipped);
+  fmt::print("Retained:        {}\n", stats.retained);
+  fmt::print("Topics:          {}\n", stats.topics);
+  fmt::print("Payload bytes:   {}\n", stats.payloadBytes);
+  fmt::print("Largest payload: {}\n", stats.largestPayload);
+  if (stats.messages != 0) {
+    const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(
+      stats.last - stats.first
+    );
+    fmt::print("First:           {}\n", Helpers::timeToString(stats.first));
+    fmt::print("Last:            {}\n", Helpers::timeToString(stats.last));
+    fmt::print("Duration:        {}\n", Helpers::durationToString(duration));
+  }
+  fmt::print("Subscriptions:\n");
+  for (const auto &subscription : stats.subscriptions) {
+    const auto it = stats.perSubscription.find(subscription.id);
+    const auto count = it == std::end(stats.perSubscription) ? 0 : it->second;
+    fmt::print(
+      "  {} (qos {}): {}\n",
+      subscription.filter,
+      static_cast<int>(subscription.qos),
+      count
+    );
+  }
+}
+
+} // namespace
+
+bool Tools::run(const Command &command) {
+  if (command.inputs.empty()) {
+    fmt::print(stderr, "No recording provided\n");
+    return false;
+  }
+
+  Criteria criteria;
+  criteria.topic = command.topic;
+  criteria.subscriptions = command.subscriptions;
+
+  const auto encoding = toEncoding(command.encoding);
+  if (!encoding.has_value()) {
+    fmt::print(stderr, "Invalid encoding: '{}'\n", command.encoding);
+    return false;
+  }
+  criteria.encoding = *encoding;
+
+  const auto &reference = command.inputs.front();
+  if (!command.from.empty()) {
+    const auto from = parseTime(command.from, reference);
+    if (!from.has_value()) {
+      fmt::print(stderr, "Invalid time: '{}'\n", command.from);
+      return false;
+    }
+    criteria.from = *from;
+  }
+  if (!command.to.empty()) {
+    const auto to = parseTime(command.to, reference);
+    if (!to.has_value()) {
+      fmt::print(stderr, "Invalid time: '{}'\n", command.to);
+      return false;
+    }
+    criteria.to = *to;
+  }
+  if (criteria.from > criteria.to) {
+    fmt::print(stderr, "The time range ends before it starts\n");
+    return false;
+  }
+
+  Stats result;
+  if (command.name == "stats") {
+    if (!stats(command.inputs, criteria, result)) {
+      fmt::print(stderr, "Could not read the recordings\n");
+      return false;
+    }
+    print(result);
+    return true;
+  }
+
+  for (const auto &input : command.inputs) {
+    std::error_code ec;
+    if (fs::equivalent(input, command.output, ec)) {
+      fmt::print(stderr, "Cannot overwrite input '{}'\n", input);
+      return false;
+    }
+  }
+
+  if (!copy(command.inputs, command.output, criteria, result)) {
+    fmt::print(stderr, "Could not write '{}'\n", command.output);
+    return false;
+  }
+
+  fmt::print(
+    "Wrote {} messages to '{}', skipped {}\n",
+    result.messages,
+    command.output,
+    result.skipped
+  );
+  return true;
+}
+
+bool Tools::copy(
+  const std::vector<std::string> &inputs,
+  const std::string &output,
+  const Criteria &criteria,
+  Stats &stats
+) {
+  auto writer = Writer::create(output, criteria.encoding);
+
+  const bool streamed = stream(
+    inputs,
+    criteria,
+    stats,
+    [&writer](const std::vector<Subscription> &subscriptions) {
+      return writer->begin(subscriptions);
+    },
+    [&writer](const Record &record) { return writer->write(record); }
+  );
+  return streamed && writer->end();
+}
+
+bool Tools::stats(
+  const std::vector<std::string> &inputs,
+  const Criteria &criteria,
+  Stats &stats
+) {
+  return stream(
+    inputs,
+    criteria,
+    stats,
+    [](const std::vector<Subscription> & /* subscriptions */) { return true; },
+    [](const Record & /* record */) { return true; }
+  );
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "Recording/Encoding.hpp"
+#include "Recording/Record.hpp"
+
+namespace Rapatas::Transmitron::Recording::Tools {
+
+// Command line request, times and filters are kept as typed by the user.
+struct Command {
+  std::string name;
+  std::vector<std::string> inputs;
+  std::string output;
+  std::string from;
+  std::string to;
+  std::string topic;
+  std::vector<std::string> subscriptions;
+  std::string encoding;
+};
+
+struct Criteria {
+  std::chrono::system_clock::time_point from =
+    std::chrono::system_clock::time_point::min();
+  std::chrono::system_clock::time_point to =
+    std::chrono::system_clock::time_point::max();
+  // MQTT topic filter, all topics when empty.
+  std::string topic;
+  // Filters of the recorded subscriptions to keep, all of them when empty.
+  std::vector<std::string> subscriptions;
+  // Payload encoding of NDJSON and CSV outputs.
+  Encoding encoding = Encoding::Utf8;
+};
+
+struct Stats {
+  size_t messages = 0;
+  size_t skipped = 0;
+  size_t retained = 0;
+  size_t payloadBytes = 0;
+  size_t largestPayload = 0;
+  size_t topics = 0;
+  std::chrono::system_clock::time_point first;
+  std::chrono::system_clock::time_point last;
+  std::vector<Subscription> subscriptions;
+  std::map<MQTT::Subscription::Id, size_t> perSubscription;
+};
+
+// Runs a slice, filter, merge or stats command and prints its outcome.
+bool run(const Command &command);
+
+// Streams the inputs merged by timestamp into the output, keeping only the
+// messages that match. One message per input is held at a time, so memory
+// only grows with the number of distinct topics. Subscriptions with the
+// same filter and QoS are merged, others are renumbered.
+bool copy(
+  const std::vector<std::string> &inputs,
+  const std::string &output,
+  const Criteria &criteria,
+  Stats &stats
+);
+
+// Same as copy without writing anything.
+bool stats(
+  const std::vector<std::string> &inputs,
+  const Criteria &criteria,
+  Stats &stats
+);
+
+} // namespace Rapatas::Transmitron::Recording::Tools
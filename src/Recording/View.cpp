@@ -0,0 +1,63 @@
+#include "View.hpp"
+
+#include <array>
+#include <fstream>
+
+#include "Common/Filesystem.hpp"
+#include "Common/Log.hpp"
+#include "Recording/Binary.hpp"
+#include "Recording/BinaryView.hpp"
+#include "Recording/Journal.hpp"
+#include "Recording/JsonView.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+
+std::unique_ptr<View> View::open(
+  const std::string &path,
+  const Progress &progress
+) {
+  auto logger = Common::Log::create("Recording::View");
+
+  if (!fs::exists(path)) {
+    logger->warn("File does not exist: {}", path);
+    return nullptr;
+  }
+
+  std::ifstream input(path, std::ios::binary);
+  if (!input.is_open()) {
+    const auto ec = std::error_code(errno, std::system_category());
+    logger->warn("Could not open '{}': {}", path, ec.message());
+    return nullptr;
+  }
+
+  std::array<char, Binary::Magic.size()> magic{};
+  input.read(magic.data(), magic.size());
+  input.close();
+
+  // Exports and journals have no index to seek by, they can only be loaded.
+  const auto extension = fs::path(path).extension();
+  if (false // NOLINT
+      || magic == Journal::Magic
+      || extension == ".ndjson"
+      || extension == ".jsonl"
+      || extension == ".csv") {
+    logger->warn("Cannot view '{}' in place, open it instead", path);
+    return nullptr;
+  }
+
+  std::unique_ptr<View> result;
+  if (magic == Binary::Magic) {
+    auto view = std::make_unique<BinaryView>(path);
+    if (view->failed()) { return nullptr; }
+    result = std::move(view);
+  } else {
+    auto view = std::make_unique<JsonView>(path, progress);
+    if (view->failed()) { return nullptr; }
+    result = std::move(view);
+  }
+
+  logger->info("Opened '{}' as a view of {} messages", path, result->size());
+  return result;
+}
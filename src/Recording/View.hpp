@@ -0,0 +1,70 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Recording/Record.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+// Random access into a recording without loading it. Messages are decoded
+// from a memory mapping of the file on request, so memory use stays flat no
+// matter how large the recording is.
+class View
+{
+public:
+
+  using Timestamp = std::chrono::system_clock::time_point;
+  using Progress = std::function<bool(size_t done, size_t total)>;
+  using TopicFilter = std::function<bool(std::string_view topic)>;
+  using Visitor = std::function<void(size_t index, const Record &record)>;
+
+  // Sparse index into the recording, ordered by index, with timestamps
+  // clamped so that they never go backwards.
+  struct Checkpoint {
+    size_t index = 0;
+    Timestamp timestamp;
+  };
+
+  View() = default;
+  virtual ~View() = default;
+  View(const View &other) = delete;
+  View(View &&other) = delete;
+  View &operator=(const View &other) = delete;
+  View &operator=(View &&other) = delete;
+
+  // Detects the format of the file and builds or reads its index. Returns
+  // nullptr on failure or when progress returns false.
+  static std::unique_ptr<View> open(
+    const std::string &path,
+    const Progress &progress
+  );
+
+  [[nodiscard]] virtual const std::vector<Subscription> &subscriptions(
+  ) const = 0;
+  [[nodiscard]] virtual const std::vector<Checkpoint> &checkpoints() const = 0;
+  [[nodiscard]] virtual size_t size() const = 0;
+
+  // Another view of the same recording that shares nothing with this one,
+  // so that another thread can read it meanwhile. Returns nullptr if the
+  // file cannot be mapped again.
+  [[nodiscard]] virtual std::unique_ptr<View> clone() const = 0;
+
+  // The record views stay valid until the next call.
+  virtual bool get(size_t index, Record &record) = 0;
+
+  // Visits the records in [begin, end) whose topic passes the filter, in
+  // order. Formats that know which topics a range holds skip it entirely.
+  virtual void scan(
+    size_t begin,
+    size_t end,
+    const TopicFilter &filter,
+    const Visitor &visitor
+  ) = 0;
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -0,0 +1,33 @@
+#include "Writer.hpp"
+
+#include "Common/Filesystem.hpp"
+#include "Recording/BinaryWriter.hpp"
+#include "Recording/CsvWriter.hpp"
+#include "Recording/JsonWriter.hpp"
+#include "Recording/NdjsonWriter.hpp"
+
+using namespace Rapatas::Transmitron;
+using namespace Recording;
+using namespace Common;
+
+std::unique_ptr<Writer> Writer::create(
+  const std::string &path,
+  Encoding encoding
+) {
+  return create(path, fs::path(path).extension().string(), encoding);
+}
+
+std::unique_ptr<Writer> Writer::create(
+  const std::string &path,
+  std::string_view format,
+  Encoding encoding
+) {
+  if (format == ".json") { return std::make_unique<JsonWriter>(path); }
+  if (format == ".ndjson" || format == ".jsonl") {
+    return std::make_unique<NdjsonWriter>(path, encoding);
+  }
+  if (format == ".csv") {
+    return std::make_unique<CsvWriter>(path, encoding);
+  }
+  return std::make_unique<BinaryWriter>(path);
+}
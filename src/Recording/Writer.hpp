@@ -0,0 +1,43 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Recording/Encoding.hpp"
+#include "Recording/Record.hpp"
+
+namespace Rapatas::Transmitron::Recording {
+
+class Writer
+{
+public:
+
+  Writer() = default;
+  virtual ~Writer() = default;
+  Writer(const Writer &other) = delete;
+  Writer(Writer &&other) = delete;
+  Writer &operator=(const Writer &other) = delete;
+  Writer &operator=(Writer &&other) = delete;
+
+  // Picks the format from the extension of the path. The encoding only
+  // applies to the text formats that cannot hold binary payloads.
+  static std::unique_ptr<Writer> create(
+    const std::string &path,
+    Encoding encoding = Encoding::Utf8
+  );
+
+  // Same, with the format given as an extension like ".csv".
+  static std::unique_ptr<Writer> create(
+    const std::string &path,
+    std::string_view format,
+    Encoding encoding = Encoding::Utf8
+  );
+
+  virtual bool begin(const std::vector<Subscription> &subscriptions) = 0;
+  virtual bool write(const Record &record) = 0;
+  virtual bool end() = 0;
+};
+
+} // namespace Rapatas::Transmitron::Recording
@@ -2,7 +2,10 @@
 #include <wx/init.h>
 
 #include "Arguments.hpp"
+#include "Common/Console.hpp"
+#include "Common/Log.hpp"
 #include "GUI/App.hpp"
+#include "Recording/Tools.hpp"
 
 using namespace Rapatas::Transmitron;
 
@@ -11,6 +14,17 @@ int main(int argc, char **argv) {
     const auto args = Arguments::handleArgs(argc, argv);
     if (args.exit) { return 0; }
 
+    if (!args.tool.name.empty()) {
+#ifdef _WIN32
+      // Release builds have no console of their own to print to.
+      constexpr int16_t ConsoleLength = 1024;
+      Common::Console::attachToParent(ConsoleLength);
+#endif // _WIN32
+      Common::Log::instance().initialize(args.verbose);
+      const bool succeeded = Recording::Tools::run(args.tool);
+      return succeeded ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
     auto *app = new GUI::App(args.verbose);
     wxApp::SetInstance(app);
     wxEntryStart(argc, argv);
@@ -19,7 +33,7 @@ int main(int argc, char **argv) {
     if (!args.profileName.empty()) {
       app->openProfile(args.profileName);
     } else if (!args.recordingFile.empty()) {
-      app->openRecording(args.recordingFile);
+      app->openRecording(args.recordingFile, args.recordingView);
     }
 
     app->OnRun();